@@ -165,6 +165,7 @@ namespace mu2e {
     std::array<float,StrawId::_nupanels>                  _phiPanel;
 
     std::vector<ComboHit>                                 _chHitsToProcess;
+    std::vector<HitInfo_t>                                _chHitsInfo;   // (face,panel,index) of each hit in _chHitsToProcess
     std::array<int,kNMaxChHits>                           _hitsUsed;
 
     //    std::array<int,StrawId::_nupanels*PanelZ_t::kNMaxPanelHits>  _hitsUsed;
@@ -190,6 +191,11 @@ namespace mu2e {
     int           nGoodHits         () { return _goodhits.size(); }
 
     void          orderID           (ChannelID* X, ChannelID* O);
+//-----------------------------------------------------------------------------
+// hits are stored face-ordered, so all the hits downstream of the seed are
+// the contiguous range [firstHitIndex(Seed), _chHitsToProcess.size())
+//-----------------------------------------------------------------------------
+    int           firstHitIndex     (const HitInfo_t& Seed);
 
     void          print(const char* Title);
     void          clearTimeClusterInfo();
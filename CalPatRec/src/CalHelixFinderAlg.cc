@@ -73,10 +73,6 @@ namespace mu2e {
   };
 
   // comparison functor for sorting byuniquePanel ID
-  struct panelcomp : public std::binary_function<mu2e::ComboHit,mu2e::ComboHit,bool> {
-    bool operator()(mu2e::ComboHit const& p1, mu2e::ComboHit const& p2) { return p1.strawId().uniquePanel() < p2.strawId().uniquePanel(); }
-  };
-
 //-----------------------------------------------------------------------------
   void CalHelixFinderAlg::defineHelixParams(CalHelixFinderData& Helix) const {
 
@@ -1623,9 +1619,14 @@ namespace mu2e {
 	ordChCol.push_back(ComboHit(ch));
       }
     }
-    std::sort(ordChCol.begin(), ordChCol.end(),panelcomp());
+//-----------------------------------------------------------------------------
+// order the hits by Z-ordered face and panel, so each face and each panel
+// occupy a contiguous range of Helix._chHitsToProcess
+//-----------------------------------------------------------------------------
+    int                nOrdCh = ordChCol.size();
+    std::vector<int>   ordKey(nOrdCh), ordIndex(nOrdCh);
 
-    for (unsigned i=0; i<ordChCol.size(); ++i) {
+    for (int i=0; i<nOrdCh; ++i) {
       ComboHit& ch = ordChCol[i];
 
       cx.Station                 = ch.strawId().station();//straw.id().getStation();
@@ -1635,15 +1636,19 @@ namespace mu2e {
 
       // get Z-ordered location
       Helix.orderID(&cx, &co);
-     
-      int os       = co.Station; 
-      int of       = co.Face;
-      //FIXME!!! COMPARE OF WITH ch.sid().uniqueFace()
-      int op       = co.Panel;
-
-      int       stationId = os;
-      int       faceId    = of + stationId*StrawId::_nfaces*FaceZ_t::kNPlanesPerStation;//FaceZ_t::kNFaces;
-      //	int       panelId   = op + faceId*FaceZ_t::kNPanels;//PerFace;
+      
+      int faceId  = co.Face + co.Station*StrawId::_nfaces*FaceZ_t::kNPlanesPerStation;
+      ordKey  [i] = faceId*FaceZ_t::kNPanels + co.Panel;
+      ordIndex[i] = i;
+    }
+    std::stable_sort(ordIndex.begin(), ordIndex.end(), [&ordKey](int a, int b) { return ordKey[a] < ordKey[b]; });
+
+    for (int i=0; i<nOrdCh; ++i) {
+      ComboHit& ch = ordChCol[ordIndex[i]];
+
+      int       faceId    = ordKey[ordIndex[i]] / FaceZ_t::kNPanels;
+      int       of        = faceId % (StrawId::_nfaces*FaceZ_t::kNPlanesPerStation);
+      int       op        = ordKey[ordIndex[i]] % FaceZ_t::kNPanels;
       FaceZ_t*  fz        = &Helix._oTracker[faceId];
       PanelZ_t* pz        = &fz->panelZs[op];
 	
@@ -1651,6 +1656,7 @@ namespace mu2e {
       if ((op < 0) || (op >= FaceZ_t::kNPanels )) printf(" >>> ERROR: wrong panel   number: %i\n",op);
 
       Helix._chHitsToProcess.push_back(mu2e::ComboHit(ch));
+      Helix._chHitsInfo.push_back(HitInfo_t(faceId,op,Helix._chHitsToProcess.size()-1));
 
       if (pz->idChBegin < 0 ){
 	pz->idChBegin = Helix._chHitsToProcess.size() - 1;
@@ -2298,42 +2304,27 @@ namespace mu2e {
       }
     }
 
-    PanelZ_t*      panelz(0);
-    FaceZ_t*       facez(0);
-
     mu2e::ComboHit* hit   (0);
+//-----------------------------------------------------------------------------
+// hits are face-ordered: loop over the contiguous range downstream of the seed
+//-----------------------------------------------------------------------------
+    int nhits = Helix._chHitsToProcess.size();
 
-    for (int f=SeedIndex.face; f<StrawId::_ntotalfaces; ++f){
-      facez     = &Helix._oTracker[f];
-      int  firstPanel(0);
-      if (f == SeedIndex.face) firstPanel = SeedIndex.panel;
-
-      for (int p=firstPanel; p<FaceZ_t::kNPanels; ++p){
-	panelz = &facez->panelZs[p];//&Helix._oTracker[p];
-	int  nhits          = panelz->nChHits();
-	int  seedPanelIndex(0);
-	if (nhits == 0)                                                                    continue;
-	if ( (f==SeedIndex.face) && (p==SeedIndex.panel) && (SeedIndex.panelHitIndex >=0)) seedPanelIndex = SeedIndex.panelHitIndex - panelz->idChBegin;
-	
-	for (int i=seedPanelIndex; i<nhits; ++i){   
-	  int     index = panelz->idChBegin + i;
-	  hit = &Helix._chHitsToProcess[index];
-	  //	  int index = facez->evalUniqueHitIndex(f,p,i);
-	  if (Helix._hitsUsed[index] != 1)                     continue;
+    for (int index=Helix.firstHitIndex(SeedIndex); index<nhits; ++index){
+      hit = &Helix._chHitsToProcess[index];
+      if (Helix._hitsUsed[index] != 1)                     continue;
 
-	  wt             = calculateWeight(*hit,HelCenter,Radius);
-	  hit->_xyWeight = wt;
+      wt             = calculateWeight(*hit,HelCenter,Radius);
+      hit->_xyWeight = wt;
 
-	  Helix._sxy.addPoint(hit->_pos.x(),hit->_pos.y(),wt);
-	  Helix._nXYSh      += hit->nStrawHits();
-	  Helix._nComboHits += 1;
+      Helix._sxy.addPoint(hit->_pos.x(),hit->_pos.y(),wt);
+      Helix._nXYSh      += hit->nStrawHits();
+      Helix._nComboHits += 1;
     
-	  if (_debug > 10) {
-	    printf("[CalHelixFinderAlg::doWeightedCircleFit:LOOP] %4i %10.3f %10.3f %10.3f %10.3e %10.4f %10.4f\n",
-		   (int)hit->index(), hit->_pos.x(), hit->_pos.y(), hit->_pos.z(), wt, hit->_sdir.x(), hit->_sdir.y());
-	  }
-	}
-      }//end panels loop
+      if (_debug > 10) {
+	printf("[CalHelixFinderAlg::doWeightedCircleFit:LOOP] %4i %10.3f %10.3f %10.3f %10.3e %10.4f %10.4f\n",
+	       (int)hit->index(), hit->_pos.x(), hit->_pos.y(), hit->_pos.z(), wt, hit->_sdir.x(), hit->_sdir.y());
+      }
     }
 					// update helix info
     Radius  = Helix._sxy.radius();
@@ -2371,46 +2362,20 @@ namespace mu2e {
     float     dr, hitChi2;
   
     mu2e::ComboHit* hit(0);
-    FaceZ_t*        facez(0);
-    PanelZ_t*       panelz(0);
-    //    FaceZ_t*       seedFacez = &Helix._oTracker[Helix._seedIndex.face];
+    int             nhits = Helix._chHitsToProcess.size();
 
+    for (int index=Helix.firstHitIndex(SeedIndex); index<nhits; ++index){
+      hit = &Helix._chHitsToProcess[index];
+      if (Helix._hitsUsed[index] != 1)                    continue;
 
-    for (int f=SeedIndex.face; f<StrawId::_ntotalfaces;  ++f){
-      facez     = &Helix._oTracker[f]; 
-      int  firstPanel(0);
-      if (f == SeedIndex.face) firstPanel = SeedIndex.panel;
-      for (int p=firstPanel; p<FaceZ_t::kNPanels; ++p){
-	panelz = &facez->panelZs[p];//Helix._oTracker[p];
-	int  nhitsPerPanel  = panelz->nChHits();
-	int  seedPanelIndex(0);
-	if (nhitsPerPanel == 0)                                                            continue;
-	if ((f==SeedIndex.face) && (p==SeedIndex.panel) && (SeedIndex.panelHitIndex >=0)) seedPanelIndex = SeedIndex.panelHitIndex - panelz->idChBegin;  
+      dr      = calculateRadialDist(hit->_pos,HelCenter,Radius);
+      hitChi2 = dr*dr*hit->_xyWeight;
 
-	for (int i=seedPanelIndex; i<nhitsPerPanel; ++i){   
-	  int     index = panelz->idChBegin + i;
-	  hit = &Helix._chHitsToProcess[index];
-	  if (Helix._hitsUsed[index] != 1)                    continue;
-
-	  dr      = calculateRadialDist(hit->_pos,HelCenter,Radius);
-	  hitChi2 = dr*dr*hit->_xyWeight;
-
-	  // store info out the radial residual
-	  // if ((SeedIndex.face == 0) && (SeedIndex.panel == 0) && (SeedIndex.panelHitIndex == 0)) {
-	  // hit->_drFromPred  = fabs(dr);//hitChi2;
-	  // float dzFromSeed = facez->z - seedFacez->z;              // expected to be positive (non-negative)
-	  //	    hit->_dzFromSeed  = dzFromSeed;//FIXME!
-	  // }
-
-	  if (hitChi2 > HitChi2Worst) {
-	    HitChi2Worst         = hitChi2;
-	    Iworst.face          = f;
-	    Iworst.panel         = p;
-	    Iworst.panelHitIndex = index;
-	  }
-	}
-      }//end panels loop
-    }//end faces loop
+      if (hitChi2 > HitChi2Worst) {
+	HitChi2Worst         = hitChi2;
+	Iworst               = Helix._chHitsInfo[index];
+      }
+    }
   }
 
 //--------------------------------------------------------------------------------
@@ -2430,45 +2395,31 @@ namespace mu2e {
     IWorst.panelHitIndex = -1;
 
     mu2e::ComboHit* hit(0);
-    PanelZ_t*       panelz(0);
-    FaceZ_t*        facez(0);
- 
-    for (int f=SeedIndex.face; f<StrawId::_ntotalfaces; ++f){
-      facez     = &Helix._oTracker[f];
-      int  firstPanel(0);
-      if (f == SeedIndex.face) firstPanel = SeedIndex.panel;
-
-      for (int p=firstPanel; p<FaceZ_t::kNPanels; ++p){
-	panelz = &facez->panelZs[p];//&Helix._oTracker[p];
-	int  nhitsPerPanel  = panelz->nChHits();
-	int  seedPanelIndex(0);
-	if (nhitsPerPanel == 0)                                                             continue;
-	if ( (f==SeedIndex.face) && (p==SeedIndex.panel) && (SeedIndex.panelHitIndex >=0)) seedPanelIndex = SeedIndex.panelHitIndex - panelz->idChBegin;  
+    int             nhits = Helix._chHitsToProcess.size();
+//-----------------------------------------------------------------------------
+// each trial removes a single point from a copy of the sums, O(1) per hit
+//-----------------------------------------------------------------------------
+    for (int index=Helix.firstHitIndex(SeedIndex); index<nhits; ++index){
+      hit = &Helix._chHitsToProcess[index];
+      if (Helix._hitsUsed[index] != 1)                    continue;
 
-	for (int i=seedPanelIndex; i<nhitsPerPanel; ++i){   
-	  int     index = panelz->idChBegin + i;
-	  hit = &Helix._chHitsToProcess[index];
-	  //	  int index = facez->evalUniqueHitIndex(f,p,i);
-	  if (Helix._hitsUsed[index] != 1)                    continue;
+      sxy.init(Helix._sxy);
 
-	  sxy.init(Helix._sxy);
+      x  = hit->_pos.x();
+      y  = hit->_pos.y();
 
-	  x  = hit->_pos.x();
-	  y  = hit->_pos.y();
+      sxy.removePoint(x, y, hit->_xyWeight);
 
-	  sxy.removePoint(x, y, hit->_xyWeight);
+      chi2  = sxy.chi2DofCircle();
 
-	  chi2  = sxy.chi2DofCircle();
+      const HitInfo_t& hinfo = Helix._chHitsInfo[index];
+      int              i     = index - Helix._oTracker[hinfo.face].panelZs[hinfo.panel].idChBegin;
 
-	  if ((chi2 < chi2_min) || ( (i == SeedIndex.panelHitIndex) && (p == SeedIndex.panel) && (f == SeedIndex.face)) ) {
-	    chi2_min             = chi2;
-	    IWorst.face          = f;
-	    IWorst.panel         = p;
-	    IWorst.panelHitIndex = index;	    
-	  }
-	}
-      }//end panels loop
-    }//end faces loop
+      if ((chi2 < chi2_min) || ( (i == SeedIndex.panelHitIndex) && (hinfo.panel == SeedIndex.panel) && (hinfo.face == SeedIndex.face)) ) {
+	chi2_min             = chi2;
+	IWorst               = hinfo;
+      }
+    }
   }
 
 //-----------------------------------------------------------------------------
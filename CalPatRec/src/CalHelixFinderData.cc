@@ -16,6 +16,7 @@ namespace mu2e {
     _helix = NULL;
     _goodhits.reserve(kNMaxChHits);
     _chHitsToProcess. reserve(kNMaxChHits);
+    _chHitsInfo.      reserve(kNMaxChHits);
   }
 
 //-----------------------------------------------------------------------------
@@ -95,6 +96,23 @@ namespace mu2e {
     // else            O->Layer = X->Layer;       // order layer    
   }
 
+//-----------------------------------------------------------------------------
+  int CalHelixFinderData::firstHitIndex(const HitInfo_t& Seed) {
+    if (Seed.panelHitIndex >= 0) return Seed.panelHitIndex;
+
+    for (int f=Seed.face; f<StrawId::_ntotalfaces; ++f) {
+      FaceZ_t* facez = &_oTracker[f];
+      int firstPanel(0);
+      if (f == Seed.face) firstPanel = Seed.panel;
+
+      for (int p=firstPanel; p<FaceZ_t::kNPanels; ++p) {
+	PanelZ_t* panelz = &facez->panelZs[p];
+	if (panelz->nChHits() > 0) return panelz->idChBegin;
+      }
+    }
+    return _chHitsToProcess.size();
+  }
+
 //-----------------------------------------------------------------------------
 // don't clear the diagnostics part.
 //-----------------------------------------------------------------------------
@@ -104,6 +122,7 @@ namespace mu2e {
     _timeClusterPtr = art::Ptr<TimeCluster>();
 
     _chHitsToProcess.clear();
+    _chHitsInfo.clear();
 
     _goodhits.clear();
     
@@ -154,6 +173,7 @@ namespace mu2e {
     _timeClusterPtr = art::Ptr<TimeCluster>();
 
     _chHitsToProcess.clear();
+    _chHitsInfo.clear();
 
     _nFiltPoints    = 0;
     _nFiltStrawHits = 0;
@@ -209,6 +229,7 @@ void CalHelixFinderData::clearHelixInfo() {
     _goodhits.clear();
     
     _chHitsToProcess.clear();
+    _chHitsInfo.clear();
 
     _fit.setFailure(1,"failure");
     
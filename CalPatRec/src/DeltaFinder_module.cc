@@ -37,6 +37,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include "tbb/task_group.h"
 #include "CLHEP/Vector/ThreeVector.h"
 #include "Mu2eUtilities/inc/TwoLinePCA.hh"
 #include "Mu2eUtilities/inc/polyAtan2.hh"
@@ -90,6 +91,7 @@ namespace mu2e {
     float                               _maxDtDs;              // low-P electron travel time between two stations
     int                                 _writeStrawHits;
     int                                 _filter;
+    int                                 _parallelStations;     // find seeds in different stations in parallel tasks
 
     int                                 _debugLevel;
     int                                 _diagLevel;
@@ -128,8 +130,11 @@ namespace mu2e {
     bool         findData     (const art::Event&  Evt);
 
     int          orderHits ();
+					// hits in a panel are time-ordered: index of the first hit with time >= T
+    int          firstHitIndex(const PanelZ_t* Panelz, float T);
 
     void         findSeeds (int Station, int Face);
+    void         findSeeds (int Station);
     void         findSeeds ();
 
     void         getNeighborHits(DeltaSeed* Seed, int Face1, int Face2, PanelZ_t* panelz);
@@ -186,6 +191,7 @@ namespace mu2e {
     _maxDtDs               (pset.get<float>        ("maxDtDs"                      )),
     _writeStrawHits        (pset.get<int>          ("writeStrawHits"               )),
     _filter                (pset.get<int>          ("filter"                       )),
+    _parallelStations      (pset.get<int>          ("parallelStations"          ,0 )),
 
     _debugLevel            (pset.get<int>          ("debugLevel"                   )),
     _diagLevel             (pset.get<int>          ("diagLevel"                    )),
@@ -358,9 +364,29 @@ namespace mu2e {
       float sigw = sh->posRes(ComboHit::wire);// shp->posRes(StrawHitPosition::wire);
       pz->fHitData.push_back(HitData_t(sh,/*shp,straw,*/sigw));
     }
+//-----------------------------------------------------------------------------
+// time-order hits in each panel, so the time windows used in the seed search 
+// could be found with a binary search
+//-----------------------------------------------------------------------------
+    for (int s=0; s<kNStations; ++s) {
+      for (int f=0; f<kNFaces; ++f) {
+        for (int p=0; p<kNPanelsPerFace; ++p) {
+          std::vector<HitData_t>* hits = &_data.oTracker[s][f][p].fHitData;
+          std::stable_sort(hits->begin(),hits->end(),
+                           [](const HitData_t& h1, const HitData_t& h2) { return h1.fHit->time() < h2.fHit->time(); });
+        }
+      }
+    }
 
     return 0;
   }
+
+//-----------------------------------------------------------------------------
+  int DeltaFinder::firstHitIndex(const PanelZ_t* Panelz, float T) {
+    auto ih = std::lower_bound(Panelz->fHitData.begin(),Panelz->fHitData.end(),T,
+                               [](const HitData_t& Hd, float Time) { return Hd.fHit->time() < Time; });
+    return ih-Panelz->fHitData.begin();
+  }
   
 //------------------------------------------------------------------------------
 // try to recover hits of a 'Delta' candidate in a given 'Station'
@@ -383,14 +409,15 @@ namespace mu2e {
 //-----------------------------------------------------------------------------
 	  // for (int l=0; l<2; ++l) {
 	    int nhits = panelz->fHitData.size();
-	    for (int h=0; h<nhits; ++h) {
+	    for (int h=firstHitIndex(panelz,Delta->T0Min(Station)); h<nhits; ++h) {
 	      const HitData_t* hd = &panelz->fHitData[h];
 	      const ComboHit*  sh = hd->fHit;
 //-----------------------------------------------------------------------------
 // predicted time is the partticle time, the drift time should be larger
+// hits are time-ordered, so stop at the first one outside the window
 //-----------------------------------------------------------------------------
 	      if (sh->time() < Delta->T0Min(Station))                    continue;
-	      if (sh->time() > Delta->T0Max(Station)+_maxDriftTime)      continue;
+	      if (sh->time() > Delta->T0Max(Station)+_maxDriftTime)      break;
 
 	      //	      if (fabs(dt) > _maxDriftTime/2 + 10)                       continue;
 		  
@@ -996,13 +1023,17 @@ namespace mu2e {
             // panels do overlap
             //-----------------------------------------------------------------------------
             // for (int l2=0; l2<2;++l2) {
+            //-----------------------------------------------------------------------------
+            // hits are time-ordered, only look at the time window around the first hit
+            //-----------------------------------------------------------------------------
             int hitsize2 = panelz2->fHitData.size();
-            for (int h2=0; h2<hitsize2;++h2) {
+            for (int h2=firstHitIndex(panelz2,ct-_maxDriftTime); h2<hitsize2;++h2) {
               HitData_t* hd2 = &panelz2->fHitData[h2];
               const ComboHit* sh2 = hd2->fHit;
               //                  if (sh2->energyDep() >= _maxElectronHitEnergy)  continue;
               // if (fabs(sh2->dt())  >= _maxStrawDt)            continue;//FIXME!
               float t2 = sh2->time();
+              if (t2-ct >= _maxDriftTime)                     break;
               if (t2 < _minHitTime)                           continue;
               float dt = abs(t2 - ct);
               if (dt >= _maxDriftTime)                        continue;
@@ -1097,9 +1128,9 @@ namespace mu2e {
 
               _data.seedHolder[Station].push_back(seed);
               //-----------------------------------------------------------------------------
-              // book-keeping: increment total number of found seeds
+              // book-keeping: increment number of found seeds, the total is summed up 
+              // over the stations in findSeeds()
               //-----------------------------------------------------------------------------
-              _data.nseeds                      += 1;
               _data.nseeds_per_station[Station] += 1;
             }
             // }
@@ -1243,181 +1274,201 @@ namespace mu2e {
 // TODO: update the time as more hits are added
 //-----------------------------------------------------------------------------
   void DeltaFinder::findSeeds() {
+//-----------------------------------------------------------------------------
+// seeds are found station-by-station and the stations don't share any data,
+// so they could be processed by parallel tasks
+//-----------------------------------------------------------------------------
+    if (_parallelStations) {
+      tbb::task_group g;
+      for (int s=0; s<kNStations; ++s) {
+        g.run([this,s]() { findSeeds(s); });
+      }
+      g.wait();
+    }
+    else {
+      for (int s=0; s<kNStations; ++s) findSeeds(s);
+    }
+
+    for (int s=0; s<kNStations; ++s) _data.nseeds += _data.nseeds_per_station[s];
+  }
 
-    for (int s=0; s<kNStations; ++s) { 
-      for (int f1=0; f1<kNFaces-1; ++f1) {
+//-----------------------------------------------------------------------------
+  void DeltaFinder::findSeeds(int Station) {
+    int s = Station;
+
+    for (int f1=0; f1<kNFaces-1; ++f1) {
 //-----------------------------------------------------------------------------
 // 'last' - number of seeds found so far
 //-----------------------------------------------------------------------------
-	int last = _data.seedHolder[s].size();
+      int last = _data.seedHolder[s].size();
 	
-	findSeeds(s,f1);
+      findSeeds(s,f1);
 //-----------------------------------------------------------------------------
 // for seeds with hits in faces (f,f+1), (f,f+2), (f,f+3) find hits in other two faces
 //-----------------------------------------------------------------------------
-	int nseeds = _data.seedHolder[s].size();
-	for (int iseed=last; iseed<nseeds; iseed++) {
-	  DeltaSeed* seed = _data.seedHolder[s][iseed];
-	  double seed_phi = polyAtan2(seed->CofM.y(), seed->CofM.x());//seed->CofM.phi();              // check to find right panel
+      int nseeds = _data.seedHolder[s].size();
+      for (int iseed=last; iseed<nseeds; iseed++) {
+	DeltaSeed* seed = _data.seedHolder[s][iseed];
+	double seed_phi = polyAtan2(seed->CofM.y(), seed->CofM.x());//seed->CofM.phi();              // check to find right panel
 //-----------------------------------------------------------------------------
 // simultaneously update CoM coordinates
 //-----------------------------------------------------------------------------
-	  double sx(0), sy(0), snx2(0),snxny(0), sny2(0), snxnr(0), snynr(0);
+	double sx(0), sy(0), snx2(0),snxny(0), sny2(0), snxnr(0), snynr(0);
 
-	  for (int face=f1; face<kNFaces; face++) {
-	    int nh = seed->NHits(face);
-	    for (int ih=0; ih<nh; ih++) {
-	      const HitData_t* hd = seed->HitData(face,ih);
-	      // const Straw*     s  = hd->fStraw;
-
-	      double x0 = hd->fHit->pos().x();// CHECK IT! s->getMidPoint().x();
-	      double y0 = hd->fHit->pos().y();// CHECK IT! s->getMidPoint().y();
-	      double nx = hd->fHit->wdir().x();//          s->getDirection().x();
-	      double ny = hd->fHit->wdir().y();//          s->getDirection().y();
-	      double nr = nx*x0+ny*y0;
+	for (int face=f1; face<kNFaces; face++) {
+	  int nh = seed->NHits(face);
+	  for (int ih=0; ih<nh; ih++) {
+	    const HitData_t* hd = seed->HitData(face,ih);
+	    // const Straw*     s  = hd->fStraw;
+
+	    double x0 = hd->fHit->pos().x();// CHECK IT! s->getMidPoint().x();
+	    double y0 = hd->fHit->pos().y();// CHECK IT! s->getMidPoint().y();
+	    double nx = hd->fHit->wdir().x();//          s->getDirection().x();
+	    double ny = hd->fHit->wdir().y();//          s->getDirection().y();
+	    double nr = nx*x0+ny*y0;
 	      
-	      sx    += x0;
-	      sy    += y0;
-	      snx2  += nx*nx;
-	      snxny += nx*ny;
-	      sny2  += ny*ny;
-	      snxnr += nx*nr;
-	      snynr += ny*nr;
-	    }
+	    sx    += x0;
+	    sy    += y0;
+	    snx2  += nx*nx;
+	    snxny += nx*ny;
+	    sny2  += ny*ny;
+	    snxnr += nx*nr;
+	    snynr += ny*nr;
 	  }
+	}
 //-----------------------------------------------------------------------------
 // loop over remaining two faces, 'f2' - face in question
 //-----------------------------------------------------------------------------
-	  for (int f2=0; f2<kNFaces; f2++) {
-	    if (seed->fFaceProcessed[f2] == 1)                              continue;
+	for (int f2=0; f2<kNFaces; f2++) {
+	  if (seed->fFaceProcessed[f2] == 1)                              continue;
 //-----------------------------------------------------------------------------
 // face is different from the two first faces used
 //-----------------------------------------------------------------------------
-	    for (int p2=0; p2<3; ++p2) {
-	      PanelZ_t* panelz = &_data.oTracker[s][f2][p2];
-	      double dphi      = seed_phi-panelz->phi;
-	      if (dphi < -M_PI) dphi += 2*M_PI;
-	      if (dphi >  M_PI) dphi -= 2*M_PI;
-	      if (fabs(dphi) >= M_PI/3)                                     continue;
+	  for (int p2=0; p2<3; ++p2) {
+	    PanelZ_t* panelz = &_data.oTracker[s][f2][p2];
+	    double dphi      = seed_phi-panelz->phi;
+	    if (dphi < -M_PI) dphi += 2*M_PI;
+	    if (dphi >  M_PI) dphi -= 2*M_PI;
+	    if (fabs(dphi) >= M_PI/3)                                     continue;
 //-----------------------------------------------------------------------------
 // panel overlaps with the seed, look at its hits
 //-----------------------------------------------------------------------------
-	      // for(int l=0; l<2; ++l) {
-		int psize = panelz->fHitData.size();
-		for (int h=0; h<psize; ++h) { // find hit
+	    // for(int l=0; l<2; ++l) {
+	      int psize = panelz->fHitData.size();
+	      for (int h=firstHitIndex(panelz,seed->T0Min()); h<psize; ++h) { // find hit
 //-----------------------------------------------------------------------------
 // 2017-10-05 PM: consider all hits 
 // hit time should be consistent with the already existing times - the difference
 // between any two measured hit times should not exceed _maxDriftTime 
 // (_maxDriftTime represents the maximal drift time in the straw, should there be some tolerance?)
+// hits are time-ordered, so stop at the first one outside the window
 //-----------------------------------------------------------------------------
-		  HitData_t* hd      = &panelz->fHitData[h];
-		  const ComboHit* sh = hd->fHit;
+		HitData_t* hd      = &panelz->fHitData[h];
+		const ComboHit* sh = hd->fHit;
 
-		  if (sh->time()-seed->T0Max() > _maxDriftTime          ) continue;
-		  if (sh->time()               < seed->T0Min()          ) continue;
+		if (sh->time()-seed->T0Max() > _maxDriftTime          ) break;
+		if (sh->time()               < seed->T0Min()          ) continue;
 
-		  // const StrawHitPosition* shp  = hd->fPos;
-		  CLHEP::Hep3Vector       dxyz = sh->posCLHEP()-seed->CofM;// shp->posCLHEP()-seed->CofM; // distance from hit to preseed
+		// const StrawHitPosition* shp  = hd->fPos;
+		CLHEP::Hep3Vector       dxyz = sh->posCLHEP()-seed->CofM;// shp->posCLHEP()-seed->CofM; // distance from hit to preseed
 //-----------------------------------------------------------------------------
 // split into wire parallel and perpendicular components
 //-----------------------------------------------------------------------------
-		  const CLHEP::Hep3Vector& wdir = hd->fHit->wdirCLHEP();//fStraw->getDirection();
-		  CLHEP::Hep3Vector d_par    = (dxyz.dot(wdir))/(wdir.dot(wdir))*wdir; 
-		  CLHEP::Hep3Vector d_perp_z = dxyz-d_par;
-		  float  d_perp              = d_perp_z.perp();
-		  double sigw                = hd->fSigW;
-		  float  chi2_par            = (d_par.mag()/sigw)*(d_par.mag()/sigw);
-		  float  chi2_perp           = (d_perp/_sigmaR)*(d_perp/_sigmaR);
-		  float  chi2                = chi2_par + chi2_perp;
-		  if (chi2 >= _maxChi2Radial)                             continue;
+		const CLHEP::Hep3Vector& wdir = hd->fHit->wdirCLHEP();//fStraw->getDirection();
+		CLHEP::Hep3Vector d_par    = (dxyz.dot(wdir))/(wdir.dot(wdir))*wdir; 
+		CLHEP::Hep3Vector d_perp_z = dxyz-d_par;
+		float  d_perp              = d_perp_z.perp();
+		double sigw                = hd->fSigW;
+		float  chi2_par            = (d_par.mag()/sigw)*(d_par.mag()/sigw);
+		float  chi2_perp           = (d_perp/_sigmaR)*(d_perp/_sigmaR);
+		float  chi2                = chi2_par + chi2_perp;
+		if (chi2 >= _maxChi2Radial)                             continue;
 //-----------------------------------------------------------------------------
 // add hit
 //-----------------------------------------------------------------------------
-		  hd->fChi2Min = chi2;
-		  seed->hitlist[f2].push_back(hd);
+		hd->fChi2Min = chi2;
+		seed->hitlist[f2].push_back(hd);
 
-		  if (sh->time() < seed->fMinTime) seed->fMinTime = sh->time();
-		  if (sh->time() > seed->fMaxTime) seed->fMaxTime = sh->time();
+		if (sh->time() < seed->fMinTime) seed->fMinTime = sh->time();
+		if (sh->time() > seed->fMaxTime) seed->fMaxTime = sh->time();
 
-		  seed->fNHitsTot++;
+		seed->fNHitsTot++;
 //-----------------------------------------------------------------------------
 // in parallel, update coordinate sums
 //-----------------------------------------------------------------------------
-		  // const Straw* straw  = hd->fStraw;
+		// const Straw* straw  = hd->fStraw;
 
-		  double x0 = hd->fHit->pos().x();//straw->getMidPoint().x();
-		  double y0 = hd->fHit->pos().y();// straw->getMidPoint().y();
-		  double nx = hd->fHit->wdir().x();// straw->getDirection().x();
-		  double ny = hd->fHit->wdir().y();//  straw->getDirection().y();
-		  double nr = nx*x0+ny*y0;
+		double x0 = hd->fHit->pos().x();//straw->getMidPoint().x();
+		double y0 = hd->fHit->pos().y();// straw->getMidPoint().y();
+		double nx = hd->fHit->wdir().x();// straw->getDirection().x();
+		double ny = hd->fHit->wdir().y();//  straw->getDirection().y();
+		double nr = nx*x0+ny*y0;
 		      
-		  sx    += x0;
-		  sy    += y0;
-		  snx2  += nx*nx;
-		  snxny += nx*ny;
-		  sny2  += ny*ny;
-		  snxnr += nx*nr;
-		  snynr += ny*nr;
-		}
-	      // }
-	    }
+		sx    += x0;
+		sy    += y0;
+		snx2  += nx*nx;
+		snxny += nx*ny;
+		sny2  += ny*ny;
+		snxnr += nx*nr;
+		snynr += ny*nr;
+	      }
+	    // }
+	  }
 //-----------------------------------------------------------------------------
 // update seed time and X and Y coordinates, accurate knowledge of Z is not very relevant
 //-----------------------------------------------------------------------------
-	    double x_mean, y_mean, nxny_mean, nx2_mean, ny2_mean, nxnr_mean, nynr_mean;
+	  double x_mean, y_mean, nxny_mean, nx2_mean, ny2_mean, nxnr_mean, nynr_mean;
 
-	    x_mean    = sx   /seed->fNHitsTot;
-	    y_mean    = sy   /seed->fNHitsTot;
-	    nxny_mean = snxny/seed->fNHitsTot;
-	    nx2_mean  = snx2 /seed->fNHitsTot;
-	    ny2_mean  = sny2 /seed->fNHitsTot;
-	    nxnr_mean = snxnr/seed->fNHitsTot;
-	    nynr_mean = snynr/seed->fNHitsTot;
+	  x_mean    = sx   /seed->fNHitsTot;
+	  y_mean    = sy   /seed->fNHitsTot;
+	  nxny_mean = snxny/seed->fNHitsTot;
+	  nx2_mean  = snx2 /seed->fNHitsTot;
+	  ny2_mean  = sny2 /seed->fNHitsTot;
+	  nxnr_mean = snxnr/seed->fNHitsTot;
+	  nynr_mean = snynr/seed->fNHitsTot;
 
-	    double d = (1-nx2_mean)*(1-ny2_mean)-nxny_mean*nxny_mean;
+	  double d = (1-nx2_mean)*(1-ny2_mean)-nxny_mean*nxny_mean;
 	    
-	    double x0 = ((x_mean-nxnr_mean)*(1-ny2_mean)+(y_mean-nynr_mean)*nxny_mean)/d;
-	    double y0 = ((y_mean-nynr_mean)*(1-nx2_mean)+(x_mean-nxnr_mean)*nxny_mean)/d;
+	  double x0 = ((x_mean-nxnr_mean)*(1-ny2_mean)+(y_mean-nynr_mean)*nxny_mean)/d;
+	  double y0 = ((y_mean-nynr_mean)*(1-nx2_mean)+(x_mean-nxnr_mean)*nxny_mean)/d;
 
-	    seed->CofM.setX(x0);
-	    seed->CofM.setY(y0);
+	  seed->CofM.setX(x0);
+	  seed->CofM.setY(y0);
 
-	    if (seed->hitlist[f2].size() > 0) seed->fNFacesWithHits++;
-	    seed->fFaceProcessed[f2] = 1;
-	  }
+	  if (seed->hitlist[f2].size() > 0) seed->fNFacesWithHits++;
+	  seed->fFaceProcessed[f2] = 1;
+	}
 //-----------------------------------------------------------------------------
 // calculate chi2 of the found seed
 //-----------------------------------------------------------------------------
-	  seed->fChi2All = 0;
-	  for (int face=0; face<kNFaces; face++) {
-	    int nh = seed->NHits(face);
-	    for (int ih=0; ih<nh; ih++) {
-	      const HitData_t* hd = seed->HitData(face,ih);
+	seed->fChi2All = 0;
+	for (int face=0; face<kNFaces; face++) {
+	  int nh = seed->NHits(face);
+	  for (int ih=0; ih<nh; ih++) {
+	    const HitData_t* hd = seed->HitData(face,ih);
 
-	      // const StrawHitPosition* shp  = hd->fPos;
-	      CLHEP::Hep3Vector       dxyz = hd->fHit->posCLHEP()-seed->CofM; //shp->posCLHEP()-seed->CofM; // distance from hit to the center-of-gravity
+	    // const StrawHitPosition* shp  = hd->fPos;
+	    CLHEP::Hep3Vector       dxyz = hd->fHit->posCLHEP()-seed->CofM; //shp->posCLHEP()-seed->CofM; // distance from hit to the center-of-gravity
 //-----------------------------------------------------------------------------
 // split into wire parallel and perpendicular components
 //-----------------------------------------------------------------------------
-	      const CLHEP::Hep3Vector& wdir = hd->fHit->wdirCLHEP();//fStraw->getDirection();
-	      CLHEP::Hep3Vector d_par       = (dxyz.dot(wdir))/(wdir.dot(wdir))*wdir; 
-	      CLHEP::Hep3Vector d_perp_z    = dxyz-d_par;
-	      float  d_perp                 = d_perp_z.perp();
-	      double sigw                   = hd->fSigW;
-	      float  chi2_par               = (d_par.mag()/sigw)*(d_par.mag()/sigw);
-	      float  chi2_perp              = (d_perp/_sigmaR)*(d_perp/_sigmaR);
-	      float  chi2                   = chi2_par + chi2_perp;
-	      seed->fChi2All               += chi2;
-	    }
+	    const CLHEP::Hep3Vector& wdir = hd->fHit->wdirCLHEP();//fStraw->getDirection();
+	    CLHEP::Hep3Vector d_par       = (dxyz.dot(wdir))/(wdir.dot(wdir))*wdir; 
+	    CLHEP::Hep3Vector d_perp_z    = dxyz-d_par;
+	    float  d_perp                 = d_perp_z.perp();
+	    double sigw                   = hd->fSigW;
+	    float  chi2_par               = (d_par.mag()/sigw)*(d_par.mag()/sigw);
+	    float  chi2_perp              = (d_perp/_sigmaR)*(d_perp/_sigmaR);
+	    float  chi2                   = chi2_par + chi2_perp;
+	    seed->fChi2All               += chi2;
 	  }
-	  seed->fChi2All = seed->fChi2All/seed->fNHitsTot;
 	}
+	seed->fChi2All = seed->fChi2All/seed->fNHitsTot;
+      }
 //-----------------------------------------------------------------------------
 // prune list of found seeds
 //-----------------------------------------------------------------------------
-	pruneSeeds(s);
-      }
+      pruneSeeds(s);
     }
   }
 
@@ -1444,6 +1495,16 @@ namespace mu2e {
     //continue, incrementing over stations until all finished
     //what to do if there are gaps in the path?
     //update center of mass?
+//-----------------------------------------------------------------------------
+// per-station lists of seeds ordered in T0Min, so the search for the closest
+// seed could stop as soon as the seeds are beyond the predicted T0 window
+//-----------------------------------------------------------------------------
+    std::vector<DeltaSeed*> seedsByT0[kNStations];
+    for (int s=0; s<kNStations; ++s) {
+      seedsByT0[s] = _data.seedHolder[s];
+      std::stable_sort(seedsByT0[s].begin(),seedsByT0[s].end(),
+                       [](DeltaSeed* s1, DeltaSeed* s2) { return s1->T0Min() < s2->T0Min(); });
+    }
 
     for (int s=0; s<kNStations; ++s) {
       int pssize = _data.seedHolder[s].size();
@@ -1490,14 +1551,14 @@ namespace mu2e {
 	  DeltaSeed* closest(NULL);
 	  float      dxy, dxy_min(_maxDxy);
 
-	  int ps2size = _data.seedHolder[s2].size();
+	  int ps2size = seedsByT0[s2].size();
 	  for (int ps2=0; ps2<ps2size; ++ps2) {
-	    DeltaSeed* seed2 = _data.seedHolder[s2][ps2];
+	    DeltaSeed* seed2 = seedsByT0[s2][ps2];
+	    if (seed2->T0Min() - t0max >  10.)               break;    // all the following seeds are later
 	    if (seed2->fGood < 0)                            continue;
 	    if (seed2->Used()   )                            continue;
 	    if (seed2->fNFacesWithHits < _minNFacesWithHits) continue;
 	    if (seed2->T0Max() - t0min < -10.)               continue; // *FIXME* make a parameter
-	    if (seed2->T0Min() - t0max >  10.)               continue;
 //-----------------------------------------------------------------------------
 // seed2 T0 is consistent with the predicted T0
 //-----------------------------------------------------------------------------
@@ -0,0 +1,67 @@
+#ifndef CaloShowerLibrary_HH
+#define CaloShowerLibrary_HH
+//
+// Library of pre-simulated showers for the calorimeter fast simulation.
+//
+// Showers are binned in particle type (e+- or photon), kinetic energy, cosine of the entry
+// angle with respect to the disk axis and entry radius on the disk.  Each shower is a list
+// of energy deposits in the frame of the incoming particle: w along its direction, u
+// radially outward in the plane orthogonal to it, v = w x u, with the time since the entry
+// and the fraction of the entry energy.  The deposits are sorted in time.
+//
+// The library is made by the CaloShowerLibraryMaker module and stored in a ROOT file.
+//
+
+#include "CLHEP/Vector/ThreeVector.h"
+#include <string>
+#include <vector>
+
+
+namespace mu2e {
+
+
+   class CaloShowerLibrary {
+
+       public:
+
+          struct Deposit { float u, v, w, time, efrac; };
+
+          struct Shower {
+             float                energy;
+             std::vector<Deposit> deposits;
+          };
+
+          CaloShowerLibrary(const std::vector<double>& energyEdges, const std::vector<double>& cosThetaEdges,
+                            const std::vector<double>& radiusEdges);
+          explicit CaloShowerLibrary(const std::string& fileName);
+          ~CaloShowerLibrary() {};
+
+          // -1 if the particle or the entry point is not covered by the library
+          int particleType(int pdgId) const;
+          int bin(int ptype, double energy, double cosTheta, double radius) const;
+
+          // axes u, v of the deposit frame for a particle entering at posDisk (disk frame) along dir
+          static void frame(const CLHEP::Hep3Vector& posDisk, const CLHEP::Hep3Vector& dir,
+                            CLHEP::Hep3Vector& u, CLHEP::Hep3Vector& v);
+
+          void add(int ibin, const Shower& shower)       {showers_.at(ibin).push_back(shower);}
+          void write(const std::string& fileName)  const;
+
+          const std::vector<Shower>& showers(int ibin)  const {return showers_.at(ibin);}
+          int                        nBins()            const {return showers_.size();}
+          double                     minEnergy()        const {return energyEdges_.front();}
+
+
+      private:
+
+          void init();
+          int  findBin(const std::vector<double>& edges, double value) const;
+
+          std::vector<double>               energyEdges_;
+          std::vector<double>               cosThetaEdges_;
+          std::vector<double>               radiusEdges_;
+          std::vector< std::vector<Shower> > showers_;
+   };
+
+}
+#endif
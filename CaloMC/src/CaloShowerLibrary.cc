@@ -0,0 +1,170 @@
+//
+// Library of pre-simulated showers for the calorimeter fast simulation
+//
+
+#include "CaloMC/inc/CaloShowerLibrary.hh"
+#include "cetlib_except/exception.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TVectorD.h"
+
+
+namespace mu2e {
+
+
+   CaloShowerLibrary::CaloShowerLibrary(const std::vector<double>& energyEdges, const std::vector<double>& cosThetaEdges,
+                                        const std::vector<double>& radiusEdges) :
+     energyEdges_(energyEdges), cosThetaEdges_(cosThetaEdges), radiusEdges_(radiusEdges), showers_()
+   {
+       init();
+   }
+
+
+   //----------------------------------------------------------------------------------------------------------------------
+   CaloShowerLibrary::CaloShowerLibrary(const std::string& fileName) :
+     energyEdges_(), cosThetaEdges_(), radiusEdges_(), showers_()
+   {
+       std::unique_ptr<TFile> file(TFile::Open(fileName.c_str()));
+       if (!file || file->IsZombie()) throw cet::exception("CATEGORY")<<"CaloShowerLibrary:: cannot open file "<<fileName;
+
+       TVectorD* energyEdges   = (TVectorD*) file->Get("energyEdges");
+       TVectorD* cosThetaEdges = (TVectorD*) file->Get("cosThetaEdges");
+       TVectorD* radiusEdges   = (TVectorD*) file->Get("radiusEdges");
+       TTree*    tree          = (TTree*)    file->Get("showers");
+       if (!energyEdges || !cosThetaEdges || !radiusEdges || !tree)
+         throw cet::exception("CATEGORY")<<"CaloShowerLibrary:: file "<<fileName<<" is not a shower library";
+
+       energyEdges_.assign(  energyEdges->GetMatrixArray(),   energyEdges->GetMatrixArray()   + energyEdges->GetNoElements());
+       cosThetaEdges_.assign(cosThetaEdges->GetMatrixArray(), cosThetaEdges->GetMatrixArray() + cosThetaEdges->GetNoElements());
+       radiusEdges_.assign(  radiusEdges->GetMatrixArray(),   radiusEdges->GetMatrixArray()   + radiusEdges->GetNoElements());
+       init();
+
+       int   ibin(0);
+       float energy(0);
+       std::vector<float> *u(nullptr), *v(nullptr), *w(nullptr), *time(nullptr), *efrac(nullptr);
+       tree->SetBranchAddress("bin",    &ibin);
+       tree->SetBranchAddress("energy", &energy);
+       tree->SetBranchAddress("u",      &u);
+       tree->SetBranchAddress("v",      &v);
+       tree->SetBranchAddress("w",      &w);
+       tree->SetBranchAddress("time",   &time);
+       tree->SetBranchAddress("efrac",  &efrac);
+
+       for (Long64_t ientry=0; ientry<tree->GetEntries(); ++ientry)
+       {
+           tree->GetEntry(ientry);
+           if (ibin < 0 || ibin >= nBins()) continue;
+
+           Shower shower;
+           shower.energy = energy;
+           shower.deposits.reserve(u->size());
+           for (size_t i=0; i<u->size(); ++i) shower.deposits.push_back(Deposit{(*u)[i],(*v)[i],(*w)[i],(*time)[i],(*efrac)[i]});
+           showers_[ibin].push_back(std::move(shower));
+       }
+   }
+
+
+   //----------------------------------------------------------------------------------------------------------------------
+   void CaloShowerLibrary::init()
+   {
+       if (energyEdges_.size() < 2 || cosThetaEdges_.size() < 2 || radiusEdges_.size() < 2)
+         throw cet::exception("CATEGORY")<<"CaloShowerLibrary:: each binning needs at least two edges";
+
+       showers_.assign(2*(energyEdges_.size()-1)*(cosThetaEdges_.size()-1)*(radiusEdges_.size()-1), std::vector<Shower>());
+   }
+
+
+   //----------------------------------------------------------------------------------------------------------------------
+   int CaloShowerLibrary::particleType(int pdgId) const
+   {
+       if (pdgId == 11 || pdgId == -11) return 0;
+       if (pdgId == 22)                 return 1;
+       return -1;
+   }
+
+
+   int CaloShowerLibrary::findBin(const std::vector<double>& edges, double value) const
+   {
+       if (value < edges.front() || value >= edges.back()) return -1;
+       return std::upper_bound(edges.begin(),edges.end(),value) - edges.begin() - 1;
+   }
+
+
+   int CaloShowerLibrary::bin(int ptype, double energy, double cosTheta, double radius) const
+   {
+       if (ptype < 0) return -1;
+       int ie = findBin(energyEdges_,   energy);
+       int ic = findBin(cosThetaEdges_, cosTheta);
+       int ir = findBin(radiusEdges_,   radius);
+       if (ie < 0 || ic < 0 || ir < 0) return -1;
+
+       int nc = cosThetaEdges_.size()-1;
+       int nr = radiusEdges_.size()-1;
+       int ne = energyEdges_.size()-1;
+       return ((ptype*ne + ie)*nc + ic)*nr + ir;
+   }
+
+
+   //----------------------------------------------------------------------------------------------------------------------
+   void CaloShowerLibrary::frame(const CLHEP::Hep3Vector& posDisk, const CLHEP::Hep3Vector& dir,
+                                 CLHEP::Hep3Vector& u, CLHEP::Hep3Vector& v)
+   {
+       CLHEP::Hep3Vector radial(posDisk.x(),posDisk.y(),0);
+       u = radial - radial.dot(dir)*dir;
+       if (u.mag() < 1e-6) u = dir.orthogonal();
+       u = u.unit();
+       v = dir.cross(u);
+   }
+
+
+   //----------------------------------------------------------------------------------------------------------------------
+   void CaloShowerLibrary::write(const std::string& fileName) const
+   {
+       TFile file(fileName.c_str(),"RECREATE");
+       if (!file.IsOpen()) throw cet::exception("CATEGORY")<<"CaloShowerLibrary:: cannot create file "<<fileName;
+
+       TVectorD energyEdges(energyEdges_.size(),     energyEdges_.data());
+       TVectorD cosThetaEdges(cosThetaEdges_.size(), cosThetaEdges_.data());
+       TVectorD radiusEdges(radiusEdges_.size(),     radiusEdges_.data());
+       energyEdges.Write("energyEdges");
+       cosThetaEdges.Write("cosThetaEdges");
+       radiusEdges.Write("radiusEdges");
+
+       int   ibin(0);
+       float energy(0);
+       std::vector<float> u, v, w, time, efrac;
+       TTree* tree = new TTree("showers","Calorimeter shower library");
+       tree->Branch("bin",    &ibin);
+       tree->Branch("energy", &energy);
+       tree->Branch("u",      &u);
+       tree->Branch("v",      &v);
+       tree->Branch("w",      &w);
+       tree->Branch("time",   &time);
+       tree->Branch("efrac",  &efrac);
+
+       for (ibin=0; ibin<nBins(); ++ibin)
+       {
+           for (const Shower& shower : showers_[ibin])
+           {
+               energy = shower.energy;
+               u.clear(); v.clear(); w.clear(); time.clear(); efrac.clear();
+               for (const Deposit& dep : shower.deposits)
+               {
+                   u.push_back(dep.u); v.push_back(dep.v); w.push_back(dep.w);
+                   time.push_back(dep.time); efrac.push_back(dep.efrac);
+               }
+               tree->Fill();
+           }
+       }
+
+       tree->Write();
+       file.Close();
+   }
+
+}
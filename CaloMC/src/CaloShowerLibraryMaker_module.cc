@@ -0,0 +1,136 @@
+//
+// Build the shower library of the calorimeter fast simulation (Mu2eG4 physics.caloFastSim) from
+// full simulation events.
+//
+// Each event must contain a single e+-/photon shot at the calorimeter.  The entry point and direction
+// are taken from the first hit of the primary particle on the front face virtual detector of a disk,
+// the deposits from the crystal CaloShowerSteps of the event.  The deposits are stored in the frame of
+// the incoming particle (see CaloMC/inc/CaloShowerLibrary.hh), and the library is written at the end
+// of the job.
+//
+
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+
+#include "CaloMC/inc/CaloShowerLibrary.hh"
+#include "CalorimeterGeom/inc/Calorimeter.hh"
+#include "DataProducts/inc/VirtualDetectorId.hh"
+#include "GeometryService/inc/GeomHandle.hh"
+#include "GlobalConstantsService/inc/GlobalConstantsHandle.hh"
+#include "GlobalConstantsService/inc/ParticleDataTable.hh"
+#include "MCDataProducts/inc/CaloShowerStepCollection.hh"
+#include "MCDataProducts/inc/StepPointMCCollection.hh"
+
+#include "CLHEP/Vector/ThreeVector.h"
+
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+
+
+namespace mu2e {
+
+
+  class CaloShowerLibraryMaker : public art::EDAnalyzer {
+
+     public:
+
+       explicit CaloShowerLibraryMaker(fhicl::ParameterSet const& pset) :
+         art::EDAnalyzer{pset},
+         vdToken_{consumes<StepPointMCCollection>(pset.get<std::string>("vdStepPoints"))},
+         caloShowerToken_{consumes<CaloShowerStepCollection>(pset.get<std::string>("caloShowerSteps"))},
+         fileName_(         pset.get<std::string>("fileName") ),
+         maxShowersPerBin_( pset.get<unsigned>(   "maxShowersPerBin",1000) ),
+         diagLevel_(        pset.get<int>(        "diagLevel",0) ),
+         library_(pset.get<std::vector<double>>("energyEdges"),
+                  pset.get<std::vector<double>>("cosThetaEdges"),
+                  pset.get<std::vector<double>>("radiusEdges")),
+         nShowers_(0)
+       {}
+
+       void analyze(const art::Event& event) override;
+       void endJob() override;
+
+
+     private:
+
+       art::ProductToken<StepPointMCCollection>    vdToken_;
+       art::ProductToken<CaloShowerStepCollection> caloShowerToken_;
+       std::string                                 fileName_;
+       unsigned                                    maxShowersPerBin_;
+       int                                         diagLevel_;
+       CaloShowerLibrary                           library_;
+       int                                         nShowers_;
+  };
+
+
+  //--------------------------------------------------------------------
+  void CaloShowerLibraryMaker::analyze(const art::Event& event)
+  {
+      const Calorimeter& cal = *(GeomHandle<Calorimeter>());
+      GlobalConstantsHandle<ParticleDataTable> pdt;
+
+      const auto& vdSteps    = *event.getValidHandle(vdToken_);
+      const auto& caloShower = *event.getValidHandle(caloShowerToken_);
+
+      // first entry of the primary particle on the front face of a disk
+      const StepPointMC* entry(nullptr);
+      for (const auto& step : vdSteps)
+      {
+          if (step.volumeId() != VirtualDetectorId::EMC_Disk_0_SurfIn &&
+              step.volumeId() != VirtualDetectorId::EMC_Disk_1_SurfIn) continue;
+          if (step.simParticle()->hasParent()) continue;
+          if (entry == nullptr || step.time() < entry->time()) entry = &step;
+      }
+      if (entry == nullptr) return;
+
+      PDGCode::type pdgId = entry->simParticle()->pdgId();
+
+      int    ptype  = library_.particleType(pdgId);
+      int    diskId = (entry->volumeId() == VirtualDetectorId::EMC_Disk_0_SurfIn) ? 0 : 1;
+      double mass   = pdt->particle(pdgId).ref().mass().value();
+      double energy = std::sqrt(entry->momentum().mag2()+mass*mass) - mass;
+
+      CLHEP::Hep3Vector posDisk = cal.geomUtil().mu2eToDisk(diskId,entry->position());
+      CLHEP::Hep3Vector dir     = (cal.geomUtil().mu2eToDisk(diskId,entry->position()+entry->momentum().unit()) - posDisk).unit();
+
+      int ibin = library_.bin(ptype,energy,dir.z(),posDisk.perp());
+      if (ibin < 0 || library_.showers(ibin).size() >= maxShowersPerBin_) return;
+
+      CLHEP::Hep3Vector u,v;
+      CaloShowerLibrary::frame(posDisk,dir,u,v);
+
+      CaloShowerLibrary::Shower shower;
+      shower.energy = energy;
+      for (const auto& step : caloShower)
+      {
+          CLHEP::Hep3Vector pos = cal.geomUtil().mu2eToDisk(diskId,cal.geomUtil().crystalToMu2e(step.volumeId(),step.position())) - posDisk;
+          shower.deposits.push_back(CaloShowerLibrary::Deposit{float(pos.dot(u)), float(pos.dot(v)), float(pos.dot(dir)),
+                                                               float(step.timeStepMC()-entry->time()), float(step.energyMC()/energy)});
+      }
+      std::sort(shower.deposits.begin(),shower.deposits.end(),
+                [](const CaloShowerLibrary::Deposit& a, const CaloShowerLibrary::Deposit& b) {return a.time < b.time;});
+
+      library_.add(ibin,shower);
+      ++nShowers_;
+
+      if (diagLevel_ > 0) std::cout<<"[CaloShowerLibraryMaker::analyze] pdg="<<pdgId<<" E="<<energy<<" cosTheta="<<dir.z()
+                                   <<" r="<<posDisk.perp()<<" bin="<<ibin<<" deposits="<<shower.deposits.size()<<std::endl;
+  }
+
+
+  //--------------------------------------------------------------------
+  void CaloShowerLibraryMaker::endJob()
+  {
+      library_.write(fileName_);
+      std::cout<<"[CaloShowerLibraryMaker::endJob] wrote "<<nShowers_<<" showers to "<<fileName_<<std::endl;
+  }
+
+}
+
+using mu2e::CaloShowerLibraryMaker;
+DEFINE_ART_MODULE(CaloShowerLibraryMaker);
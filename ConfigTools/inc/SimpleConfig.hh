@@ -66,11 +66,18 @@ namespace mu2e {
      * messageOnDefault     - Print a message when a parameter is not found in the file
      *                        and takes on a default value.
      *
+     * snapshotFile         - If not empty, the name of a binary snapshot of the parsed
+     *                        records.  If the snapshot exists and all of the files that
+     *                        it was made from are unchanged, the records are loaded from
+     *                        it instead of parsing the input file and its includes.
+     *                        Otherwise the input is parsed and the snapshot is (re)written.
+     *
      */
     SimpleConfig( const std::string& filename = "runtime.conf",
                   bool allowReplacement       = true,
                   bool messageOnReplacement   = false,
-                  bool messageOnDefault       = false );
+                  bool messageOnDefault       = false,
+                  const std::string& snapshotFile = "" );
 
     ~SimpleConfig(){}
 
@@ -319,6 +326,9 @@ namespace mu2e {
     // count of input file lines, available after construction
     std::size_t inputFileLines() const {return _inputFileLines;}
 
+    // true if the records were loaded from the snapshot file
+    bool fromSnapshot() const {return _fromSnapshot;}
+
     /**
      * Print access counts for each record.
      *
@@ -371,6 +381,20 @@ namespace mu2e {
     // count of input lines
     std::size_t _inputFileLines;
 
+    // The files that were read, this one and all of the included ones, with
+    // their size and modification time; used to validate a snapshot.
+    struct FileStamp {
+      std::string requested;
+      std::string resolved;
+      long long   size;
+      long long   mtime;
+    };
+    std::vector<FileStamp> _inputFiles;
+
+    // Name of the snapshot file, if any, and whether it was used.
+    std::string _snapshotFile;
+    bool _fromSnapshot;
+
     // If a parameter is repeated in the input file, one two things can happen:
     // true  - the latest value over writes the previous value.
     // false - it is defined to be an error so throw.
@@ -434,6 +458,33 @@ namespace mu2e {
      */
     void ReadFile();
 
+    /**
+     * Create the map to access records by parameter name from the image.
+     *
+     */
+    void makeMap();
+
+    /**
+     * Load the image from the snapshot file.  Returns false, leaving the
+     * object unchanged, if there is no usable snapshot.
+     *
+     * @return true if the image was loaded.
+     */
+    bool readSnapshot();
+
+    /**
+     * Write the image to the snapshot file.
+     *
+     */
+    void writeSnapshot() const;
+
+    /**
+     * The size and modification time of a file, for the snapshot validation.
+     *
+     * @return false if the file can not be found.
+     */
+    static bool stampFile( const std::string& requested, FileStamp& stamp );
+
     /**
      * Test to see if a record is complete.
      *
@@ -49,17 +49,28 @@ namespace mu2e {
   SimpleConfig::SimpleConfig( const string& filename,
                               bool allowReplacement,
                               bool messageOnReplacement,
-                              bool messageOnDefault):
+                              bool messageOnDefault,
+                              const string& snapshotFile):
     _inputFileString(filename),
     _inputFileHash(0),
     _inputFileLines(0),
+    _snapshotFile(snapshotFile),
+    _fromSnapshot(false),
     _allowReplacement(allowReplacement),
     _messageOnReplacement(messageOnReplacement),
     _messageOnDefault(messageOnDefault)     {
 
     ConfigFileLookupPolicy configFile;
     _inputfile = configFile(filename);
-    ReadFile();
+
+    if ( !_snapshotFile.empty() && readSnapshot() ){
+      _fromSnapshot = true;
+    } else {
+      ReadFile();
+      if ( !_snapshotFile.empty() ) writeSnapshot();
+    }
+
+    makeMap();
   }
 
   /**
@@ -563,6 +574,11 @@ namespace mu2e {
         << endl;
     }
 
+    FileStamp stamp;
+    if ( stampFile(_inputFileString, stamp) ){
+      _inputFiles.push_back(stamp);
+    }
+
     string line;
     while ( in ){
 
@@ -623,8 +639,13 @@ namespace mu2e {
       }
 
     }
+  }
 
-    // Form the map after the image has been made.
+  /**
+   * Form the map after the image has been made.
+   *
+   */
+  void SimpleConfig::makeMap(){
 
     // Loop over all records in the image.
     Image_type::const_iterator b0 = _image.begin();
@@ -799,6 +820,7 @@ namespace mu2e {
     // collect contribution to the hash
     boost::hash_combine<std::size_t>(_inputFileHash,nestedFile.inputFileHash());
     _inputFileLines += nestedFile.inputFileLines();
+    _inputFiles.insert(_inputFiles.end(),nestedFile._inputFiles.begin(),nestedFile._inputFiles.end());
 
     // Copy the contents of the included file into this one.
     for ( Image_type::const_iterator i=nestedFile._image.begin();
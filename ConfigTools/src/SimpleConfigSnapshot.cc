@@ -0,0 +1,197 @@
+//
+// Binary snapshot of the records of a SimpleConfig.
+//
+// Contact person Rob Kutschke
+//
+// The snapshot holds the image of the input file after all of the includes
+// have been expanded, the hash and line count of the input, and the name,
+// size and modification time of every file that was read.  It is used only
+// if every one of those files still resolves to the same path through
+// MU2E_SEARCH_PATH and is unchanged; otherwise the input is parsed again and
+// the snapshot is rewritten.  This skips the text parsing of the geometry
+// files, about 110 of them for the standard geometry, in every job.
+//
+// The snapshot is a cache: a snapshot that can not be read or written is
+// reported and otherwise ignored.
+//
+
+// C++ includes
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// System includes
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Framework includes
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// Mu2e includes
+#include "ConfigTools/inc/ConfigFileLookupPolicy.hh"
+#include "ConfigTools/inc/SimpleConfig.hh"
+#include "ConfigTools/src/SimpleConfigRecord.hh"
+
+using namespace std;
+
+namespace mu2e {
+
+  namespace {
+
+    const char     snapshotMagic[8] = {'M','U','2','E','S','C','F','G'};
+    const uint32_t snapshotVersion  = 1;
+
+    void writeValue( ostream& out, uint64_t v ){
+      out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+
+    void writeString( ostream& out, const string& s ){
+      writeValue(out, s.size());
+      out.write(s.data(), s.size());
+    }
+
+    bool readValue( istream& in, uint64_t& v ){
+      in.read(reinterpret_cast<char*>(&v), sizeof(v));
+      return bool(in);
+    }
+
+    bool readString( istream& in, string& s ){
+      uint64_t n(0);
+      if ( !readValue(in,n) ) return false;
+      s.resize(n);
+      in.read(&s[0], n);
+      return bool(in);
+    }
+
+  }
+
+  bool SimpleConfig::stampFile( const std::string& requested, FileStamp& stamp ){
+    ConfigFileLookupPolicy configFile;
+    try {
+      stamp.resolved = configFile(requested);
+    }
+    catch (...) {
+      return false;
+    }
+
+    struct stat st;
+    if ( ::stat(stamp.resolved.c_str(), &st) != 0 ) return false;
+
+    stamp.requested = requested;
+    stamp.size      = st.st_size;
+    stamp.mtime     = st.st_mtim.tv_sec*1000000000LL + st.st_mtim.tv_nsec;
+    return true;
+  }
+
+  bool SimpleConfig::readSnapshot(){
+
+    ifstream in(_snapshotFile.c_str(), ios::binary);
+    if ( !in ) return false;
+
+    char magic[sizeof(snapshotMagic)];
+    in.read(magic, sizeof(magic));
+    uint64_t version(0);
+    if ( !in || !equal(magic, magic+sizeof(magic), snapshotMagic) ||
+         !readValue(in,version) || version != snapshotVersion ){
+      mf::LogWarning("GEOM") << "SimpleConfig: " << _snapshotFile
+                             << " is not a valid snapshot, it will be rewritten\n";
+      return false;
+    }
+
+    // The snapshot must have been made from the same top level file ...
+    string requested, resolved;
+    uint64_t hash(0), lines(0), nFiles(0);
+    if ( !readString(in,requested) || !readString(in,resolved) ||
+         !readValue(in,hash) || !readValue(in,lines) || !readValue(in,nFiles) ){
+      return false;
+    }
+    if ( requested != _inputFileString || resolved != _inputfile ) {
+      mf::LogInfo("GEOM") << "SimpleConfig: snapshot " << _snapshotFile
+                          << " was made from " << resolved << ", not " << _inputfile << "\n";
+      return false;
+    }
+
+    // ... and none of the files that it was made from may have changed.
+    vector<FileStamp> files(nFiles);
+    for ( auto& f : files ){
+      uint64_t size(0), mtime(0);
+      if ( !readString(in,f.requested) || !readString(in,f.resolved) ||
+           !readValue(in,size) || !readValue(in,mtime) ){
+        return false;
+      }
+      f.size  = size;
+      f.mtime = mtime;
+
+      FileStamp now;
+      if ( !stampFile(f.requested, now) || now.resolved != f.resolved ||
+           now.size != f.size || now.mtime != f.mtime ){
+        mf::LogInfo("GEOM") << "SimpleConfig: snapshot " << _snapshotFile
+                            << " is out of date: " << f.resolved << " has changed\n";
+        return false;
+      }
+    }
+
+    uint64_t nRecords(0);
+    if ( !readValue(in,nRecords) ) return false;
+    Image_type image;
+    image.reserve(nRecords);
+    string record;
+    for ( uint64_t i=0; i<nRecords; ++i ){
+      if ( !readString(in,record) ) return false;
+      image.push_back(Record_sptr(new SimpleConfigRecord(record)));
+    }
+
+    _image.swap(image);
+    _inputFiles.swap(files);
+    _inputFileHash  = hash;
+    _inputFileLines = lines;
+    return true;
+  }
+
+  void SimpleConfig::writeSnapshot() const{
+
+    // Write to a temporary file and rename it, so that concurrent jobs
+    // never see a partial snapshot.
+    ostringstream tmpName;
+    tmpName << _snapshotFile << ".tmp." << ::getpid();
+
+    {
+      ofstream out(tmpName.str().c_str(), ios::binary | ios::trunc);
+      out.write(snapshotMagic, sizeof(snapshotMagic));
+      writeValue(out, snapshotVersion);
+      writeString(out, _inputFileString);
+      writeString(out, _inputfile);
+      writeValue(out, _inputFileHash);
+      writeValue(out, _inputFileLines);
+
+      writeValue(out, _inputFiles.size());
+      for ( auto const& f : _inputFiles ){
+        writeString(out, f.requested);
+        writeString(out, f.resolved);
+        writeValue(out, f.size);
+        writeValue(out, f.mtime);
+      }
+
+      writeValue(out, _image.size());
+      for ( auto const& r : _image ){
+        writeString(out, r->getRecord());
+      }
+
+      if ( !out ){
+        mf::LogWarning("GEOM") << "SimpleConfig: can not write snapshot " << _snapshotFile << "\n";
+        std::remove(tmpName.str().c_str());
+        return;
+      }
+    }
+
+    if ( std::rename(tmpName.str().c_str(), _snapshotFile.c_str()) != 0 ){
+      mf::LogWarning("GEOM") << "SimpleConfig: can not write snapshot " << _snapshotFile << "\n";
+      std::remove(tmpName.str().c_str());
+    }
+  }
+
+} // end namespace mu2e
@@ -17,7 +17,7 @@
 
 
 #include "CLHEP/Random/RandFlat.h"
-#include "CLHEP/Random/RandGeneral.h"
+#include "Mu2eUtilities/inc/RandAliasTable.hh"
 #include "Mu2eUtilities/inc/RandomUnitSphere.hh"
 
 namespace mu2e {
@@ -53,8 +53,8 @@ namespace mu2e {
     int _nbins;
     RandomUnitSphere _randomUnitSphere;
     CLHEP::RandFlat _randFlat;
-    CLHEP::RandGeneral _spectrum;
-    CLHEP::RandGeneral _internalFractionalSpectrum;
+    RandAliasTable _spectrum;
+    RandAliasTable _internalFractionalSpectrum;
 
     double _electMass;
 
@@ -0,0 +1,108 @@
+// Make the event weight of a job run with Mu2eG4Biasing: the common weight
+// of the SimParticles that made the StepPointMCs in the listed collections.
+// Events without any of these hits get the weight 1.
+//
+// An event weight only exists if all these SimParticles have the same weight.
+// With splitting, the hits of an event can come from several split copies
+// and roulette survivors with different weights; such an event has no single
+// weight and the module throws, unless allowMixedWeights is set, in which case
+// it writes the weight of the heaviest particle and counts the event.  Use the
+// hits with their own weights, step.simParticle()->weight(), for these.
+
+// C++ includes
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Framework includes
+#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "canvas/Utilities/InputTag.h"
+#include "cetlib_except/exception.h"
+
+// Mu2e includes
+#include "MCDataProducts/inc/EventWeight.hh"
+#include "MCDataProducts/inc/StepPointMCCollection.hh"
+#include "MCDataProducts/inc/SimParticle.hh"
+
+namespace mu2e {
+
+  //================================================================
+  class BiasingWeight : public art::EDProducer {
+
+    std::vector<art::InputTag> _stepPointsTags;
+    double _tolerance;
+    bool _allowMixedWeights;
+    int _verbosityLevel;
+    unsigned _nMixed;
+  public:
+    explicit BiasingWeight(const fhicl::ParameterSet& pset);
+    virtual void produce(art::Event& event) override;
+    virtual void endJob() override;
+  };
+
+  //================================================================
+  BiasingWeight::BiasingWeight(const fhicl::ParameterSet& pset) :
+    art::EDProducer{pset},
+    _stepPointsTags(pset.get<std::vector<art::InputTag>>("stepPointsTags")),
+    _tolerance(pset.get<double>("tolerance", 1.e-6)),  // relative
+    _allowMixedWeights(pset.get<bool>("allowMixedWeights", false)),
+    _verbosityLevel(pset.get<int>("verbosityLevel", 0)),
+    _nMixed(0)
+  {
+    produces<mu2e::EventWeight>();
+  }
+
+  //================================================================
+  void BiasingWeight::produce(art::Event& event) {
+
+    double wmin(0), wmax(0);
+    bool found(false);
+
+    for ( auto const& tag : _stepPointsTags ) {
+      auto const& steps = *event.getValidHandle<StepPointMCCollection>(tag);
+      for ( auto const& step : steps ) {
+        if ( !step.simParticle().isAvailable() ) continue;
+        double w = step.simParticle()->weight();
+        if ( !found ) {
+          wmin = wmax = w;
+          found = true;
+        }
+        wmin = std::min(wmin, w);
+        wmax = std::max(wmax, w);
+      }
+    }
+
+    double weight = found ? wmax : 1.0;
+    if ( found && wmax - wmin > _tolerance*wmax ) {
+      if ( !_allowMixedWeights ) {
+        throw cet::exception("BIASING")
+          << moduleDescription().moduleLabel() << ": event " << event.id()
+          << " has hits from SimParticles with weights from " << wmin << " to " << wmax
+          << ", there is no event weight\n";
+      }
+      ++_nMixed;
+    }
+
+    if ( _verbosityLevel > 0 ) {
+      std::cout << moduleDescription().moduleLabel() << ": event " << event.id()
+                << " weight " << weight << std::endl;
+    }
+
+    event.put(std::make_unique<EventWeight>(weight));
+  }
+
+  //================================================================
+  void BiasingWeight::endJob() {
+    if ( _nMixed > 0 ) {
+      std::cout << moduleDescription().moduleLabel() << ": " << _nMixed
+                << " events with hits of different weights" << std::endl;
+    }
+  }
+
+}
+
+DEFINE_ART_MODULE(mu2e::BiasingWeight);
@@ -14,7 +14,6 @@
 #include "CLHEP/Vector/ThreeVector.h"
 #include "CLHEP/Vector/LorentzVector.h"
 #include "CLHEP/Random/RandomEngine.h"
-#include "CLHEP/Random/RandGeneral.h"
 #include "CLHEP/Units/PhysicalConstants.h"
 
 // Framework includes
@@ -40,6 +39,7 @@
 #include "Mu2eUtilities/inc/PionCaptureSpectrum.hh"
 #include "Mu2eUtilities/inc/SimpleSpectrum.hh"
 #include "Mu2eUtilities/inc/BinnedSpectrum.hh"
+#include "Mu2eUtilities/inc/RandAliasTable.hh"
 #include "Mu2eUtilities/inc/Table.hh"
 #include "Mu2eUtilities/inc/RootTreeSampler.hh"
 #include "GeneralUtilities/inc/RSNTIO.hh"
@@ -74,7 +74,7 @@ namespace mu2e {
 
     art::RandomNumberGenerator::base_engine_t& eng_;
 
-    CLHEP::RandGeneral  randSpectrum_;
+    RandAliasTable      randSpectrum_;
     CLHEP::RandFlat     randomFlat_;
     RandomUnitSphere    randomUnitSphere_;
     PionCaptureSpectrum pionCaptureSpectrum_;
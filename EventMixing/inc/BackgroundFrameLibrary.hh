@@ -0,0 +1,114 @@
+// An in-memory pool of background frames, see MCDataProducts/inc/BackgroundFrame.hh.
+// The frames are read from ROOT trees written by MakeBackgroundFrameLibrary,
+// once, at construction, and are decoded into ready-to-copy SimParticles,
+// StepPointMCs, CaloShowerSteps and StrawGasSteps whose keys are relative to
+// the frame.  splice() samples frames
+// with replacement and appends them to the output collections: the only per
+// object work is adding the key offset of the frame and making the Ptrs into
+// the output SimParticleCollection, there is no per-event Ptr remapping.
+//
+// Only the step collections listed in stepInstances, caloShowerStepInstances
+// and strawGasStepInstances are kept.
+
+#ifndef EventMixing_inc_BackgroundFrameLibrary_hh
+#define EventMixing_inc_BackgroundFrameLibrary_hh
+
+#include <string>
+#include <vector>
+
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Sequence.h"
+
+#include "art/Framework/Services/Optional/RandomNumberGenerator.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
+
+#include "CLHEP/Random/RandFlat.h"
+
+#include "MCDataProducts/inc/BackgroundFrame.hh"
+#include "MCDataProducts/inc/SimParticleCollection.hh"
+#include "MCDataProducts/inc/StepPointMCCollection.hh"
+#include "MCDataProducts/inc/CaloShowerStepCollection.hh"
+
+namespace art { class EDProductGetter; }
+
+//================================================================
+namespace mu2e {
+
+  class BackgroundFrameLibrary {
+  public:
+
+    struct Config {
+      using Name=fhicl::Name;
+      using Comment=fhicl::Comment;
+
+      fhicl::Sequence<std::string> inputFiles { Name("inputFiles"),
+          Comment("List of the frame library files") };
+
+      fhicl::Atom<std::string> treeName { Name("treeName"),
+          Comment("Name of the ROOT tree holding the frames"), "makeFrames/frames" };
+
+      fhicl::Atom<std::string> branchName { Name("branchName"),
+          Comment("Name of the branch holding the frames"), "frame" };
+
+      fhicl::Sequence<std::string> stepInstances { Name("stepInstances"),
+          Comment("Instance names of the StepPointMC collections to mix") };
+
+      fhicl::Sequence<std::string> caloShowerStepInstances { Name("caloShowerStepInstances"),
+          Comment("Instance names of the CaloShowerStep collections to mix"), std::vector<std::string>() };
+
+      fhicl::Sequence<std::string> strawGasStepInstances { Name("strawGasStepInstances"),
+          Comment("Instance names of the StrawGasStep collections to mix"), std::vector<std::string>() };
+
+      fhicl::Atom<int> verbosityLevel { Name("verbosityLevel"),
+          Comment("A positive value generates more printouts than the default."), 0 };
+    };
+
+    BackgroundFrameLibrary(art::RandomNumberGenerator::base_engine_t& engine, const Config& conf);
+
+    const std::vector<std::string>& stepInstances() const { return stepInstances_; }
+    const std::vector<std::string>& caloShowerStepInstances() const { return caloInstances_; }
+    const std::vector<std::string>& strawGasStepInstances() const { return strawInstances_; }
+
+    size_t numFrames() const { return frames_.size(); }
+
+    // Append nFrames frames, drawn with replacement, to sims and to the step
+    // collections, which have one collection per entry of stepInstances(),
+    // caloShowerStepInstances() and strawGasStepInstances().  The Ptrs of the
+    // new objects point into the SimParticleCollection sims, of ProductID simsPID.
+    void splice(unsigned nFrames,
+                SimParticleCollection& sims,
+                art::ProductID const& simsPID,
+                art::EDProductGetter const* simsGetter,
+                std::vector<StepPointMCCollection>& steps,
+                std::vector<CaloShowerStepCollection>& caloSteps,
+                std::vector<StrawGasStepCollection>& strawSteps);
+
+  private:
+
+    // A decoded frame; the keys are relative to the frame.
+    struct Frame {
+      std::vector<SimParticle>           particles;  // null Ptrs
+      std::vector<long>                  parents;    // -1 for none
+      std::vector<std::vector<unsigned>> daughters;
+      unsigned                           keySpan = 0;
+
+      std::vector<StepPointMCCollection> steps;      // per stepInstances_, null Ptrs
+      std::vector<std::vector<unsigned>> stepKeys;
+
+      // per caloInstances_ and strawInstances_, null Ptrs
+      std::vector<BackgroundFrameSteps<CaloShowerStep>> caloSteps;
+      std::vector<BackgroundFrameSteps<StrawGasStep>>   strawSteps;
+    };
+
+    Frame decode(const BackgroundFrame& in) const;
+
+    CLHEP::RandFlat randFlat_;
+    std::vector<std::string> stepInstances_;
+    std::vector<std::string> caloInstances_;
+    std::vector<std::string> strawInstances_;
+    std::vector<Frame> frames_;
+  };
+
+}
+
+#endif/*EventMixing_inc_BackgroundFrameLibrary_hh*/
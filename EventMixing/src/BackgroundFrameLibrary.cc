@@ -0,0 +1,270 @@
+#include "EventMixing/inc/BackgroundFrameLibrary.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+#include "cetlib_except/exception.h"
+#include "canvas/Persistency/Common/Ptr.h"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+
+#include "ConfigTools/inc/ConfigFileLookupPolicy.hh"
+
+//================================================================
+namespace mu2e {
+
+  namespace {
+
+    // The collections of the frame in the order of instances, empty for
+    // an instance missing in the frame.
+    template <class STEP>
+    std::vector<BackgroundFrameSteps<STEP>> select(const std::vector<BackgroundFrameSteps<STEP>>& in,
+                                                   const std::vector<std::string>& instances) {
+      std::vector<BackgroundFrameSteps<STEP>> out(instances.size());
+      for(const auto& fs: in) {
+        auto ii = std::find(instances.begin(), instances.end(), fs.instance);
+        if(ii != instances.end()) {
+          out[ii - instances.begin()] = fs;
+        }
+      }
+      return out;
+    }
+
+    template <class STEP>
+    void append(const BackgroundFrameSteps<STEP>& fs, unsigned offset,
+                art::ProductID const& simsPID, art::EDProductGetter const* simsGetter,
+                std::vector<STEP>& out) {
+      for(unsigned i=0; i<fs.steps.size(); ++i) {
+        out.push_back(fs.steps[i]);
+        setSimParticle(out.back(), art::Ptr<SimParticle>(simsPID, fs.simKeys[i] + offset, simsGetter));
+      }
+    }
+
+  }
+
+  //----------------------------------------------------------------
+  BackgroundFrameLibrary::BackgroundFrameLibrary(art::RandomNumberGenerator::base_engine_t& engine,
+                                                 const Config& conf)
+    : randFlat_(engine)
+    , stepInstances_(conf.stepInstances())
+    , caloInstances_(conf.caloShowerStepInstances())
+    , strawInstances_(conf.strawGasStepInstances())
+  {
+    const auto inputFiles(conf.inputFiles());
+    if(inputFiles.empty()) {
+      throw cet::exception("BADCONFIG")<<"BackgroundFrameLibrary: no inputFiles\n";
+    }
+
+    for(const auto& fn : inputFiles) {
+      const std::string resolvedFileName = ConfigFileLookupPolicy()(fn);
+      std::unique_ptr<TFile> infile(TFile::Open(resolvedFileName.c_str(), "READ"));
+      if(!infile || infile->IsZombie()) {
+        throw cet::exception("BADINPUT")<<"BackgroundFrameLibrary: Could not open file \""
+                                        <<resolvedFileName<<"\"\n";
+      }
+
+      TTree *nt = dynamic_cast<TTree*>(infile->Get(conf.treeName().c_str()));
+      if(!nt) {
+        throw cet::exception("BADINPUT")<<"BackgroundFrameLibrary: Could not get tree \""<<conf.treeName()
+                                        <<"\" from file \""<<infile->GetName()
+                                        <<"\"\n";
+      }
+
+      TBranch *bb = nt->GetBranch(conf.branchName().c_str());
+      if(!bb) {
+        throw cet::exception("BADINPUT")<<"BackgroundFrameLibrary: Could not get branch \""<<conf.branchName()
+                                        <<"\" in tree \""<<conf.treeName()
+                                        <<"\" from file \""<<infile->GetName()
+                                        <<"\"\n";
+      }
+
+      BackgroundFrame frame;
+      BackgroundFrame *pframe = &frame;
+      bb->SetAddress(&pframe);
+
+      const Long64_t nentries = nt->GetEntries();
+      frames_.reserve(frames_.size() + nentries);
+      for(Long64_t i=0; i<nentries; ++i) {
+        bb->GetEntry(i);
+        frames_.emplace_back(decode(frame));
+      }
+      nt->ResetBranchAddresses();
+
+      if(conf.verbosityLevel() > 0) {
+        std::cout<<"BackgroundFrameLibrary: loaded "<<nentries<<" frames from "
+                 <<resolvedFileName<<std::endl;
+      }
+    }
+
+    if(frames_.empty()) {
+      throw cet::exception("BADINPUT")<<"BackgroundFrameLibrary: the input files have no frames\n";
+    }
+
+    if(conf.verbosityLevel() > 0) {
+      std::cout<<"BackgroundFrameLibrary: "<<frames_.size()<<" frames in the pool"<<std::endl;
+    }
+  }
+
+  //----------------------------------------------------------------
+  BackgroundFrameLibrary::Frame BackgroundFrameLibrary::decode(const BackgroundFrame& in) const {
+    Frame f;
+
+    f.particles.reserve(in.particles.size());
+    f.parents.reserve(in.particles.size());
+
+    unsigned key(0);
+    for(const auto& c: in.particles) {
+      key += c.idDelta;
+
+      f.particles.emplace_back(SimParticle::key_type(key),
+                               c.stageOffset,
+                               art::Ptr<SimParticle>(),
+                               static_cast<PDGCode::type>(c.pdgId),
+                               art::Ptr<GenParticle>(),
+                               CLHEP::Hep3Vector(c.startPosition[0], c.startPosition[1], c.startPosition[2]),
+                               CLHEP::HepLorentzVector(c.startMomentum[0], c.startMomentum[1], c.startMomentum[2], c.startMomentum[3]),
+                               c.startGlobalTime,
+                               c.startProperTime,
+                               c.startVolumeIndex,
+                               c.startG4Status,
+                               ProcessCode(static_cast<ProcessCode::enum_type>(c.creationCode)),
+                               c.weight);
+
+      if(c.endDefined) {
+        f.particles.back().addEndInfo(CLHEP::Hep3Vector(c.endPosition[0], c.endPosition[1], c.endPosition[2]),
+                                      CLHEP::HepLorentzVector(c.endMomentum[0], c.endMomentum[1], c.endMomentum[2], c.endMomentum[3]),
+                                      c.endGlobalTime,
+                                      c.endProperTime,
+                                      c.endVolumeIndex,
+                                      c.endG4Status,
+                                      ProcessCode(static_cast<ProcessCode::enum_type>(c.stoppingCode)),
+                                      c.endKE,
+                                      c.nSteps,
+                                      c.trackLength);
+      }
+
+      f.parents.push_back( (c.parentProduct == 0) ? long(key - c.parentKey) : -1L );
+    }
+    f.keySpan = in.particles.empty() ? 0 : key + 1;
+
+    // The daughters, by index of the particle in the frame.
+    f.daughters.resize(f.particles.size());
+    for(unsigned i=0; i<f.particles.size(); ++i) {
+      if(f.parents[i] < 0) continue;
+      auto p = std::lower_bound(f.particles.begin(), f.particles.end(), unsigned(f.parents[i]),
+                                [](const SimParticle& s, unsigned k){ return s.id().asUint() < k; });
+      if(p == f.particles.end() || p->id().asUint() != unsigned(f.parents[i])) {
+        throw cet::exception("BADINPUT")<<"BackgroundFrameLibrary: the parent "<<f.parents[i]
+                                        <<" of particle "<<f.particles[i].id()<<" is not in the frame\n";
+      }
+      f.daughters[p - f.particles.begin()].push_back(f.particles[i].id().asUint());
+    }
+
+    f.steps.resize(stepInstances_.size());
+    f.stepKeys.resize(stepInstances_.size());
+    for(unsigned i=0; i<in.stepInstances.size(); ++i) {
+      auto ii = std::find(stepInstances_.begin(), stepInstances_.end(), in.stepInstances[i]);
+      if(ii == stepInstances_.end()) continue;
+
+      const auto& cs = in.steps.at(i);
+      auto& steps = f.steps[ii - stepInstances_.begin()];
+      auto& keys = f.stepKeys[ii - stepInstances_.begin()];
+      steps.reserve(cs.size());
+      keys.reserve(cs.size());
+
+      unsigned skey(0);
+      for(const auto& c: cs.steps) {
+        skey += c.simKeyDelta;
+        steps.emplace_back(art::Ptr<SimParticle>(),
+                           c.volumeId,
+                           c.totalEDep,
+                           c.nonIonizingEDep,
+                           cs.t0 + c.timeTicks*cs.timeQuantum,
+                           c.properTime,
+                           CLHEP::Hep3Vector(cs.origin[0] + c.position[0],
+                                             cs.origin[1] + c.position[1],
+                                             cs.origin[2] + c.position[2]),
+                           CLHEP::Hep3Vector(c.momentum[0], c.momentum[1], c.momentum[2]),
+                           c.stepLength,
+                           ProcessCode(static_cast<ProcessCode::enum_type>(c.endProcessCode)));
+        keys.push_back(skey);
+      }
+    }
+
+    f.caloSteps = select(in.caloShowerSteps, caloInstances_);
+    f.strawSteps = select(in.strawGasSteps, strawInstances_);
+
+    return f;
+  }
+
+  //----------------------------------------------------------------
+  void BackgroundFrameLibrary::splice(unsigned nFrames,
+                                      SimParticleCollection& sims,
+                                      art::ProductID const& simsPID,
+                                      art::EDProductGetter const* simsGetter,
+                                      std::vector<StepPointMCCollection>& steps,
+                                      std::vector<CaloShowerStepCollection>& caloSteps,
+                                      std::vector<StrawGasStepCollection>& strawSteps)
+  {
+    if(steps.size() != stepInstances_.size() ||
+       caloSteps.size() != caloInstances_.size() ||
+       strawSteps.size() != strawInstances_.size()) {
+      throw cet::exception("BUG")<<"BackgroundFrameLibrary::splice(): the step collections do not match the instances\n";
+    }
+
+    std::vector<const Frame*> sample;
+    sample.reserve(nFrames);
+    for(unsigned i=0; i<nFrames; ++i) {
+      sample.push_back(&frames_[randFlat_.fireInt(frames_.size())]);
+    }
+
+    for(unsigned j=0; j<steps.size(); ++j) {
+      size_t n = steps[j].size();
+      for(const auto* f: sample) {
+        n += f->steps[j].size();
+      }
+      steps[j].reserve(n);
+    }
+
+    unsigned offset = sims.delta();
+    for(const auto* f: sample) {
+
+      for(unsigned i=0; i<f->particles.size(); ++i) {
+        const SimParticle::key_type key(f->particles[i].id().asUint() + offset);
+        SimParticle& sim = sims[key];
+        sim = f->particles[i];
+        sim.id() = key;
+        if(f->parents[i] >= 0) {
+          sim.parent() = art::Ptr<SimParticle>(simsPID, f->parents[i] + offset, simsGetter);
+        }
+        sim.daughters().reserve(f->daughters[i].size());
+        for(auto d: f->daughters[i]) {
+          sim.daughters().emplace_back(simsPID, d + offset, simsGetter);
+        }
+      }
+
+      for(unsigned j=0; j<steps.size(); ++j) {
+        const auto& fsteps = f->steps[j];
+        const auto& fkeys = f->stepKeys[j];
+        for(unsigned i=0; i<fsteps.size(); ++i) {
+          steps[j].push_back(fsteps[i]);
+          steps[j].back().simParticle() = art::Ptr<SimParticle>(simsPID, fkeys[i] + offset, simsGetter);
+        }
+      }
+
+      for(unsigned j=0; j<caloSteps.size(); ++j) {
+        append(f->caloSteps[j], offset, simsPID, simsGetter, caloSteps[j]);
+      }
+      for(unsigned j=0; j<strawSteps.size(); ++j) {
+        append(f->strawSteps[j], offset, simsPID, simsGetter, strawSteps[j]);
+      }
+
+      offset += f->keySpan;
+    }
+  }
+
+}
+//================================================================
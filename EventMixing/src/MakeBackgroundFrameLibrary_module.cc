@@ -0,0 +1,207 @@
+// Write a library of background frames for MixBackgroundFrameLibrary:
+// a ROOT tree with one BackgroundFrame per input event, made from the
+// compact SimParticles and StepPointMCs written by PackSimData, and from
+// the CaloShowerSteps and StrawGasSteps of the same event, which must point
+// into the SimParticleCollection that PackSimData packed.  The tree goes to
+// the TFileService file.
+//
+// Parents outside of the packed SimParticleCollection, and GenParticles,
+// are dropped, so that each frame is self-contained.  Events without any
+// step are skipped.
+
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "art_root_io/TFileService.h"
+#include "cetlib_except/exception.h"
+
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Sequence.h"
+#include "fhiclcpp/types/Tuple.h"
+#include "canvas/Utilities/InputTag.h"
+
+#include "TTree.h"
+
+#include "MCDataProducts/inc/BackgroundFrame.hh"
+#include "MCDataProducts/inc/CaloShowerStepCollection.hh"
+
+//================================================================
+namespace mu2e {
+
+  class MakeBackgroundFrameLibrary : public art::EDAnalyzer {
+  public:
+    struct Config {
+      using Name=fhicl::Name;
+      using Comment=fhicl::Comment;
+
+      fhicl::Atom<art::InputTag> simParticleTag { Name("simParticleTag"),
+          Comment("The CompactSimParticleCollection made by PackSimData.") };
+
+      fhicl::Sequence<art::InputTag> stepPointMCTags { Name("stepPointMCTags"),
+          Comment("The CompactStepPointMCCollections made by PackSimData.\n"
+                  "The instance names are kept in the frames.") };
+
+      fhicl::Sequence<fhicl::Tuple<art::InputTag, std::string> > caloShowerStepMap { Name("caloShowerStepMap"),
+          Comment("The CaloShowerStepCollections, as pairs [ \"InputTag\", \"instance name in the frames\" ]."),
+          std::vector<std::tuple<art::InputTag, std::string> >() };
+
+      fhicl::Sequence<fhicl::Tuple<art::InputTag, std::string> > strawGasStepMap { Name("strawGasStepMap"),
+          Comment("The StrawGasStepCollections, as pairs [ \"InputTag\", \"instance name in the frames\" ]."),
+          std::vector<std::tuple<art::InputTag, std::string> >() };
+
+      fhicl::Atom<std::string> treeName { Name("treeName"),
+          Comment("Name of the output tree"), "frames" };
+
+      fhicl::Atom<std::string> branchName { Name("branchName"),
+          Comment("Name of the branch holding the frames"), "frame" };
+    };
+
+    using Parameters = art::EDAnalyzer::Table<Config>;
+    explicit MakeBackgroundFrameLibrary(const Parameters& conf);
+
+    void analyze(const art::Event& event) override;
+    void endJob() override;
+
+  private:
+    template <class STEP>
+    bool addSteps(const art::Event& event, const art::InputTag& tag, const std::string& instance,
+                  const art::ProductID& sims, uint32_t firstKey,
+                  std::vector<BackgroundFrameSteps<STEP>>& out);
+
+    art::InputTag simParticleTag_;
+    std::vector<art::InputTag> stepPointMCTags_;
+    std::vector<std::tuple<art::InputTag, std::string> > caloShowerStepMap_;
+    std::vector<std::tuple<art::InputTag, std::string> > strawGasStepMap_;
+
+    TTree *tree_;
+    BackgroundFrame frame_;
+    BackgroundFrame *pframe_;
+
+    unsigned long long nFrames_;
+    unsigned long long nSkipped_;
+  };
+
+  //================================================================
+  MakeBackgroundFrameLibrary::MakeBackgroundFrameLibrary(const Parameters& conf)
+    : art::EDAnalyzer(conf)
+    , simParticleTag_(conf().simParticleTag())
+    , stepPointMCTags_(conf().stepPointMCTags())
+    , caloShowerStepMap_(conf().caloShowerStepMap())
+    , strawGasStepMap_(conf().strawGasStepMap())
+    , tree_(nullptr)
+    , pframe_(&frame_)
+    , nFrames_(0)
+    , nSkipped_(0)
+  {
+    art::ServiceHandle<art::TFileService> tfs;
+    tree_ = tfs->make<TTree>(conf().treeName().c_str(), "Background frames for event mixing");
+    tree_->Branch(conf().branchName().c_str(), &pframe_);
+  }
+
+  //================================================================
+  void MakeBackgroundFrameLibrary::analyze(const art::Event& event) {
+
+    auto const& sims = *event.getValidHandle<CompactSimParticleCollection>(simParticleTag_);
+
+    frame_ = BackgroundFrame();
+
+    // The index of the packed collection itself in the products table.
+    int16_t self(-1);
+    for(unsigned i=0; i<sims.products.size(); ++i) {
+      if(sims.products[i] == sims.self) {
+        self = i;
+      }
+    }
+
+    // Make the keys relative to the first particle.
+    uint32_t firstKey = sims.empty() ? 0 : sims.particles.front().idDelta;
+
+    frame_.particles = sims.particles;
+    for(auto& p: frame_.particles) {
+      if(p.parentProduct >= 0) {
+        p.parentProduct = (p.parentProduct == self) ? 0 : -1;
+        if(p.parentProduct < 0) {
+          p.parentKey = 0;
+        }
+      }
+      p.genProduct = -1;
+      p.genKey = 0;
+    }
+    if(!frame_.particles.empty()) {
+      frame_.particles.front().idDelta = 0;
+    }
+
+    bool hasSteps(false);
+    for(const auto& tag: stepPointMCTags_) {
+      auto const& steps = *event.getValidHandle<CompactStepPointMCCollection>(tag);
+      if(!steps.empty() && steps.simParticles != sims.self) {
+        throw cet::exception("DATA")<<"MakeBackgroundFrameLibrary: the steps of "<<tag
+                                    <<" do not point into the SimParticles of "<<simParticleTag_<<"\n";
+      }
+      frame_.stepInstances.push_back(tag.instance());
+      frame_.steps.push_back(steps);
+      if(!steps.empty()) {
+        frame_.steps.back().steps.front().simKeyDelta -= firstKey;
+        frame_.steps.back().simParticles = art::ProductID();
+        hasSteps = true;
+      }
+    }
+
+    for(const auto& m: caloShowerStepMap_) {
+      hasSteps |= addSteps(event, std::get<0>(m), std::get<1>(m), sims.self, firstKey, frame_.caloShowerSteps);
+    }
+    for(const auto& m: strawGasStepMap_) {
+      hasSteps |= addSteps(event, std::get<0>(m), std::get<1>(m), sims.self, firstKey, frame_.strawGasSteps);
+    }
+
+    if(!hasSteps) {
+      ++nSkipped_;
+      return;
+    }
+
+    tree_->Fill();
+    ++nFrames_;
+  }
+
+  //================================================================
+  template <class STEP>
+  bool MakeBackgroundFrameLibrary::addSteps(const art::Event& event, const art::InputTag& tag, const std::string& instance,
+                                            const art::ProductID& sims, uint32_t firstKey,
+                                            std::vector<BackgroundFrameSteps<STEP>>& out)
+  {
+    auto const& steps = *event.getValidHandle<std::vector<STEP>>(tag);
+
+    out.emplace_back();
+    auto& fs = out.back();
+    fs.instance = instance;
+    fs.steps.reserve(steps.size());
+    fs.simKeys.reserve(steps.size());
+    for(const auto& step: steps) {
+      if(step.simParticle().id() != sims) {
+        throw cet::exception("DATA")<<"MakeBackgroundFrameLibrary: the steps of "<<tag
+                                    <<" do not point into the SimParticles of "<<simParticleTag_<<"\n";
+      }
+      fs.simKeys.push_back(step.simParticle().key() - firstKey);
+      fs.steps.push_back(step);
+      setSimParticle(fs.steps.back(), art::Ptr<SimParticle>());
+    }
+
+    return !steps.empty();
+  }
+
+  //================================================================
+  void MakeBackgroundFrameLibrary::endJob() {
+    std::cout<<"MakeBackgroundFrameLibrary: wrote "<<nFrames_<<" frames, skipped "
+             <<nSkipped_<<" events without steps"<<std::endl;
+  }
+
+  //================================================================
+} // namespace mu2e
+
+DEFINE_ART_MODULE(mu2e::MakeBackgroundFrameLibrary);
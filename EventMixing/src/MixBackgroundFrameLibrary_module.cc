@@ -0,0 +1,130 @@
+// This module makes "background frames" like MixBackgroundFrames, but
+// samples them, with replacement, from an in-memory pool of pre-flattened
+// frames, see EventMixing/inc/BackgroundFrameLibrary.hh, instead of reading
+// the secondary events through art::MixFilter.  The frames are spliced into
+// new SimParticle, StepPointMC, CaloShowerStep and StrawGasStep collections
+// by offsetting their keys in bulk, without per-event Ptr remapping.  All the
+// steps of a frame come from the same background event, so the module replaces
+// MixBackgroundFrames for the collections in the library; GenParticles and
+// MCTrajectories are not mixed.
+//
+// The number of frames is Poisson distributed with the mean
+// meanEventsPerProton times the intensity of the input ProtonBunchIntensity.
+// The output collections carry no time offsets: run a GenerateProtonTimes
+// module on the output SimParticles, as for any other G4 output.
+//
+// The output step collections take the instance names of the library.
+
+#include <iostream>
+#include <memory>
+#include <random>
+
+#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "art/Framework/Services/Optional/RandomNumberGenerator.h"
+
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Table.h"
+#include "canvas/Utilities/InputTag.h"
+
+#include "EventMixing/inc/BackgroundFrameLibrary.hh"
+#include "Mu2eUtilities/inc/artURBG.hh"
+#include "SeedService/inc/SeedService.hh"
+#include "MCDataProducts/inc/ProtonBunchIntensity.hh"
+
+//================================================================
+namespace mu2e {
+
+  class MixBackgroundFrameLibrary : public art::EDProducer {
+  public:
+    struct Config {
+      using Name=fhicl::Name;
+      using Comment=fhicl::Comment;
+
+      fhicl::Table<BackgroundFrameLibrary::Config> library { Name("library"),
+          Comment("The background frame library") };
+
+      fhicl::Atom<art::InputTag> protonBunchIntensityTag { Name("protonBunchIntensityTag"),
+          Comment("InputTag of a ProtonBunchIntensity product representing beam fluctuations.") };
+
+      fhicl::Atom<double> meanEventsPerProton { Name("meanEventsPerProton"),
+          Comment("The mean number of frames to mix per proton on target.") };
+
+      fhicl::Atom<int> debugLevel { Name("debugLevel"),
+          Comment("control the level of debug output"), 0 };
+    };
+
+    using Parameters = art::EDProducer::Table<Config>;
+    explicit MixBackgroundFrameLibrary(const Parameters& conf);
+
+    void produce(art::Event& event) override;
+
+  private:
+    art::RandomNumberGenerator::base_engine_t& engine_;
+    artURBG urbg_;
+    BackgroundFrameLibrary library_;
+    art::InputTag pbiTag_;
+    const double meanEventsPerProton_;
+    const int debugLevel_;
+  };
+
+  //================================================================
+  MixBackgroundFrameLibrary::MixBackgroundFrameLibrary(const Parameters& conf)
+    : art::EDProducer{conf}
+    , engine_{createEngine(art::ServiceHandle<SeedService>()->getSeed())}
+    , urbg_{ engine_ }
+    , library_{ engine_, conf().library() }
+    , pbiTag_{ conf().protonBunchIntensityTag() }
+    , meanEventsPerProton_{ conf().meanEventsPerProton() }
+    , debugLevel_{ conf().debugLevel() }
+  {
+    produces<SimParticleCollection>();
+    for(const auto& instance: library_.stepInstances()) {
+      produces<StepPointMCCollection>(instance);
+    }
+    for(const auto& instance: library_.caloShowerStepInstances()) {
+      produces<CaloShowerStepCollection>(instance);
+    }
+    for(const auto& instance: library_.strawGasStepInstances()) {
+      produces<StrawGasStepCollection>(instance);
+    }
+  }
+
+  //================================================================
+  void MixBackgroundFrameLibrary::produce(art::Event& event) {
+    const auto& pbi = *event.getValidHandle<ProtonBunchIntensity>(pbiTag_);
+
+    std::poisson_distribution<unsigned> poisson(meanEventsPerProton_ * pbi.intensity());
+    const unsigned nFrames = poisson(urbg_);
+
+    auto sims = std::make_unique<SimParticleCollection>();
+    const art::ProductID simsPID = event.getProductID<SimParticleCollection>();
+    std::vector<StepPointMCCollection> steps(library_.stepInstances().size());
+    std::vector<CaloShowerStepCollection> caloSteps(library_.caloShowerStepInstances().size());
+    std::vector<StrawGasStepCollection> strawSteps(library_.strawGasStepInstances().size());
+
+    library_.splice(nFrames, *sims, simsPID, event.productGetter(simsPID), steps, caloSteps, strawSteps);
+
+    if(debugLevel_ > 0) {
+      std::cout<<"MixBackgroundFrameLibrary: intensity = "<<pbi.intensity()
+               <<", mixed "<<nFrames<<" frames, "<<sims->size()<<" SimParticles"<<std::endl;
+    }
+
+    event.put(std::move(sims));
+    for(unsigned i=0; i<steps.size(); ++i) {
+      event.put(std::make_unique<StepPointMCCollection>(std::move(steps[i])), library_.stepInstances()[i]);
+    }
+    for(unsigned i=0; i<caloSteps.size(); ++i) {
+      event.put(std::make_unique<CaloShowerStepCollection>(std::move(caloSteps[i])), library_.caloShowerStepInstances()[i]);
+    }
+    for(unsigned i=0; i<strawSteps.size(); ++i) {
+      event.put(std::make_unique<StrawGasStepCollection>(std::move(strawSteps[i])), library_.strawGasStepInstances()[i]);
+    }
+  }
+
+  //================================================================
+}
+
+DEFINE_ART_MODULE(mu2e::MixBackgroundFrameLibrary);
@@ -22,21 +22,17 @@ namespace mu2e {
   //----------------------------------------------------------------
   namespace {
 
-    // newEntryIndex is an address in the output (flattened)
-    // collection and the offsets are those that were recorded by the
-    // flattenCollections() call
-    template<typename IndexType, typename OFFSETS>
-    typename OFFSETS::size_type
-    getInputEventIndex(IndexType newEntryIndex, const OFFSETS& offsets) {
-      auto ub = std::upper_bound(offsets.begin(), offsets.end(), newEntryIndex);
-      if(ub == offsets.begin()) {
-        throw cet::exception("RANGE")<<"getInputEventIndex(): newEntryIndex="
-                                     <<newEntryIndex
-                                     <<" is below the first offset="
-                                     <<*offsets.begin()
-                                     <<std::endl;
+    // The entries of a flattened output collection come in contiguous
+    // ranges, one per input event, that start at the offsets recorded by
+    // the flattenCollections() call.  Call f(ie, first, last) for the
+    // range [first,last) of the output indices from input event ie, so
+    // that the per-event offsets are looked up once per range.
+    template<typename OFFSETS, typename F>
+    void forEachInputRange(const OFFSETS& offsets, typename OFFSETS::value_type outSize, F f) {
+      for(typename OFFSETS::size_type ie = 0; ie < offsets.size(); ++ie) {
+        const auto last = (ie + 1 < offsets.size()) ? offsets[ie + 1] : outSize;
+        f(ie, offsets[ie], last);
       }
-      return std::distance(offsets.begin(), --ub);
     }
   }
 
@@ -111,12 +107,14 @@ namespace mu2e {
   {
     art::flattenCollections(in, out, simOffsets_ );
 
-    // Update the Ptrs inside each SimParticle
-    for(auto& entry: out) {
-      auto key = entry.first;
-      auto& particle = entry.second;
-      auto ie = getInputEventIndex(key.asUint(), simOffsets_);
-      updateSimParticle(particle, ie, remap);
+    // Update the Ptrs inside each SimParticle.  The output holds the
+    // particles of the input events in order, so walk it one input at a time.
+    auto it = out.begin();
+    for(SPOffsets::size_type ie = 0; ie < in.size(); ++ie) {
+      if(in[ie] == nullptr) continue;
+      for(auto n = in[ie]->size(); n > 0; --n, ++it) {
+        updateSimParticle(it->second, ie, remap);
+      }
     }
     return true;
   }
@@ -158,11 +156,12 @@ namespace mu2e {
     std::vector<StepPointMCCollection::size_type> stepOffsets;
     art::flattenCollections(in, out, stepOffsets);
 
-    for(StepPointMCCollection::size_type i=0; i<out.size(); ++i) {
-      auto ie = getInputEventIndex(i, stepOffsets);
-      auto& step = out[i];
-      step.simParticle() = remap(step.simParticle(), simOffsets_[ie]);
-    }
+    forEachInputRange(stepOffsets, out.size(), [&](auto ie, auto first, auto last) {
+        const auto simOffset = simOffsets_[ie];
+        for(auto i = first; i < last; ++i) {
+          out[i].simParticle() = remap(out[i].simParticle(), simOffset);
+        }
+      });
 
     return true;
   }
@@ -174,16 +173,20 @@ namespace mu2e {
   {
     // flattenCollections() does not seem to preserve enough info to remap ptrs in the output map.
     // Follow the pattern, including the nullptr checks, but add custom remapping code.
+    //
+    // The remapped keys grow with the input event index, and within an input
+    // they are in map order, so every entry is inserted with the end() hint.
 
     for(std::vector<MCTrajectoryCollection const*>::size_type ieIndex = 0; ieIndex < in.size(); ++ieIndex) {
       if (in[ieIndex] != nullptr) {
+        const auto simOffset = simOffsets_[ieIndex];
         for(const auto & orig : *in[ieIndex]) {
-          auto res = out.insert(std::make_pair(remap(orig.first, simOffsets_[ieIndex]),
-                                               MCTrajectory(remap(orig.second.sim(), simOffsets_[ieIndex]),
-                                                            orig.second.points())
-                                               ));
+          const auto oldSize = out.size();
+          out.emplace_hint(out.end(),
+                           remap(orig.first, simOffset),
+                           MCTrajectory(remap(orig.second.sim(), simOffset), orig.second.points()));
 
-          if(!res.second) {
+          if(out.size() == oldSize) {
             throw cet::exception("BUG")<<"mixMCTrajectories(): failed to insert an entry, ieIndex="<<ieIndex
                                        <<", orig ptr = "<<orig.first
                                        <<std::endl;
@@ -203,11 +206,12 @@ namespace mu2e {
     std::vector<CaloShowerStepCollection::size_type> stepOffsets;
     art::flattenCollections(in, out, stepOffsets);
 
-    for(CaloShowerStepCollection::size_type i=0; i<out.size(); ++i) {
-      auto ie = getInputEventIndex(i, stepOffsets);
-      auto& step = out[i];
-      step.setSimParticle( remap(step.simParticle(), simOffsets_[ie]) );
-    }
+    forEachInputRange(stepOffsets, out.size(), [&](auto ie, auto first, auto last) {
+        const auto simOffset = simOffsets_[ie];
+        for(auto i = first; i < last; ++i) {
+          out[i].setSimParticle( remap(out[i].simParticle(), simOffset) );
+        }
+      });
 
     return true;
   }
@@ -220,11 +224,12 @@ namespace mu2e {
     std::vector<StrawGasStepCollection::size_type> stepOffsets;
     art::flattenCollections(in, out, stepOffsets);
 
-    for(StrawGasStepCollection::size_type i=0; i<out.size(); ++i) {
-      auto ie = getInputEventIndex(i, stepOffsets);
-      auto& step = out[i];
-      step.simParticle() = remap(step.simParticle(), simOffsets_[ie]);
-    }
+    forEachInputRange(stepOffsets, out.size(), [&](auto ie, auto first, auto last) {
+        const auto simOffset = simOffsets_[ie];
+        for(auto i = first; i < last; ++i) {
+          out[i].simParticle() = remap(out[i].simParticle(), simOffset);
+        }
+      });
 
     return true;
   }
@@ -237,11 +242,12 @@ namespace mu2e {
     std::vector<ExtMonFNALSimHitCollection::size_type> stepOffsets;
     art::flattenCollections(in, out, stepOffsets);
 
-    for(ExtMonFNALSimHitCollection::size_type i=0; i<out.size(); ++i) {
-      auto ie = getInputEventIndex(i, stepOffsets);
-      auto& step = out[i];
-      step.setSimParticle( remap(step.simParticle(), simOffsets_[ie]) );
-    }
+    forEachInputRange(stepOffsets, out.size(), [&](auto ie, auto first, auto last) {
+        const auto simOffset = simOffsets_[ie];
+        for(auto i = first; i < last; ++i) {
+          out[i].setSimParticle( remap(out[i].simParticle(), simOffset) );
+        }
+      });
 
     return true;
   }
@@ -262,12 +268,12 @@ namespace mu2e {
                                           SimParticleTimeMap& out,
                                           art::PtrRemapper const& remap)
   {
+    // As for the MCTrajectories, the remapped Ptrs come in map order.
     for(size_t incount = 0; incount < in.size(); ++incount) {
       auto const& timemap = *in[incount];
-      //std::cout << "Mixing time map " << incount << " size " << timemap.size() << std::endl;
+      const auto simOffset = simOffsets_[incount];
       for(auto & imap : timemap) {
-        auto newptr = remap(imap.first, simOffsets_[incount]);
-        out[newptr] = imap.second;
+        out.emplace_hint(out.end(), remap(imap.first, simOffset), imap.second);
         // do I need to go down the chain?  I think not
       }
     }
@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////
+// Class:       PackSimData
+// Plugin Type: producer
+// File:        PackSimData_module.cc
+//
+// Converts a SimParticleCollection and a set of StepPointMCCollections
+// into their compact on-disk representations, CompactSimParticleCollection
+// and CompactStepPointMCCollection, for the output of the intermediate
+// stages of the simulation.  UnpackSimData restores them on read.
+//
+// The compact collections take the instance names of the input
+// StepPointMCCollections; the SimParticles have no instance name.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "canvas/Utilities/InputTag.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/ParameterSet.h"
+
+#include "MCDataProducts/inc/SimParticleCollection.hh"
+#include "MCDataProducts/inc/StepPointMCCollection.hh"
+#include "MCDataProducts/inc/CompactSimParticle.hh"
+#include "MCDataProducts/inc/CompactStepPointMC.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mu2e {
+
+  class PackSimData : public art::EDProducer {
+  public:
+    explicit PackSimData(fhicl::ParameterSet const& pset);
+
+    void produce(art::Event& event) override;
+    void endJob() override;
+
+  private:
+
+    // The index of pid in the products table, adding it if needed.
+    static int16_t productIndex(std::vector<art::ProductID>& products, art::ProductID const& pid);
+
+    std::unique_ptr<CompactSimParticleCollection> packSimParticles(art::ValidHandle<SimParticleCollection> const& sims) const;
+    std::unique_ptr<CompactStepPointMCCollection> packSteps(StepPointMCCollection const& steps) const;
+
+    art::InputTag              _simParticleTag;
+    std::vector<art::InputTag> _stepPointMCTags;
+    double                     _timeQuantum;
+    int                        _diagLevel;
+
+    unsigned long long _nSims;
+    unsigned long long _nSteps;
+  };
+
+  PackSimData::PackSimData(fhicl::ParameterSet const& pset):
+    art::EDProducer{pset},
+    _simParticleTag(pset.get<art::InputTag>("simParticleTag")),
+    _stepPointMCTags(pset.get<std::vector<art::InputTag>>("stepPointMCTags")),
+    _timeQuantum(pset.get<double>("timeQuantum", 0.001)), // ns
+    _diagLevel(pset.get<int>("diagLevel", 0)),
+    _nSims(0), _nSteps(0)
+  {
+    if ( !(_timeQuantum > 0.) ) {
+      throw cet::exception("CONFIG") << "PackSimData: timeQuantum must be positive, it is " << _timeQuantum << "\n";
+    }
+    produces<CompactSimParticleCollection>();
+    for ( auto const& tag : _stepPointMCTags ) {
+      produces<CompactStepPointMCCollection>(tag.instance());
+    }
+  }
+
+  void PackSimData::produce(art::Event& event) {
+
+    auto sims = event.getValidHandle<SimParticleCollection>(_simParticleTag);
+    event.put(packSimParticles(sims));
+    _nSims += sims->size();
+
+    for ( auto const& tag : _stepPointMCTags ) {
+      auto steps = event.getValidHandle<StepPointMCCollection>(tag);
+      auto packed = packSteps(*steps);
+      if ( !packed->empty() && packed->simParticles != sims.id() ) {
+        throw cet::exception("DATA") << "PackSimData: the StepPointMCs of " << tag
+                                     << " do not point into the SimParticles of " << _simParticleTag << "\n";
+      }
+      _nSteps += steps->size();
+      event.put(std::move(packed), tag.instance());
+    }
+  }
+
+  int16_t PackSimData::productIndex(std::vector<art::ProductID>& products, art::ProductID const& pid) {
+    auto i = std::find(products.begin(), products.end(), pid);
+    if ( i == products.end() ) {
+      i = products.insert(products.end(), pid);
+    }
+    return static_cast<int16_t>(i - products.begin());
+  }
+
+  std::unique_ptr<CompactSimParticleCollection> PackSimData::packSimParticles(art::ValidHandle<SimParticleCollection> const& sims) const {
+
+    auto out = std::make_unique<CompactSimParticleCollection>();
+    out->self = sims.id();
+    out->particles.reserve(sims->size());
+
+    // The map_vector is ordered by key, so the differences are never negative.
+    cet::map_vector_key::value_type previous(0);
+    for ( auto const& i : *sims ) {
+      SimParticle const& sim = i.second;
+      auto const id = sim.id().asUint();
+
+      CompactSimParticle c;
+      c.idDelta     = id - previous;
+      c.stageOffset = sim.stageOffset();
+      c.pdgId       = sim.pdgId();
+      previous      = id;
+
+      if ( sim.parent().isNonnull() ) {
+        c.parentProduct = productIndex(out->products, sim.parent().id());
+        c.parentKey     = ( sim.parent().id() == out->self ) ? id - sim.parent().key() : sim.parent().key();
+      }
+      if ( sim.genParticle().isNonnull() ) {
+        c.genProduct = productIndex(out->products, sim.genParticle().id());
+        c.genKey     = sim.genParticle().key();
+      }
+
+      for ( int j=0; j<3; ++j ) {
+        c.startPosition[j] = sim.startPosition()[j];
+        c.endPosition[j]   = sim.endPosition()[j];
+      }
+      for ( int j=0; j<4; ++j ) {
+        c.startMomentum[j] = sim.startMomentum()[j];
+        c.endMomentum[j]   = sim.endMomentum()[j];
+      }
+      c.startGlobalTime  = sim.startGlobalTime();
+      c.startProperTime  = sim.startProperTime();
+      c.startVolumeIndex = sim.startVolumeIndex();
+      c.startG4Status    = sim.startG4Status();
+      c.creationCode     = sim.creationCode().id();
+
+      c.endGlobalTime    = sim.endGlobalTime();
+      c.endProperTime    = sim.endProperTime();
+      c.endVolumeIndex   = sim.endVolumeIndex();
+      c.endG4Status      = sim.endG4Status();
+      c.stoppingCode     = sim.stoppingCode().id();
+      c.endKE            = sim.endKineticEnergy();
+      c.nSteps           = sim.nSteps();
+      c.trackLength      = sim.trackLength();
+      c.endDefined       = sim.endDefined();
+      c.weight           = sim.weight();
+
+      out->particles.push_back(c);
+    }
+
+    return out;
+  }
+
+  std::unique_ptr<CompactStepPointMCCollection> PackSimData::packSteps(StepPointMCCollection const& steps) const {
+
+    auto out = std::make_unique<CompactStepPointMCCollection>();
+    if ( steps.empty() ) return out;
+
+    out->simParticles = steps.front().simParticle().id();
+    for ( int j=0; j<3; ++j ) {
+      out->origin[j] = steps.front().position()[j];
+    }
+
+    // Coarsen the time quantum if the time span would overflow the ticks.
+    auto tminmax = std::minmax_element(steps.begin(), steps.end(),
+                                       [](StepPointMC const& a, StepPointMC const& b){ return a.time() < b.time(); });
+    out->t0 = tminmax.first->time();
+    double const span = tminmax.second->time() - out->t0;
+    double const maxTicks = std::numeric_limits<uint32_t>::max();
+    out->timeQuantum = std::max(_timeQuantum, span/maxTicks);
+
+    if ( _diagLevel > 0 && out->timeQuantum > _timeQuantum ) {
+      std::cout << moduleDescription().moduleLabel() << ": time quantum raised to "
+                << out->timeQuantum << " ns for a time span of " << span << " ns" << std::endl;
+    }
+
+    out->steps.reserve(steps.size());
+    cet::map_vector_key::value_type previous(0);
+    for ( auto const& step : steps ) {
+      if ( step.simParticle().id() != out->simParticles ) {
+        throw cet::exception("DATA") << "PackSimData: StepPointMCs of one collection point into more than one SimParticleCollection\n";
+      }
+
+      auto const key = step.simParticle().key();
+
+      CompactStepPointMC c;
+      c.simKeyDelta     = static_cast<int32_t>(key - previous);
+      c.volumeId        = step.volumeId();
+      c.timeTicks       = static_cast<uint32_t>(std::min(maxTicks, std::round((step.time()-out->t0)/out->timeQuantum)));
+      c.properTime      = step.properTime();
+      c.totalEDep       = step.totalEDep();
+      c.nonIonizingEDep = step.nonIonizingEDep();
+      c.stepLength      = step.stepLength();
+      for ( int j=0; j<3; ++j ) {
+        c.position[j] = step.position()[j] - out->origin[j];
+        c.momentum[j] = step.momentum()[j];
+      }
+      c.endProcessCode  = step.endProcessCode().id();
+      previous = key;
+
+      out->steps.push_back(c);
+    }
+
+    return out;
+  }
+
+  void PackSimData::endJob() {
+    std::cout << "PackSimData " << moduleDescription().moduleLabel() << ": packed "
+              << _nSims << " SimParticles and " << _nSteps << " StepPointMCs" << std::endl;
+  }
+
+} // end namespace mu2e
+
+DEFINE_ART_MODULE(mu2e::PackSimData);
@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////
+// Class:       UnpackSimData
+// Plugin Type: producer
+// File:        UnpackSimData_module.cc
+//
+// Restores the SimParticleCollection and the StepPointMCCollections
+// written in compact form by PackSimData.  The StepPointMCs and the
+// parents that pointed into the packed SimParticleCollection point
+// into the unpacked one; the daughters are derived from the parents.
+//
+// The StepPointMCCollections take the instance names of the compact
+// collections, so that downstream modules only need their module label
+// changed to the label of this module.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "canvas/Utilities/InputTag.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/ParameterSet.h"
+
+#include "MCDataProducts/inc/SimParticleCollection.hh"
+#include "MCDataProducts/inc/StepPointMCCollection.hh"
+#include "MCDataProducts/inc/CompactSimParticle.hh"
+#include "MCDataProducts/inc/CompactStepPointMC.hh"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mu2e {
+
+  class UnpackSimData : public art::EDProducer {
+  public:
+    explicit UnpackSimData(fhicl::ParameterSet const& pset);
+
+    void produce(art::Event& event) override;
+
+  private:
+
+    art::InputTag              _simParticleTag;
+    std::vector<art::InputTag> _stepPointMCTags;
+  };
+
+  UnpackSimData::UnpackSimData(fhicl::ParameterSet const& pset):
+    art::EDProducer{pset},
+    _simParticleTag(pset.get<art::InputTag>("simParticleTag")),
+    _stepPointMCTags(pset.get<std::vector<art::InputTag>>("stepPointMCTags"))
+  {
+    produces<SimParticleCollection>();
+    for ( auto const& tag : _stepPointMCTags ) {
+      produces<StepPointMCCollection>(tag.instance());
+    }
+  }
+
+  void UnpackSimData::produce(art::Event& event) {
+
+    auto const& packed = *event.getValidHandle<CompactSimParticleCollection>(_simParticleTag);
+
+    art::ProductID const simsPID(event.getProductID<SimParticleCollection>());
+    art::EDProductGetter const* simsGetter(event.productGetter(simsPID));
+
+    // Ptrs into the packed collection are redirected to the unpacked one.
+    auto makePtr = [&](int16_t product, cet::map_vector_key::value_type key, bool relative,
+                       cet::map_vector_key::value_type id) {
+      art::ProductID const& pid = packed.products.at(product);
+      if ( pid == packed.self ) {
+        return art::Ptr<SimParticle>(simsPID, relative ? id - key : key, simsGetter);
+      }
+      return art::Ptr<SimParticle>(pid, key, event.productGetter(pid));
+    };
+
+    auto sims = std::make_unique<SimParticleCollection>();
+    cet::map_vector_key::value_type id(0);
+    for ( auto const& c : packed.particles ) {
+      id += c.idDelta;
+
+      art::Ptr<SimParticle> parent;
+      if ( c.parentProduct >= 0 ) {
+        parent = makePtr(c.parentProduct, c.parentKey, true, id);
+      }
+      art::Ptr<GenParticle> gen;
+      if ( c.genProduct >= 0 ) {
+        art::ProductID const& pid = packed.products.at(c.genProduct);
+        gen = art::Ptr<GenParticle>(pid, c.genKey, event.productGetter(pid));
+      }
+
+      SimParticle sim(cet::map_vector_key(id),
+                      c.stageOffset,
+                      parent,
+                      static_cast<PDGCode::type>(c.pdgId),
+                      gen,
+                      CLHEP::Hep3Vector(c.startPosition[0], c.startPosition[1], c.startPosition[2]),
+                      CLHEP::HepLorentzVector(c.startMomentum[0], c.startMomentum[1], c.startMomentum[2], c.startMomentum[3]),
+                      c.startGlobalTime,
+                      c.startProperTime,
+                      c.startVolumeIndex,
+                      c.startG4Status,
+                      ProcessCode(static_cast<ProcessCode::enum_type>(c.creationCode)),
+                      c.weight);
+
+      if ( c.endDefined ) {
+        sim.addEndInfo(CLHEP::Hep3Vector(c.endPosition[0], c.endPosition[1], c.endPosition[2]),
+                       CLHEP::HepLorentzVector(c.endMomentum[0], c.endMomentum[1], c.endMomentum[2], c.endMomentum[3]),
+                       c.endGlobalTime,
+                       c.endProperTime,
+                       c.endVolumeIndex,
+                       c.endG4Status,
+                       ProcessCode(static_cast<ProcessCode::enum_type>(c.stoppingCode)),
+                       c.endKE,
+                       c.nSteps,
+                       c.trackLength);
+      }
+
+      (*sims)[cet::map_vector_key(id)] = sim;
+    }
+
+    // Derive the daughters; the particles are visited in key order, which
+    // is the order in which Mu2eG4 adds the daughters to their parent.
+    for ( auto& i : *sims ) {
+      auto const& parent = i.second.parent();
+      if ( parent.isNonnull() && parent.id() == simsPID ) {
+        auto p = sims->find(cet::map_vector_key(parent.key()));
+        if ( p == sims->end() ) {
+          throw cet::exception("DATA") << "UnpackSimData: parent " << parent.key()
+                                       << " of SimParticle " << i.first << " is missing\n";
+        }
+        p->second.addDaughter(art::Ptr<SimParticle>(simsPID, i.first.asUint(), simsGetter));
+      }
+    }
+
+    for ( auto const& tag : _stepPointMCTags ) {
+      auto const& cs = *event.getValidHandle<CompactStepPointMCCollection>(tag);
+
+      art::ProductID const stepSimsPID = ( cs.simParticles == packed.self ) ? simsPID : cs.simParticles;
+      art::EDProductGetter const* stepSimsGetter = ( cs.simParticles == packed.self ) ? simsGetter : event.productGetter(cs.simParticles);
+
+      auto steps = std::make_unique<StepPointMCCollection>();
+      steps->reserve(cs.size());
+      cet::map_vector_key::value_type key(0);
+      for ( auto const& c : cs.steps ) {
+        key += c.simKeyDelta;
+        steps->emplace_back(art::Ptr<SimParticle>(stepSimsPID, key, stepSimsGetter),
+                            c.volumeId,
+                            c.totalEDep,
+                            c.nonIonizingEDep,
+                            cs.t0 + c.timeTicks*cs.timeQuantum,
+                            c.properTime,
+                            CLHEP::Hep3Vector(cs.origin[0] + c.position[0],
+                                              cs.origin[1] + c.position[1],
+                                              cs.origin[2] + c.position[2]),
+                            CLHEP::Hep3Vector(c.momentum[0], c.momentum[1], c.momentum[2]),
+                            c.stepLength,
+                            ProcessCode(static_cast<ProcessCode::enum_type>(c.endProcessCode)));
+      }
+      event.put(std::move(steps), tag.instance());
+    }
+
+    event.put(std::move(sims));
+  }
+
+} // end namespace mu2e
+
+DEFINE_ART_MODULE(mu2e::UnpackSimData);
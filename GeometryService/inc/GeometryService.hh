@@ -87,6 +87,11 @@ private:
     // Print final config file after all replacements.
     bool _printConfig;
 
+    // If not empty, a binary snapshot of the parsed configuration that is used
+    // instead of parsing the input file when none of its inputs have changed.
+    // It is written if it is missing or out of date.
+    std::string _snapshotFile;
+
     // The object that parses run-time configuration file.
     std::unique_ptr<SimpleConfig> _config;
 
@@ -98,6 +98,7 @@ namespace mu2e {
     _messageOnDefault(     pset.get<bool>        ("messageOnDefault",     false)),
     _configStatsVerbosity( pset.get<int>         ("configStatsVerbosity", 0)),
     _printConfig(          pset.get<bool>        ("printConfig",          false)),
+    _snapshotFile(         pset.get<std::string> ("snapshotFile",         "")),
     _config(nullptr),
     _pset   (pset),
     standardMu2eDetector_( _pset.get<std::string>("simulatedDetector.tool_type") == "Mu2e"),
@@ -151,9 +152,13 @@ namespace mu2e {
     _config = unique_ptr<SimpleConfig>(new SimpleConfig(_inputfile,
                                                       _allowReplacement,
                                                       _messageOnReplacement,
-                                                      _messageOnDefault ));
+                                                      _messageOnDefault,
+                                                      _snapshotFile ));
 
     _config->printOpen(cout,"Geometry");
+    if ( _config->fromSnapshot() ){
+      cout << "Geometry configuration loaded from snapshot " << _snapshotFile << endl;
+    }
 
     // Print final state of file after all substitutions.
     if ( _printConfig      ){ _config->print(cout, "Geom: ");       }
@@ -0,0 +1,62 @@
+#ifndef MCDataProducts_BackgroundFrame_hh
+#define MCDataProducts_BackgroundFrame_hh
+//
+// One self-contained background event, pre-flattened for event mixing.
+// Background frames are written to a ROOT tree by MakeBackgroundFrameLibrary
+// and read back, into an in-memory pool, by BackgroundFrameLibrary.
+//
+// The frame uses the compact representations of CompactSimParticle.hh and
+// CompactStepPointMC.hh, with the keys relative to the frame:
+// 1) The key of the first particle is 0; the idDelta of the others is the
+//    difference with the key of the previous particle, as usual.
+// 2) parentProduct is 0 for a parent inside the frame, with parentKey the
+//    difference of the keys, and -1 otherwise; parents and GenParticles
+//    outside of the frame are not kept.
+// 3) The first simKeyDelta of each step collection is the key, relative to
+//    the frame, of the particle of the first step.
+// 4) The CaloShowerSteps and StrawGasSteps are kept as they are, with null
+//    SimParticle Ptrs; simKeys holds the key, relative to the frame, of the
+//    particle of each of them.
+// so that a frame is spliced into an event by adding one key offset to all
+// of its particles and steps.  The tracker, calorimeter and virtual detector
+// steps of a frame all come from the same background event.
+//
+
+#include "MCDataProducts/inc/CompactSimParticle.hh"
+#include "MCDataProducts/inc/CompactStepPointMC.hh"
+#include "MCDataProducts/inc/CaloShowerStep.hh"
+#include "MCDataProducts/inc/StrawGasStep.hh"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mu2e {
+
+  // A collection of steps of the frame, see 4) above.
+  template <class STEP> struct BackgroundFrameSteps {
+    std::string           instance;
+    std::vector<STEP>     steps;
+    std::vector<uint32_t> simKeys;
+  };
+
+  // The steps do not share an interface to set their SimParticle.
+  inline void setSimParticle(CaloShowerStep& step, const art::Ptr<SimParticle>& sim) { step.setSimParticle(sim); }
+  inline void setSimParticle(StrawGasStep& step,   const art::Ptr<SimParticle>& sim) { step.simParticle() = sim; }
+
+  struct BackgroundFrame {
+
+    std::vector<CompactSimParticle> particles;
+
+    // The StepPointMC collections, with their instance names.
+    std::vector<std::string>                  stepInstances;
+    std::vector<CompactStepPointMCCollection> steps;
+
+    std::vector<BackgroundFrameSteps<CaloShowerStep>> caloShowerSteps;
+    std::vector<BackgroundFrameSteps<StrawGasStep>>   strawGasSteps;
+
+  };
+
+} // namespace mu2e
+
+#endif /* MCDataProducts_BackgroundFrame_hh */
@@ -0,0 +1,85 @@
+#ifndef MCDataProducts_CompactSimParticle_hh
+#define MCDataProducts_CompactSimParticle_hh
+//
+// A compact on-disk representation of a SimParticleCollection, written by
+// the PackSimData module and converted back to a SimParticleCollection by
+// UnpackSimData; see also CompactStepPointMC.hh.
+//
+// Compared with SimParticle:
+// 1) The positions, the momenta, the proper times, the kinetic energies and
+//    the track length are stored in float.  The global times stay in double,
+//    as they can be large for long lived particles.
+// 2) The key of the particle is stored as the difference with the key of the
+//    previous particle of the collection.
+// 3) The parent and the GenParticle are stored as the index, in the products
+//    table of the collection, of the ProductID they point into, -1 for a null
+//    Ptr, and a key.  The key of a parent in the same collection is stored as
+//    the difference with the key of the particle.
+// 4) The daughters are not stored: UnpackSimData derives them from the parents.
+//    Only the daughters in the same collection can be recovered this way,
+//    which is the case for all of the SimParticles made by Mu2eG4.
+//
+
+#include "canvas/Persistency/Provenance/ProductID.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace mu2e {
+
+  struct CompactSimParticle {
+
+    uint32_t idDelta     = 0;
+    uint32_t stageOffset = 0;
+    int32_t  pdgId       = 0;
+
+    int16_t  parentProduct = -1;
+    int16_t  genProduct    = -1;
+    uint32_t parentKey     = 0;
+    uint32_t genKey        = 0;
+
+    // Information at the start of the track.
+    float    startPosition[3] = {0.,0.,0.};
+    float    startMomentum[4] = {0.,0.,0.,0.};
+    double   startGlobalTime  = 0.;
+    float    startProperTime  = 0.;
+    uint32_t startVolumeIndex = 0;
+    uint16_t startG4Status    = 0;
+    uint16_t creationCode     = 0;
+
+    // Information at the end of the track.
+    float    endPosition[3] = {0.,0.,0.};
+    float    endMomentum[4] = {0.,0.,0.,0.};
+    double   endGlobalTime  = 0.;
+    float    endProperTime  = 0.;
+    uint32_t endVolumeIndex = 0;
+    uint16_t endG4Status    = 0;
+    uint16_t stoppingCode   = 0;
+    float    endKE          = -1.;
+    int32_t  nSteps         = 0;
+    float    trackLength    = -1.;
+
+    bool     endDefined     = false;
+    float    weight         = 1.;
+
+  };
+
+  struct CompactSimParticleCollection {
+
+    // The ProductID of the packed SimParticleCollection; the parents that point
+    // into it are restored to point into the unpacked collection.
+    art::ProductID self;
+
+    // The products the parents and GenParticles point into.
+    std::vector<art::ProductID> products;
+
+    std::vector<CompactSimParticle> particles;
+
+    bool   empty() const { return particles.empty(); }
+    size_t size()  const { return particles.size();  }
+
+  };
+
+} // namespace mu2e
+
+#endif /* MCDataProducts_CompactSimParticle_hh */
@@ -0,0 +1,67 @@
+#ifndef MCDataProducts_CompactStepPointMC_hh
+#define MCDataProducts_CompactStepPointMC_hh
+//
+// A compact on-disk representation of a StepPointMCCollection, written by
+// the PackSimData module and converted back to a StepPointMCCollection by
+// UnpackSimData.  It is meant for the output of the intermediate stages of
+// the multi-stage simulation, where the StepPointMCs dominate the file size.
+//
+// Compared with StepPointMC:
+// 1) The position is stored in float, relative to the origin of the
+//    collection, which is the position of its first step.
+// 2) The momentum, the energy deposits, the proper time and the step length
+//    are stored in float.
+// 3) The time is quantized: it is stored as a 32 bit count of timeQuantum
+//    above the earliest time of the collection, t0.  The packer enlarges the
+//    quantum if the time span of the collection does not fit in 32 bits.
+// 4) The art::Ptr to the SimParticle is replaced by the difference of its
+//    key with that of the previous step; all of the steps of a collection
+//    point into the same SimParticleCollection, whose ProductID is stored
+//    once in the collection.
+// 5) The volume id and the process code are stored in 32 and 16 bits.
+//
+// This takes about half of the space of a StepPointMC.
+//
+
+#include "canvas/Persistency/Provenance/ProductID.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace mu2e {
+
+  struct CompactStepPointMC {
+
+    int32_t  simKeyDelta = 0;
+    uint32_t volumeId    = 0;
+    uint32_t timeTicks   = 0;
+    float    properTime  = 0.;
+    float    totalEDep   = 0.;
+    float    nonIonizingEDep = 0.;
+    float    stepLength  = 0.;
+    float    position[3] = {0.,0.,0.};
+    float    momentum[3] = {0.,0.,0.};
+    uint16_t endProcessCode = 0;
+
+  };
+
+  struct CompactStepPointMCCollection {
+
+    // The SimParticleCollection all of the steps point into.
+    art::ProductID simParticles;
+
+    // Origin of the positions and of the quantized times.
+    double origin[3] = {0.,0.,0.};
+    double t0          = 0.;
+    double timeQuantum = 0.;
+
+    std::vector<CompactStepPointMC> steps;
+
+    bool   empty() const { return steps.empty(); }
+    size_t size()  const { return steps.size();  }
+
+  };
+
+} // namespace mu2e
+
+#endif /* MCDataProducts_CompactStepPointMC_hh */
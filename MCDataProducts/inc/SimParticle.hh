@@ -69,7 +69,8 @@ namespace mu2e {
       _nSteps(0),
       _trackLength(-1.),
       _daughterSims(),
-      _endDefined(false){
+      _endDefined(false),
+      _weight(1.){
     }
 
     SimParticle( key_type                       aid,
@@ -83,7 +84,8 @@ namespace mu2e {
                  double                         astartProperTime,
                  unsigned                       astartVolumeIndex,
                  unsigned                       astartG4Status,
-                 ProcessCode                    acreationCode):
+                 ProcessCode                    acreationCode,
+                 double                         aweight = 1.):
       _id(aid),
       _stageOffset(stageOffset),
       _parentSim(aparentSim),
@@ -108,7 +110,8 @@ namespace mu2e {
       _nSteps(0),
       _trackLength(-1.),
       _daughterSims(),
-      _endDefined(false)
+      _endDefined(false),
+      _weight(aweight)
     {}
 
     // Accept compiler generated d'tor, copy c'tor and assignment operator.
@@ -213,6 +216,10 @@ namespace mu2e {
     // Is the second half defined?
     bool endDefined() const { return _endDefined;}
 
+    // Statistical weight of this track when Mu2eG4Biasing is used, 1 otherwise.
+    // It is constant along the track and inherited by the daughters.
+    double weight() const { return _weight; }
+
     // Modifiers;
     void setDaughterPtrs  ( std::vector<art::Ptr<SimParticle> > const& ptr){
       _daughterSims.clear();
@@ -278,6 +285,9 @@ namespace mu2e {
     // Is the second half defined?
     bool _endDefined;
 
+    // Statistical weight from the variance reduction in G4.
+    double _weight;
+
   };
   typedef cet::map_vector<mu2e::SimParticle> SimParticleCollection;
 
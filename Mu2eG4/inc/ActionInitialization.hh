@@ -35,6 +35,7 @@ namespace mu2e {
 
     class SensitiveDetectorHelper;
     class IMu2eG4Cut;
+    class Mu2eG4Biasing;
     class PrimaryGeneratorAction;
     class Mu2eG4PerThreadStorage;
     class PhysicalVolumeHelper;
@@ -75,6 +76,7 @@ class ActionInitialization : public G4VUserActionInitialization
     std::unique_ptr<IMu2eG4Cut> stackingCuts_;
     std::unique_ptr<IMu2eG4Cut> steppingCuts_;
     std::unique_ptr<IMu2eG4Cut> commonCuts_;
+    std::unique_ptr<Mu2eG4Biasing> biasing_;
 
     SensitiveDetectorHelper* sensitiveDetectorHelper_;
     Mu2eG4PerThreadStorage*  perThreadStorage_;
@@ -16,7 +16,9 @@
 // Mu2e includes
 #include "Mu2eG4/inc/EventNumberList.hh"
 #include "MCDataProducts/inc/StepPointMCCollection.hh"
+#include "MCDataProducts/inc/CaloShowerStepCollection.hh"
 #include "Mu2eG4/inc/Mu2eSensitiveDetector.hh"
+#include "Mu2eG4/inc/CaloShowerStepMaker.hh"
 
 // Art includes
 #include "canvas/Persistency/Provenance/ProductID.h"
@@ -32,6 +34,24 @@ namespace mu2e {
 
     G4bool ProcessHits(G4Step*, G4TouchableHistory*);
 
+    virtual void Initialize(G4HCofThisEvent*);
+
+    virtual void EndOfEvent(G4HCofThisEvent*);
+
+    // If showerSteps is not null, the steps are compressed into CaloShowerSteps at the end
+    // of the event; the StepPointMCs are then only written if keepStepPoints is true.
+    void setShowerStepOutput(CaloShowerStepCollection* showerSteps, bool keepStepPoints);
+
+    // Deposit of the calorimeter fast simulation (CaloFastSimModel), only kept as CaloShowerSteps
+    void addFastDeposit(G4Track const* track, int crystalId, double time, double edep,
+                        double momentum, CLHEP::Hep3Vector const& posMu2e);
+
+  private:
+
+    CaloShowerStepCollection* _showerSteps;
+    bool                      _keepStepPoints;
+    CaloShowerStepMaker       _showerStepMaker;
+
   };
 
 } // namespace mu2e
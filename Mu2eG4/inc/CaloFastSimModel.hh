@@ -0,0 +1,51 @@
+#ifndef Mu2eG4_CaloFastSimModel_hh
+#define Mu2eG4_CaloFastSimModel_hh
+//
+// Fast simulation of the electromagnetic showers in the calorimeter disks.
+//
+// The model is attached to the region made of the crystal disk envelopes.  An e+-/photon
+// entering an envelope above the energy threshold is killed, and the deposits of a shower
+// drawn from the CaloShowerLibrary bin of its type, energy, entry angle and radius are
+// rotated along its direction, scaled to its energy and given to the crystal SD, which
+// compresses them into CaloShowerSteps.
+//
+
+// Mu2e includes
+#include "CaloMC/inc/CaloShowerLibrary.hh"
+
+// G4 includes
+#include "G4VFastSimulationModel.hh"
+
+namespace mu2e {
+
+  class Calorimeter;
+  class CaloCrystalSD;
+
+  class CaloFastSimModel : public G4VFastSimulationModel {
+
+  public:
+
+    CaloFastSimModel(G4String const& name, G4Region* envelope, CaloShowerLibrary const& library,
+                     double minEnergy, CaloCrystalSD* crystalSD);
+
+    G4bool IsApplicable(G4ParticleDefinition const& particle) override;
+    G4bool ModelTrigger(G4FastTrack const& fastTrack) override;
+    void   DoIt(G4FastTrack const& fastTrack, G4FastStep& fastStep) override;
+
+  private:
+
+    // library bin of the track entering the envelope, -1 if none
+    int entryBin(G4FastTrack const& fastTrack, int& diskId,
+                 CLHEP::Hep3Vector& posDisk, CLHEP::Hep3Vector& dir) const;
+
+    CaloShowerLibrary const& _library;
+    double                   _minEnergy;
+    CaloCrystalSD*           _crystalSD;   // non-owning
+    const Calorimeter*       _cal;
+    G4ThreeVector            _mu2eOrigin;
+
+  };
+
+} // namespace mu2e
+
+#endif /* Mu2eG4_CaloFastSimModel_hh */
@@ -3,7 +3,9 @@
 
 #include "Mu2eG4/inc/EventNumberList.hh"
 #include "MCDataProducts/inc/StepPointMCCollection.hh"
+#include "MCDataProducts/inc/CaloShowerStepCollection.hh"
 #include "Mu2eG4/inc/Mu2eSensitiveDetector.hh"
+#include "Mu2eG4/inc/CaloShowerStepMaker.hh"
 #include <map>
 #include <vector>
 
@@ -22,11 +24,22 @@ namespace mu2e {
 
        G4bool ProcessHits(G4Step*, G4TouchableHistory*);
 
+       virtual void Initialize(G4HCofThisEvent*);
+
+       virtual void EndOfEvent(G4HCofThisEvent*);
+
+       // As CaloCrystalSD, but the readout steps are only summed per track
+       void setShowerStepOutput(CaloShowerStepCollection* showerSteps, bool keepStepPoints);
+
 
      private:
 
        int    _nro;
 
+       CaloShowerStepCollection* _showerSteps;
+       bool                      _keepStepPoints;
+       CaloShowerStepMaker       _showerStepMaker;
+
   };
 
 } 
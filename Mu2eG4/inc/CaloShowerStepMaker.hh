@@ -0,0 +1,121 @@
+#ifndef Mu2eG4_CaloShowerStepMaker_hh
+#define Mu2eG4_CaloShowerStepMaker_hh
+//
+// Sum the G4 steps of the calorimeter sensitive detectors into CaloShowerSteps while
+// G4 is tracking, following the compression of CaloMC/src/CaloShowerStepFromStepPt.
+//
+// The steps of each track are summed in (volume, z slice) buckets; a bucket is closed when
+// a step arrives more than deltaTime after its first step.  At the end of the event the
+// crystal tracks are attached to their ancestor (the particle that entered the calorimeter
+// section); for compressible ancestors the buckets of all the tracks of the shower are
+// merged with the same time rule, otherwise one CaloShowerStep is kept per track.
+// Readout steps are not compressed across tracks.
+//
+
+// Mu2e includes
+#include "MCDataProducts/inc/CaloShowerStepCollection.hh"
+#include "MCDataProducts/inc/ProcessCode.hh"
+
+// CLHEP includes
+#include "CLHEP/Vector/ThreeVector.h"
+
+// C++ includes
+#include <bitset>
+#include <map>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+class G4Step;
+class G4Track;
+
+namespace mu2e {
+
+  class Calorimeter;
+  class SimpleConfig;
+  class SimParticleHelper;
+
+  class CaloShowerStepMaker {
+
+  public:
+
+    CaloShowerStepMaker(SimpleConfig const& config, bool isCrystal);
+
+    void clear();
+
+    // Record the ancestry of the track making this step, called for every step in the volume.
+    void addTrack(G4Step const* aStep, CLHEP::Hep3Vector const& mu2eOrigin);
+
+    // Add the energy deposit of this step to the bucket of its track.
+    void addStep(G4Step const* aStep, int volId, CLHEP::Hep3Vector const& posMu2e, ProcessCode endCode);
+
+    // Add a deposit of the calorimeter fast simulation, the deposits of a track must come in time order.
+    void addDeposit(G4Track const* track, int volId, double time, double edep, double momentum,
+                    CLHEP::Hep3Vector const& posMu2e, CLHEP::Hep3Vector const& mu2eOrigin);
+
+    void fill(CaloShowerStepCollection& showerSteps, SimParticleHelper const& spHelper);
+
+    int  nSteps() const { return _nsteps; }
+
+  private:
+
+    typedef std::bitset<ProcessCode::lastEnum> ProcessBits;
+    typedef std::tuple<int,int,int>            BucketKey;   // volume, G4 track id, z slice
+
+    // Energy weighted sums of the steps of a bucket, as in CaloMC/inc/ShowerStepUtil
+    struct Bucket {
+      int    volId   = 0;
+      int    trackId = 0;
+      int    slice   = 0;
+      int    n       = 0;
+      double edep    = 0.;
+      double pIn     = 0.;
+      double t0      = 0.;
+      double w = 0., w2 = 0., t = 0.;
+      double x = 0., y = 0., z = 0.;
+      double x2 = 0., y2 = 0., z2 = 0.;
+      double xy = 0., xz = 0., yz = 0.;
+      CLHEP::Hep3Vector posIn;
+
+      void add(double e, double time, double p, CLHEP::Hep3Vector const& pos);
+      void merge(Bucket const& other);
+    };
+
+    struct TrackInfo {
+      int    parentId  = 0;
+      int    pdgId     = 0;
+      int    ancestor  = -1;   // resolved at the end of the event
+      double startMom  = 0.;
+      bool   inside    = false;
+      CLHEP::Hep3Vector startPos;
+      CLHEP::Hep3Vector endPos;   // last post-step point seen in the calorimeter
+      ProcessBits procs;
+    };
+
+    TrackInfo& registerTrack(G4Track const* track, CLHEP::Hep3Vector const& mu2eOrigin);
+    void addToBucket(int volId, int trackId, double time, double edep, double momentum,
+                     CLHEP::Hep3Vector const& posMu2e);
+    int  ancestorOf(int trackId);
+    bool isCompressible(int ancestorId, std::vector<int> const& tracks) const;
+    void mergeBuckets(std::vector<Bucket const*>& buckets, int simId,
+                      CaloShowerStepCollection& showerSteps, SimParticleHelper const& spHelper) const;
+    void addShowerStep(Bucket const& bucket, int simId,
+                       CaloShowerStepCollection& showerSteps, SimParticleHelper const& spHelper) const;
+
+    bool   _isCrystal;
+    int    _numZSlices;
+    double _deltaTime;
+    double _zSliceSize;
+    int    _nsteps;
+    const Calorimeter* _cal;
+
+    std::map<int,std::set<int>>                _procCodes;
+    std::vector<Bucket>                        _buckets;
+    std::map<BucketKey,std::size_t>            _openBuckets;
+    std::unordered_map<int,TrackInfo>          _tracks;
+  };
+
+} // namespace mu2e
+
+#endif /* Mu2eG4_CaloShowerStepMaker_hh */
@@ -42,6 +42,10 @@
 // 8) The magic number for the default of stepMinimum comes from the source
 //    code for G4Chordfinder, v1.21
 //
+// 9) forRegion makes the manager of one region of the Mu2e field map, with a stepper
+//    chosen by name at run time.  Its field manager and field count the steps and
+//    the field evaluations of the region; see FieldRegionCounters.
+//
 #include <memory>
 #include <string>
 
@@ -56,6 +60,7 @@
 #include "G4Mag_UsualEqRhs.hh"
 #include "G4MagneticField.hh"
 #include "Mu2eG4/inc/Mu2eGlobalField.hh"
+#include "Mu2eG4/inc/FieldRegionCounters.hh"
 
 namespace mu2e {
 
@@ -106,6 +111,21 @@ namespace mu2e {
       return mgr;
     }
 
+    // Factory method to construct a manager for the magnetic field map in one region,
+    // named region, with the stepper named stepperName.  See Note 9.
+    // The stepper "FieldOff" makes a manager without field: the tracks go straight.
+    static std::unique_ptr<FieldMgr> forRegion(const std::string& region,
+                                               const std::string& stepperName,
+                                               const G4ThreeVector& mu2eOrigin,
+                                               double stepMinimum=1.0e-2*CLHEP::mm);
+
+    // Make the G4 stepper called stepperName, integrating the equation of motion rhs.
+    // The steppers with spin replace rhs by a G4Mag_SpinEqRhs of field, and delete the original.
+    // Throws if the name is not known.
+    static G4MagIntegratorStepper* makeStepper(const std::string& stepperName,
+                                               G4MagneticField* field,
+                                               G4Mag_EqRhs*& rhs);
+
     // Release all of the objects that this class owns.
     void release();
 
@@ -0,0 +1,83 @@
+#ifndef Mu2eG4_FieldRegionCounters_hh
+#define Mu2eG4_FieldRegionCounters_hh
+//
+// Count the G4 steps and the magnetic field evaluations in each region
+// of magnetic field that has its own field manager; see FieldMgr::forRegion.
+//
+// Notes
+// 1) The field managers are made in ConstructSDandField, that is once per
+//    thread in MT mode.  Each of them books its own Counts, so that the
+//    counters are only ever written by one thread and need no locking.
+//    The counts of all threads are summed when printed at the end of the job.
+//
+// 2) The steps are counted in G4FieldManager::ConfigureForTrack, which
+//    G4Transportation calls once per step taken in a volume with a field manager,
+//    the field evaluations in G4MagneticField::GetFieldValue.
+//
+
+#include <memory>
+#include <ostream>
+#include <string>
+
+// G4 includes
+#include "G4FieldManager.hh"
+#include "G4MagneticField.hh"
+
+class G4ChordFinder;
+class G4Track;
+
+namespace mu2e {
+
+  class FieldRegionCounters{
+
+  public:
+
+    struct Counts {
+      unsigned long long steps      = 0;
+      unsigned long long fieldCalls = 0;
+    };
+
+    // Book a new set of counters for the named region; the registry
+    // keeps them until the end of the job.
+    static std::shared_ptr<Counts> book( const std::string& region );
+
+    // Print the counts summed over the threads, one line per region.
+    static void print( std::ostream& os );
+
+  };
+
+  // Forward the field evaluations to the wrapped field, counting them.
+  class CountingMagneticField : public G4MagneticField {
+
+  public:
+
+    // Takes ownership of the wrapped field.
+    CountingMagneticField( G4MagneticField* field, std::shared_ptr<FieldRegionCounters::Counts> counts );
+
+    void GetFieldValue( const G4double Point[4], G4double *Bfield ) const override {
+      ++_counts->fieldCalls;
+      _field->GetFieldValue(Point,Bfield);
+    }
+
+  private:
+    std::unique_ptr<G4MagneticField>              _field;
+    std::shared_ptr<FieldRegionCounters::Counts> _counts;
+  };
+
+  // A G4FieldManager that counts the steps taken in the volumes it is attached to.
+  class CountingFieldManager : public G4FieldManager {
+
+  public:
+
+    CountingFieldManager( G4MagneticField* field, G4ChordFinder* chordFinder,
+                          std::shared_ptr<FieldRegionCounters::Counts> counts );
+
+    void ConfigureForTrack( const G4Track* ) override { ++_counts->steps; }
+
+  private:
+    std::shared_ptr<FieldRegionCounters::Counts> _counts;
+  };
+
+} //end namespace mu2e
+
+#endif /* Mu2eG4_FieldRegionCounters_hh */
@@ -0,0 +1,106 @@
+#ifndef MT_WorkerPool_hh
+#define MT_WorkerPool_hh
+//
+// MTWorkerPool.hh provides declarations for the MTWorkerPool class
+// for the Mu2e G4 simulation.  MTWorkerPool owns the worker run managers,
+// one per thread of the TBB arena, when running in MT mode.
+//
+// The G4 worker state is thread local, so a worker run manager must be
+// built, used and destroyed on one thread.  The pool does this by running
+// one task per arena thread behind a barrier: a task blocks on a condition
+// variable until all of the tasks have started, so that no two tasks share
+// a thread.  This is used to
+//
+// 1) build and initialize all of the workers at the first beginRun, instead of
+//    on the first event of each thread,
+// 2) begin and end the G4 run of all the workers at each art run boundary; the
+//    geometry and the physics tables of the workers are kept across runs,
+// 3) destroy the workers at the end of the job.
+//
+// Threads that were not reached at initialization get their worker on first use.
+//
+
+//G4 includes
+#include "G4ThreeVector.hh"
+
+//art includes
+#include "canvas/Persistency/Provenance/RunID.h"
+
+//TBB includes
+#include "tbb/concurrent_hash_map.h"
+
+//C++ includes
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace fhicl { class ParameterSet; }
+
+namespace tbb {
+  template<>
+  struct tbb_hash_compare<std::thread::id> {
+    tbb_hash_compare() {}
+    static size_t hash(std::thread::id tid) {
+      std::ostringstream oss;
+      oss << tid;
+      return std::stoull(oss.str());
+    }
+    static bool equal(std::thread::id const k1, std::thread::id const k2) {
+      return k1==k2;
+    }
+  };
+}
+
+namespace mu2e {
+
+    class Mu2eG4MTRunManager;
+    class Mu2eG4WorkerRunManager;
+
+class MTWorkerPool
+{
+  public:
+    MTWorkerPool(const fhicl::ParameterSet& pset, int nThreads);
+    ~MTWorkerPool();
+
+    // Build and initialize the workers of all threads, and begin the run on each of them.
+    void beginRun(Mu2eG4MTRunManager* masterRM,
+                  const G4ThreeVector& origin_in_world,
+                  art::RunNumber_t run_number);
+
+    // End the G4 run of all workers, keeping them for the next run.
+    void endRun();
+
+    // Destroy all workers, each on its own thread.
+    void destroyWorkers();
+
+    // The worker of the calling thread.
+    Mu2eG4WorkerRunManager* worker();
+
+    inline size_t size() const { return workers_.size(); }
+
+private:
+
+    typedef tbb::concurrent_hash_map< std::thread::id, std::unique_ptr<Mu2eG4WorkerRunManager> > WorkerMap;
+
+    // Make the worker of the calling thread if there is none.
+    Mu2eG4WorkerRunManager* makeWorker();
+
+    // Run task once on each of the nThreads_ threads of the arena.
+    void runOnEachThread(const std::function<void()>& task);
+
+    const fhicl::ParameterSet& pset_;
+    const int nThreads_;
+
+    Mu2eG4MTRunManager* masterRM_;
+    G4ThreeVector originInWorld_;
+    art::RunNumber_t runNumber_;
+
+    WorkerMap workers_;
+
+};
+
+
+}  // end namespace mu2e
+#endif /* MT_WorkerPool_hh */
@@ -0,0 +1,90 @@
+// Variance reduction in Mu2eG4: Russian roulette and geometric splitting.
+//
+// The Mu2eG4Biasing parameter set of the Mu2eG4 modules configures two techniques:
+//
+// 1) roulette: a list of {volumes, pdgIds, survivalProbability, maxKineticEnergy}.
+//    A new secondary of one of the pdgIds (all particles if empty) made in one of
+//    the physical volumes (anywhere if empty), below maxKineticEnergy in MeV
+//    (no limit if absent), is killed
+//    in the stacking action with the probability 1-survivalProbability; the
+//    survivors have their weight divided by survivalProbability.
+//
+// 2) importance: a list of {volumes, importances, pdgIds}.  The importance of a
+//    physical volume is the one of the closest listed volume among itself and its
+//    mothers, 1 if there is none.  When a track of one of the pdgIds crosses into a
+//    volume of importance ratio r = inew/iold, it is split in r copies of weight
+//    w/r if r>1, or survives with the probability r and the weight w/r if r<1.
+//    A non-integer r>1 gives floor(r) or floor(r)+1 copies, so that the mean is r.
+//
+// The weight is constant along a SimParticle: at a boundary the stepping action
+// stops the track, with stopping code mu2eRussianRoulette or mu2eSplitting, and the
+// surviving copies are its daughters, with creation code mu2eSplitting.  The weight
+// is inherited by the secondaries, and is stored in SimParticle::weight().
+//
+// One object per thread; the volume lookups are done in finishConstruction,
+// once the G4 geometry exists.
+
+#ifndef Mu2eG4_Mu2eG4Biasing_hh
+#define Mu2eG4_Mu2eG4Biasing_hh
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "fhiclcpp/ParameterSet.h"
+
+class G4Step;
+class G4Track;
+class G4VPhysicalVolume;
+class G4VTouchable;
+
+namespace mu2e {
+
+  class Mu2eG4Biasing {
+  public:
+
+    explicit Mu2eG4Biasing(const fhicl::ParameterSet& pset);
+
+    bool active() const { return !rouletteConfig_.empty() || !importanceConfig_.empty(); }
+
+    void finishConstruction();
+
+    // Russian roulette of a new track: returns true if the track is to be killed,
+    // otherwise its weight may have been raised.
+    bool stackingRoulette(G4Track* trk) const;
+
+    // The number of copies the track of the step continues with, each with the weight
+    // newWeight, when it enters a volume of different importance; -1 if no biasing applies.
+    int splitting(const G4Step* step, double& newWeight) const;
+
+  private:
+
+    struct Roulette {
+      std::set<const G4VPhysicalVolume*> volumes;
+      std::set<int> pdgIds;
+      double survivalProbability;
+      double maxKineticEnergy;
+    };
+
+    struct Importance {
+      std::map<const G4VPhysicalVolume*, double> volumes;
+      std::set<int> pdgIds;
+    };
+
+    double importance(const Importance& imp, const G4VTouchable* touchable) const;
+
+    static bool hasParticle(const std::set<int>& pdgIds, int pdgId) {
+      return pdgIds.empty() || pdgIds.count(pdgId) != 0;
+    }
+
+    std::vector<fhicl::ParameterSet> rouletteConfig_;
+    std::vector<fhicl::ParameterSet> importanceConfig_;
+
+    std::vector<Roulette> roulette_;
+    std::vector<Importance> importance_;
+  };
+
+} // end namespace mu2e
+
+#endif /* Mu2eG4_Mu2eG4Biasing_hh */
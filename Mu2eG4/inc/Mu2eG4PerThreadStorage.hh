@@ -20,11 +20,17 @@
 #include "MCDataProducts/inc/MCTrajectoryCollection.hh"
 #include "MCDataProducts/inc/SimParticleRemapping.hh"
 #include "MCDataProducts/inc/ExtMonFNALSimHitCollection.hh"
+#include "MCDataProducts/inc/StrawGasStep.hh"
+#include "MCDataProducts/inc/CaloShowerStepCollection.hh"
+#include "MCDataProducts/inc/SimParticlePtrCollection.hh"
 #include "MCDataProducts/inc/StepInstanceName.hh"
 #include "Mu2eUtilities/inc/SimParticleCollectionPrinter.hh"
 
 //C++ includes
 #include <iostream>
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 //art includes
 #include "fhiclcpp/ParameterSet.h"
@@ -71,6 +77,13 @@ struct Mu2eG4PerThreadStorage
         }
         
     }
+    
+    // Only the primaries [first,last) of the event are given to G4; the primaries are
+    // numbered over the GenParticles followed by the genInputHits.
+    void setPrimaryRange(unsigned first, unsigned last) {
+        firstPrimary = first;
+        lastPrimary = last;
+    }
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -99,6 +112,15 @@ struct Mu2eG4PerThreadStorage
         extMonFNALHits = std::move(ext_mon_fnal_hits);
     }
     
+    void insertStrawGasSteps(std::unique_ptr<StrawGasStepCollection> straw_gas_steps) {
+        strawGasSteps = std::move(straw_gas_steps);
+    }
+    
+    void insertCaloShowerSteps(std::unique_ptr<CaloShowerStepCollection> calo_shower_steps,
+                               std::string instance_name) {
+        caloShowerSteps[instance_name] = std::move(calo_shower_steps);
+    }
+    
     void insertSDStepPointMC(std::unique_ptr<StepPointMCCollection> step_point_mc,
                              std::string instance_name) {
         sensitiveDetectorSteps[instance_name] = std::move(step_point_mc);
@@ -114,6 +136,92 @@ struct Mu2eG4PerThreadStorage
         simParticlePrinter_.print(std::cout, *simPartCollection);
     }
     
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+// function to combine the sub-events of a split event
+    
+    // Move the event data of other into this object, appending the collections to the ones
+    // already here. SimParticles present in both, the ones copied from a previous simulation
+    // stage, are kept once with the daughters of both copies.
+    void mergeEventData(Mu2eG4PerThreadStorage& other) {
+        
+        if (other.simPartCollection == nullptr) return;
+        
+        if (simPartCollection == nullptr) {
+            statG4 = std::move(other.statG4);
+            simPartCollection = std::move(other.simPartCollection);
+        } else {
+            statG4->add(*other.statG4);
+            
+            std::vector<SimParticleCollection::value_type> added;
+            for (auto const& sim : *other.simPartCollection) {
+                SimParticle* existing = simPartCollection->getOrNull(sim.first);
+                if (existing == nullptr) {
+                    added.push_back(sim);
+                    continue;
+                }
+                for (auto const& daughter : sim.second.daughters()) {
+                    auto const& daughters = existing->daughters();
+                    if (std::find(daughters.begin(), daughters.end(), daughter) == daughters.end()) {
+                        existing->addDaughter(daughter);
+                    }
+                }
+            }
+            simPartCollection->insert(added.begin(), added.end());
+        }
+        other.statG4 = nullptr;
+        other.simPartCollection = nullptr;
+        
+        if (other.tvd.second != nullptr) {
+            if (tvd.second == nullptr) {
+                tvd = std::move(other.tvd);
+            } else {
+                appendTo(*tvd.second, *other.tvd.second);
+            }
+            other.tvd.first = "";
+            other.tvd.second = nullptr;
+        }
+        
+        if (other.mcTrajectories != nullptr) {
+            if (mcTrajectories == nullptr) {
+                mcTrajectories = std::move(other.mcTrajectories);
+            } else {
+                mcTrajectories->insert(other.mcTrajectories->begin(), other.mcTrajectories->end());
+                other.mcTrajectories = nullptr;
+            }
+        }
+        
+        // the remapping of the previous stage is the same for all sub-events
+        if (simRemapping == nullptr) simRemapping = std::move(other.simRemapping);
+        other.simRemapping = nullptr;
+        
+        mergeCollection(extMonFNALHits, other.extMonFNALHits);
+        mergeCollection(strawGasSteps, other.strawGasSteps);
+        
+        for (auto& i : other.sensitiveDetectorSteps) mergeCollection(sensitiveDetectorSteps[i.first], i.second);
+        for (auto& i : other.cutsSteps) mergeCollection(cutsSteps[i.first], i.second);
+        for (auto& i : other.caloShowerSteps) mergeCollection(caloShowerSteps[i.first], i.second);
+        other.sensitiveDetectorSteps.clear();
+        other.cutsSteps.clear();
+        other.caloShowerSteps.clear();
+    }
+    
+    template<class COLL>
+    static void appendTo(COLL& to, COLL& from) {
+        to.insert(to.end(), std::make_move_iterator(from.begin()), std::make_move_iterator(from.end()));
+    }
+    
+    template<class COLL>
+    static void mergeCollection(std::unique_ptr<COLL>& to, std::unique_ptr<COLL>& from) {
+        if (from == nullptr) return;
+        if (to == nullptr) {
+            to = std::move(from);
+        } else {
+            appendTo(*to, *from);
+            from = nullptr;
+        }
+    }
+    
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 // functions to move the data into the art::Event
@@ -174,6 +282,59 @@ struct Mu2eG4PerThreadStorage
     }
  
     
+    void putStrawGasStepData(art::EDProductGetter const* sim_product_getter) {
+        
+        std::unique_ptr<StrawGasStepCollection> sgsc = std::move(strawGasSteps);
+        if (sgsc == nullptr) {
+            sgsc = std::make_unique<StrawGasStepCollection>();
+        }
+        
+        for ( StrawGasStep& sgs : *sgsc ) {
+            if ( sgs.simParticle().isNonnull() ){
+                sgs.simParticle() = art::Ptr<SimParticle>(sgs.simParticle().id(),
+                                                          sgs.simParticle().key(),
+                                                          sim_product_getter );
+            }//if
+        }//for
+        
+        artEvent->put(std::move(sgsc));
+    }
+    
+    
+    // The SimParticles of the crystal CaloShowerSteps are also written, as the
+    // SimParticlePtrCollection of CaloShowerStepFromStepPt.
+    void putCaloShowerStepData(art::EDProductGetter const* sim_product_getter) {
+        
+        auto simsToKeep = std::make_unique<SimParticlePtrCollection>();
+        std::string const crystalName = StepInstanceName(StepInstanceName::calorimeter).name();
+        std::string const readoutName = StepInstanceName(StepInstanceName::calorimeterRO).name();
+        
+        for (std::string const& instance : {crystalName, readoutName}) {
+            
+            std::unique_ptr<CaloShowerStepCollection> cssc = std::move(caloShowerSteps[instance]);
+            if (cssc == nullptr) {
+                cssc = std::make_unique<CaloShowerStepCollection>();
+            }
+            
+            for ( CaloShowerStep& css : *cssc ) {
+                if ( css.simParticle().isNonnull() ){
+                    css.setSimParticle(art::Ptr<SimParticle>(css.simParticle().id(),
+                                                             css.simParticle().key(),
+                                                             sim_product_getter ));
+                    if (instance == crystalName &&
+                        (simsToKeep->empty() || simsToKeep->back() != css.simParticle())) {
+                        simsToKeep->push_back(css.simParticle());
+                    }
+                }//if
+            }//for
+            
+            artEvent->put(std::move(cssc), instance);
+        }
+        
+        artEvent->put(std::move(simsToKeep));
+    }
+    
+    
     void putCutsData(art::EDProductGetter const* sim_product_getter) {
         
         std::unordered_map< std::string, std::unique_ptr<StepPointMCCollection> > cuts_map = std::move(cutsSteps);
@@ -204,6 +365,8 @@ struct Mu2eG4PerThreadStorage
         genInputHits = nullptr;
         gensHandle.clear();
         generatorModuleLabel = "";
+        firstPrimary = 0;
+        lastPrimary = std::numeric_limits<unsigned>::max();
         
         statG4 = nullptr;
         simPartCollection = nullptr;
@@ -212,7 +375,9 @@ struct Mu2eG4PerThreadStorage
         mcTrajectories = nullptr;
         simRemapping = nullptr;
         extMonFNALHits = nullptr;
+        strawGasSteps = nullptr;
         sensitiveDetectorSteps.clear();
+        caloShowerSteps.clear();
         cutsSteps.clear();
     }
     
@@ -231,6 +396,8 @@ struct Mu2eG4PerThreadStorage
     const HitHandles* genInputHits = nullptr;
     art::Handle<GenParticleCollection> gensHandle;
     art::InputTag generatorModuleLabel;
+    unsigned firstPrimary = 0;
+    unsigned lastPrimary = std::numeric_limits<unsigned>::max();
     
     std::unique_ptr<StatusG4> statG4 = nullptr;
     std::unique_ptr<SimParticleCollection> simPartCollection = nullptr;
@@ -238,9 +405,11 @@ struct Mu2eG4PerThreadStorage
     std::unique_ptr<MCTrajectoryCollection> mcTrajectories = nullptr;
     std::unique_ptr<SimParticleRemapping> simRemapping = nullptr;
     std::unique_ptr<ExtMonFNALSimHitCollection> extMonFNALHits = nullptr;
+    std::unique_ptr<StrawGasStepCollection> strawGasSteps = nullptr;
     
     std::unordered_map< std::string, std::unique_ptr<StepPointMCCollection> > sensitiveDetectorSteps;
     std::unordered_map< std::string, std::unique_ptr<StepPointMCCollection> > cutsSteps;
+    std::unordered_map< std::string, std::unique_ptr<CaloShowerStepCollection> > caloShowerSteps;
     
     SimParticleCollectionPrinter simParticlePrinter_;
     
@@ -11,11 +11,14 @@
 
 namespace mu2e {
 
+  class Mu2eG4Biasing;
+
   class Mu2eG4StackingAction: public G4UserStackingAction{
   public:
     Mu2eG4StackingAction(const fhicl::ParameterSet& pset,
                          IMu2eG4Cut& stackingCuts,
-                         IMu2eG4Cut& commonCuts);
+                         IMu2eG4Cut& commonCuts,
+                         const Mu2eG4Biasing& biasing);
       
     G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* aTrack) override;
 
@@ -23,6 +26,7 @@ namespace mu2e {
     // owned by Mu2eG4 module.
     IMu2eG4Cut* stackingCuts_;
     IMu2eG4Cut* commonCuts_;
+    const Mu2eG4Biasing* biasing_;
   };
 
 } // end namespace mu2e
@@ -35,6 +35,7 @@ namespace mu2e {
   class PhysicsProcessInfo;
   class Mu2eG4ResourceLimits;
   class Mu2eG4TrajectoryControl;
+  class Mu2eG4Biasing;
 
   class Mu2eG4SteppingAction : public G4UserSteppingAction
   {
@@ -44,6 +45,7 @@ namespace mu2e {
                          const std::vector<double>& timeVDtimes,
                          IMu2eG4Cut& steppingCuts,
                          IMu2eG4Cut& commonCuts,
+                         Mu2eG4Biasing& biasing,
                          const Mu2eG4TrajectoryControl& tc,
                          const Mu2eG4ResourceLimits& mu2elimits);
 
@@ -85,6 +87,7 @@ namespace mu2e {
     // owned by Mu2eG4 module.
     IMu2eG4Cut* steppingCuts_;
     IMu2eG4Cut* commonCuts_;
+    Mu2eG4Biasing* biasing_;
 
     const Mu2eG4ResourceLimits *mu2elimits_;
 
@@ -125,6 +128,9 @@ namespace mu2e {
     // A helper function to kill the track and record the reason for killing it.
     void killTrack( G4Track* track, ProcessCode::enum_type code, G4TrackStatus status );
 
+    // Stop the track at the boundary it crossed and continue it with ncopies copies of weight newWeight.
+    void splitTrack( const G4Step* step, int ncopies, double newWeight );
+
     // Add time virtual detector hit to the collection
     G4bool addTimeVDHit(const G4Step*, int);
 
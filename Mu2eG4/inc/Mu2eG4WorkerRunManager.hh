@@ -13,6 +13,7 @@
 
 //art includes
 #include "fhiclcpp/ParameterSet.h"
+#include "canvas/Persistency/Provenance/RunID.h"
 
 //Mu2e includes
 #include "Mu2eG4/inc/Mu2eG4ResourceLimits.hh"
@@ -34,6 +35,7 @@ namespace mu2e {
     
     class Mu2eG4MTRunManager;
     class IMu2eG4Cut;
+    class Mu2eG4Biasing;
     class PrimaryGeneratorAction;
     class Mu2eG4SteppingAction;
     class TrackingAction;
@@ -51,8 +53,14 @@ namespace mu2e {
     void initializeThread(Mu2eG4MTRunManager* mRM,
                           const G4ThreeVector& origin_in_world);
     void initializeUserActions(const G4ThreeVector& origin_in_world);
-    void initializeRun(art::Event* art_event);
+    void initializeRun(art::RunNumber_t run_number);
     void processEvent(art::Event*);
+    void terminateRun();
+
+    // Seeds of the next event, used instead of the ones handed out by the master.
+    // Mu2eG4MT sets them for the sub-events of a split event so that the result
+    // does not depend on which worker simulated which sub-event.
+    void setEventSeeds(long seed1, long seed2);
                 
     inline bool workerRMInitialized() const { return m_managerInitialized; }
         
@@ -60,6 +68,10 @@ namespace mu2e {
         return perThreadObjects_.get();
     }
         
+  protected:
+
+        G4Event* GenerateEvent(G4int i_event) override;
+
   private:
             
         fhicl::ParameterSet const& pset_;
@@ -82,10 +94,14 @@ namespace mu2e {
         std::unique_ptr<IMu2eG4Cut> stackingCuts_;
         std::unique_ptr<IMu2eG4Cut> steppingCuts_;
         std::unique_ptr<IMu2eG4Cut> commonCuts_;
+        std::unique_ptr<Mu2eG4Biasing> biasing_;
 
         PrimaryGeneratorAction* genAction_;
         Mu2eG4SteppingAction* steppingAction_;
         TrackingAction* trackingAction_;
+
+        bool useEventSeeds_;
+        long eventSeeds_[2];
         
   };
 
@@ -64,6 +64,7 @@ namespace mu2e {
   // Forward references within mu2e namespace.
   class SimpleConfig;
   class SensitiveDetectorHelper;
+  class CaloShowerLibrary;
 
   class Mu2eWorld : public Mu2eUniverse {
   public:
@@ -95,10 +96,14 @@ namespace mu2e {
       VolumeInfo constructCal();
       void constructMagnetYoke();
       void constructBFieldAndManagers();
+      std::unique_ptr<FieldMgr> makeRegionFieldMgr(const std::string& region,
+                                                   const fhicl::ParameterSet& regionPars);
       void constructStepLimiters();
       void constructITStepLimiters();
 
       void instantiateSensitiveDetectors();
+      void constructCaloFastSimRegion();
+      void instantiateCaloFastSim();
       
       void stepLimiterHelper(const std::string &regexp, G4UserLimits* stepLimit);
       void setStepLimitToAllSuchVolumes(const G4String& vn,
@@ -135,6 +140,17 @@ namespace mu2e {
       double strawGasMaxStep_;
       bool limitStepInAllVolumes_;
       bool useEmOption4InTracker_;
+      bool caloFastSim_;
+      double caloFastSimMinEnergy_;
+      std::string caloFastSimLibrary_;
+
+      // Stepper and accuracy parameters of the regions of magnetic field with their
+      // own field managers, by region name; see constructBFieldAndManagers.
+      fhicl::ParameterSet fieldRegions_;
+
+      // Shower library of the calorimeter fast simulation, read once by the master
+      // and shared by the models of all the threads.
+      std::unique_ptr<CaloShowerLibrary> caloShowerLibrary_;
 
       //returned from constructPS
       G4LogicalVolume* psVacuumLogical_;
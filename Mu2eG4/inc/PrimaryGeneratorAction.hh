@@ -67,7 +67,8 @@ namespace mu2e {
                          const G4ThreeVector& pos,
                          double time,
                          double properTime,
-                         const G4ThreeVector& mom);
+                         const G4ThreeVector& mom,
+                         double weight = 1.);
       
 
       // Input event kinematics
@@ -76,6 +77,8 @@ namespace mu2e {
       const GenParticleCollection* genParticles_;
       const HitHandles* hitInputs_;
       SimParticlePrimaryHelper* parentMapping_;
+      unsigned firstPrimary_;
+      unsigned lastPrimary_;
 
       int verbosityLevel_;
       
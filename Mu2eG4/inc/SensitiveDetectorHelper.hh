@@ -14,6 +14,8 @@
 #include "Mu2eG4/inc/Mu2eSensitiveDetector.hh"
 #include "MCDataProducts/inc/StepPointMCCollection.hh"
 #include "MCDataProducts/inc/StepInstanceName.hh"
+#include "MCDataProducts/inc/StrawGasStep.hh"
+#include "MCDataProducts/inc/CaloShowerStepCollection.hh"
 #include "Mu2eG4/inc/ExtMonFNALPixelSD.hh"
 
 // From the art tool chain
@@ -36,6 +38,9 @@ namespace mu2e {
   class SimpleConfig;
   class SimParticleHelper;
   class Mu2eG4PerThreadStorage;
+  class StrawSD;
+  class CaloCrystalSD;
+  class CaloReadoutSD;
 
   class SensitiveDetectorHelper{
 
@@ -75,6 +80,10 @@ namespace mu2e {
 
       bool extMonPixelsEnabled() const { return extMonPixelsEnabled_; }
       ExtMonFNALPixelSD* getExtMonFNALPixelSD() const { return extMonFNALPixelSD_; }
+
+      bool strawGasStepsEnabled() const { return strawGasStepsEnabled_; }
+
+      bool caloShowerStepsEnabled() const { return caloShowerStepsEnabled_; }
       
       int verbosityLevel() const { return verbosityLevel_; }
 
@@ -121,6 +130,21 @@ namespace mu2e {
       // Separate handling as this detector does not produced StepPointMCs
       bool extMonPixelsEnabled_;
       ExtMonFNALPixelSD* extMonFNALPixelSD_ = nullptr;
+
+      // StrawGasSteps summed inside the tracker SD; the tracker StepPointMCs
+      // are then optional.  See note 3 in the .cc file.
+      bool strawGasStepsEnabled_;
+      bool strawStepPointsEnabled_;
+      StrawGasStepCollection strawGasSteps_;
+      StrawSD* strawSD_ = nullptr;
+
+      // CaloShowerSteps compressed inside the calorimeter SDs.  See note 4 in the .cc file.
+      bool caloShowerStepsEnabled_;
+      bool caloStepPointsEnabled_;
+      CaloShowerStepCollection caloShowerSteps_;
+      CaloShowerStepCollection caloROShowerSteps_;
+      CaloCrystalSD* caloCrystalSD_ = nullptr;
+      CaloReadoutSD* caloReadoutSD_ = nullptr;
       const bool standardMu2eDetector_;
       
       int  verbosityLevel_;
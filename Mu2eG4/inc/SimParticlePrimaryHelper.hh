@@ -43,18 +43,24 @@ namespace mu2e {
       const art::Ptr<SimParticle>& simParticlePrimaryPtr(int g4TrkID) const {
           return entries_.at(g4TrkID - 1).simParticlePrimaryPtr;
       }
+
+      // Weight of the SimParticle of the previous stage, 1 for GenParticles.
+      double primaryWeight(int g4TrkID) const {
+          return entries_.at(g4TrkID - 1).weight;
+      }
       
       void addEntryFromGenParticle(unsigned genId);
       
-      void addEntryFromStepPointMC (SimParticleCollection::key_type simId);
+      void addEntryFromStepPointMC (SimParticleCollection::key_type simId, double weight = 1.);
 
   private:
 
       struct Entry {
           art::Ptr<GenParticle> genParticlePtr;
           art::Ptr<SimParticle> simParticlePrimaryPtr;
-          Entry(const art::Ptr<GenParticle>& g, const art::Ptr<SimParticle>& p)
-          : genParticlePtr(g), simParticlePrimaryPtr(p)
+          double weight;
+          Entry(const art::Ptr<GenParticle>& g, const art::Ptr<SimParticle>& p, double w = 1.)
+          : genParticlePtr(g), simParticlePrimaryPtr(p), weight(w)
           {}
       };
 
@@ -13,6 +13,7 @@
 // Mu2e includes
 #include "Mu2eG4/inc/EventNumberList.hh"
 #include "MCDataProducts/inc/StepPointMCCollection.hh"
+#include "MCDataProducts/inc/StrawGasStep.hh"
 #include "Mu2eG4/inc/Mu2eSensitiveDetector.hh"
 #include "TrackerGeom/inc/SupportModel.hh"
 
@@ -20,11 +21,17 @@
 #include "canvas/Persistency/Provenance/ProductID.h"
 #include "art/Framework/Principal/Event.h"
 
+// C++ includes
+#include <map>
+#include <utility>
+
 class G4Step;
 class G4HCofThisEvent;
 
 namespace mu2e {
 
+  class Tracker;
+
   class StrawSD : public Mu2eSensitiveDetector{
 
   public:
@@ -32,8 +39,40 @@ namespace mu2e {
 
     G4bool ProcessHits(G4Step*, G4TouchableHistory*);
 
+    virtual void Initialize(G4HCofThisEvent*);
+
+    virtual void EndOfEvent(G4HCofThisEvent*);
+
+    // If gasSteps is not null, the steps are summed per (straw, track) and written
+    // as StrawGasSteps at the end of the event; the StepPointMCs are then only
+    // written if keepStepPoints is true.
+    void setGasStepOutput(StrawGasStepCollection* gasSteps, bool keepStepPoints);
+
   private:
 
+    // Running sums of the G4 steps of one track in one straw.
+    struct GasStepSum {
+      art::Ptr<SimParticle> simp;
+      int    parentId = 0;
+      bool   delta    = false;  // created by ionization
+      double charge   = 0.;
+      double mass     = 0.;
+      double eIon     = 0.;     // includes the compressed delta-rays
+      double pathLen  = 0.;
+      double tFirst   = 0.;
+      double tLast    = 0.;
+      G4ThreeVector startPos, startMom;
+      G4ThreeVector endPos, endMom;
+    };
+    typedef std::pair<uint16_t,int> StrawTrackKey; // straw, G4 track id
+    typedef std::map<StrawTrackKey,GasStepSum> GasStepSums;
+
+    void addGasStep(G4Step const* aStep, StrawId const& sid,
+                    G4ThreeVector const& prePos, G4ThreeVector const& postPos);
+    void compressDeltas();
+    void fillGasStep(StrawId const& sid, GasStepSum const& sum, StrawGasStep& sgs) const;
+
+
     G4ThreeVector GetTrackerOrigin();
 
     int _nStrawsPerPlane;
@@ -47,6 +86,20 @@ namespace mu2e {
     SupportModel _supportModel;
     int _verbosityLevel;
 
+    // StrawGasStep aggregation
+    StrawGasStepCollection* _gasSteps;
+    bool _keepStepPoints;
+    GasStepSums _gasStepSums;
+    const Tracker* _tracker;
+    bool   _combineDeltas;
+    double _maxDeltaLength;
+    double _minionBG;
+    double _minionKE;
+    double _curlMom;
+    double _lineMom;
+    double _bnom;              // BField in units of (MeV/c)/mm
+    G4ThreeVector _bdir;
+
   };
 
 } // namespace mu2e
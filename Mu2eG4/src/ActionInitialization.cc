@@ -17,6 +17,7 @@
 #include "Mu2eG4/inc/Mu2eG4MasterRunAction.hh"
 #include "Mu2eG4/inc/SensitiveDetectorHelper.hh"
 #include "Mu2eG4/inc/IMu2eG4Cut.hh"
+#include "Mu2eG4/inc/Mu2eG4Biasing.hh"
 #include "Mu2eG4/inc/Mu2eG4PerThreadStorage.hh"
 #include "Mu2eG4/inc/SteppingVerbose.hh"
 #include "Mu2eG4/inc/PhysicalVolumeHelper.hh"
@@ -45,6 +46,7 @@ namespace mu2e {
         stackingCuts_(createMu2eG4Cuts(pset.get<fhicl::ParameterSet>("Mu2eG4StackingOnlyCut",fhicl::ParameterSet()), mu2eLimits_)),
         steppingCuts_(createMu2eG4Cuts(pset_.get<fhicl::ParameterSet>("Mu2eG4SteppingOnlyCut", fhicl::ParameterSet()), mu2eLimits_)),
         commonCuts_(createMu2eG4Cuts(pset.get<fhicl::ParameterSet>("Mu2eG4CommonCut",fhicl::ParameterSet()), mu2eLimits_)),
+        biasing_(std::make_unique<Mu2eG4Biasing>(pset.get<fhicl::ParameterSet>("Mu2eG4Biasing",fhicl::ParameterSet()))),
     
         sensitiveDetectorHelper_(sensitive_detectorhelper),
         perThreadStorage_(per_thread_storage),
@@ -77,11 +79,12 @@ namespace mu2e {
                                                                         timeVDtimes_,
                                                                         stepping_Cuts,
                                                                         common_Cuts,
+                                                                        *biasing_.get(),
                                                                         trajectoryControl_,
                                                                         mu2eLimits_);
         SetUserAction(steppingAction);
         
-        SetUserAction( new Mu2eG4StackingAction(pset_, stacking_Cuts, common_Cuts) );
+        SetUserAction( new Mu2eG4StackingAction(pset_, stacking_Cuts, common_Cuts, *biasing_.get()) );
     
         TrackingAction* trackingAction = new TrackingAction(pset_,
                                                             steppingAction,
@@ -30,11 +30,17 @@
 namespace mu2e {
 
     CaloCrystalSD::CaloCrystalSD(G4String name, SimpleConfig const & config ): 
-      Mu2eSensitiveDetector(name,config)
+      Mu2eSensitiveDetector(name,config),
+      _showerSteps(nullptr),
+      _keepStepPoints(true),
+      _showerStepMaker(config,true)
     { }
 
     G4bool CaloCrystalSD::ProcessHits(G4Step* aStep,G4TouchableHistory*)
     {
+        // the ancestry is needed for the tracks that do not deposit energy (e.g. converting photons)
+        if (_showerSteps != nullptr) _showerStepMaker.addTrack(aStep,_mu2eOrigin);
+
         G4double edep = aStep->GetTotalEnergyDeposit();
 	if (edep < 1e-6) return false;
 
@@ -64,20 +70,55 @@ namespace mu2e {
 	//<<"  "<<touchableHandle->GetSolid(i)->GetName()<<"   "<<touchableHandle->GetVolume(i)->GetName()<<std::endl;
 
 
-	_collection->push_back(StepPointMC(_spHelper->particlePtr(aStep->GetTrack()),
-                        		   copyNo,
-                        		   edep,
-                        		   aStep->GetNonIonizingEnergyDeposit(),
-                        		   aStep->GetPreStepPoint()->GetGlobalTime(),
-                        		   aStep->GetPreStepPoint()->GetProperTime(),
-                        		   aStep->GetPreStepPoint()->GetPosition() - _mu2eOrigin,
-                        		   aStep->GetPreStepPoint()->GetMomentum(),
-                        		   aStep->GetStepLength(),
-                        		   endCode
-                        		   ));
+	if (_showerSteps != nullptr) _showerStepMaker.addStep(aStep,copyNo,posWorld - _mu2eOrigin,endCode);
+
+	if (_keepStepPoints)
+	  _collection->push_back(StepPointMC(_spHelper->particlePtr(aStep->GetTrack()),
+                        		     copyNo,
+                        		     edep,
+                        		     aStep->GetNonIonizingEnergyDeposit(),
+                        		     aStep->GetPreStepPoint()->GetGlobalTime(),
+                        		     aStep->GetPreStepPoint()->GetProperTime(),
+                        		     aStep->GetPreStepPoint()->GetPosition() - _mu2eOrigin,
+                        		     aStep->GetPreStepPoint()->GetMomentum(),
+                        		     aStep->GetStepLength(),
+                        		     endCode
+                        		     ));
 
 	return true;
 
     }
 
+
+    void CaloCrystalSD::Initialize(G4HCofThisEvent* HCE)
+    {
+        Mu2eSensitiveDetector::Initialize(HCE);
+        _showerStepMaker.clear();
+    }
+
+
+    void CaloCrystalSD::EndOfEvent(G4HCofThisEvent* HCE)
+    {
+        Mu2eSensitiveDetector::EndOfEvent(HCE);
+        if (_showerSteps == nullptr) return;
+
+        _showerStepMaker.fill(*_showerSteps,*_spHelper);
+        _showerStepMaker.clear();
+    }
+
+
+    void CaloCrystalSD::addFastDeposit(G4Track const* track, int crystalId, double time, double edep,
+                                       double momentum, CLHEP::Hep3Vector const& posMu2e)
+    {
+        if (_showerSteps == nullptr) return;
+        _showerStepMaker.addDeposit(track,crystalId,time,edep,momentum,posMu2e,_mu2eOrigin);
+    }
+
+
+    void CaloCrystalSD::setShowerStepOutput(CaloShowerStepCollection* showerSteps, bool keepStepPoints)
+    {
+        _showerSteps    = showerSteps;
+        _keepStepPoints = keepStepPoints || showerSteps == nullptr;
+    }
+
 } 
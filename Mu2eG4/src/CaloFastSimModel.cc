@@ -0,0 +1,109 @@
+//
+// Fast simulation of the electromagnetic showers in the calorimeter disks.
+//
+
+#include <algorithm>
+#include <cmath>
+
+// Mu2e includes
+#include "Mu2eG4/inc/CaloFastSimModel.hh"
+#include "Mu2eG4/inc/CaloCrystalSD.hh"
+#include "CalorimeterGeom/inc/Calorimeter.hh"
+#include "GeometryService/inc/GeomHandle.hh"
+#include "GeometryService/inc/WorldG4.hh"
+
+// G4 includes
+#include "G4Electron.hh"
+#include "G4Positron.hh"
+#include "G4Gamma.hh"
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4Track.hh"
+#include "G4VSolid.hh"
+#include "Randomize.hh"
+
+namespace mu2e {
+
+  CaloFastSimModel::CaloFastSimModel(G4String const& name, G4Region* envelope,
+                                     CaloShowerLibrary const& library,
+                                     double minEnergy, CaloCrystalSD* crystalSD):
+    G4VFastSimulationModel(name,envelope),
+    _library(library),
+    _minEnergy(std::max(minEnergy,library.minEnergy())),
+    _crystalSD(crystalSD),
+    _cal(GeomHandle<Calorimeter>().get()),
+    _mu2eOrigin(GeomHandle<WorldG4>()->mu2eOriginInWorld())
+  {}
+
+  G4bool CaloFastSimModel::IsApplicable(G4ParticleDefinition const& particle){
+    return &particle == G4Electron::ElectronDefinition() ||
+           &particle == G4Positron::PositronDefinition() ||
+           &particle == G4Gamma::GammaDefinition();
+  }
+
+  G4bool CaloFastSimModel::ModelTrigger(G4FastTrack const& fastTrack){
+
+    if ( fastTrack.GetPrimaryTrack()->GetKineticEnergy() < _minEnergy ) return false;
+
+    // only particles entering the envelope, the secondaries inside are left to G4
+    G4VSolid const* solid = fastTrack.GetEnvelopeSolid();
+    G4ThreeVector const& localPos = fastTrack.GetPrimaryTrackLocalPosition();
+    if ( solid->Inside(localPos) != kSurface ) return false;
+    if ( solid->SurfaceNormal(localPos).dot(fastTrack.GetPrimaryTrackLocalDirection()) >= 0. ) return false;
+
+    int diskId(0);
+    CLHEP::Hep3Vector posDisk, dir;
+    int ibin = entryBin(fastTrack,diskId,posDisk,dir);
+    return ibin >= 0 && !_library.showers(ibin).empty();
+  }
+
+  void CaloFastSimModel::DoIt(G4FastTrack const& fastTrack, G4FastStep& fastStep){
+
+    G4Track const* track = fastTrack.GetPrimaryTrack();
+    double energy   = track->GetKineticEnergy();
+    double time     = track->GetGlobalTime();
+    double momentum = track->GetMomentum().mag();
+
+    int diskId(0);
+    CLHEP::Hep3Vector posDisk, dir;
+    int ibin = entryBin(fastTrack,diskId,posDisk,dir);
+
+    auto const& showers = _library.showers(ibin);
+    std::size_t ishower = std::min(std::size_t(G4UniformRand()*showers.size()),showers.size()-1);
+
+    CLHEP::Hep3Vector u, v;
+    CaloShowerLibrary::frame(posDisk,dir,u,v);
+
+    for ( auto const& dep : showers[ishower].deposits ) {
+      CLHEP::Hep3Vector pos = _cal->geomUtil().diskToMu2e(diskId,posDisk + dep.u*u + dep.v*v + dep.w*dir);
+      int crystalId = _cal->crystalIdxFromPosition(pos);
+      if ( crystalId < 0 ) continue;
+      _crystalSD->addFastDeposit(track,crystalId,time+dep.time,dep.efrac*energy,momentum,pos);
+    }
+
+    fastStep.KillPrimaryTrack();
+    fastStep.ProposePrimaryTrackPathLength(0.);
+    fastStep.ProposeTotalEnergyDeposited(energy);
+  }
+
+  int CaloFastSimModel::entryBin(G4FastTrack const& fastTrack, int& diskId,
+                                 CLHEP::Hep3Vector& posDisk, CLHEP::Hep3Vector& dir) const {
+
+    G4Track const* track = fastTrack.GetPrimaryTrack();
+    CLHEP::Hep3Vector pos = track->GetPosition() - _mu2eOrigin;
+
+    // the envelope entered is the one of the closest disk
+    diskId = 0;
+    for ( unsigned idisk=1; idisk<_cal->nDisk(); ++idisk ) {
+      if ( std::abs(pos.z()-_cal->disk(idisk).geomInfo().origin().z()) <
+           std::abs(pos.z()-_cal->disk(diskId).geomInfo().origin().z()) ) diskId = idisk;
+    }
+
+    posDisk = _cal->geomUtil().mu2eToDisk(diskId,pos);
+    dir     = (_cal->geomUtil().mu2eToDisk(diskId,pos+track->GetMomentumDirection()) - posDisk).unit();
+
+    int ptype = _library.particleType(track->GetDefinition()->GetPDGEncoding());
+    return _library.bin(ptype,track->GetKineticEnergy(),dir.z(),posDisk.perp());
+  }
+
+} // end namespace mu2e
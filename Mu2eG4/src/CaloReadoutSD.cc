@@ -33,7 +33,10 @@
 namespace mu2e {
 
     CaloReadoutSD::CaloReadoutSD(G4String name, SimpleConfig const & config ):
-      Mu2eSensitiveDetector(name,config),_nro(0)
+      Mu2eSensitiveDetector(name,config),_nro(0),
+      _showerSteps(nullptr),
+      _keepStepPoints(true),
+      _showerStepMaker(config,false)
     {
 	GeomHandle<Calorimeter> cg;
 	_nro  = cg->caloInfo().nROPerCrystal();
@@ -64,20 +67,48 @@ namespace mu2e {
 	 //for diagnosis purposes only when playing with the geometry, uncomment next line
  	 //for (int i=0;i<=touchableHandle->GetHistoryDepth();++i) std::cout<<"cryRO Transform level "<<i<<"   "<<touchableHandle->GetCopyNumber(i)<<std::endl;
 
-	 _collection->push_back(StepPointMC(_spHelper->particlePtr(aStep->GetTrack()),
-                                	    idro,
-                                	    aStep->GetTotalEnergyDeposit(),
-                                	    aStep->GetNonIonizingEnergyDeposit(),
-                                	    aStep->GetPreStepPoint()->GetGlobalTime(),
-                                	    aStep->GetPreStepPoint()->GetProperTime(),
-                                	    aStep->GetPreStepPoint()->GetPosition() - _mu2eOrigin,
-                                	    aStep->GetPreStepPoint()->GetMomentum(),
-                                	    aStep->GetStepLength(),
-                                	    endCode
-                                	    ) );
+	 if (_showerSteps != nullptr)
+	   _showerStepMaker.addStep(aStep,idro,aStep->GetPreStepPoint()->GetPosition() - _mu2eOrigin,endCode);
+
+	 if (_keepStepPoints)
+	   _collection->push_back(StepPointMC(_spHelper->particlePtr(aStep->GetTrack()),
+                                	      idro,
+                                	      aStep->GetTotalEnergyDeposit(),
+                                	      aStep->GetNonIonizingEnergyDeposit(),
+                                	      aStep->GetPreStepPoint()->GetGlobalTime(),
+                                	      aStep->GetPreStepPoint()->GetProperTime(),
+                                	      aStep->GetPreStepPoint()->GetPosition() - _mu2eOrigin,
+                                	      aStep->GetPreStepPoint()->GetMomentum(),
+                                	      aStep->GetStepLength(),
+                                	      endCode
+                                	      ) );
 
 	 return true;
     }
 
 
+    void CaloReadoutSD::Initialize(G4HCofThisEvent* HCE)
+    {
+        Mu2eSensitiveDetector::Initialize(HCE);
+        _showerStepMaker.clear();
+    }
+
+
+    void CaloReadoutSD::EndOfEvent(G4HCofThisEvent* HCE)
+    {
+        Mu2eSensitiveDetector::EndOfEvent(HCE);
+        if (_showerSteps == nullptr) return;
+
+        _showerStepMaker.fill(*_showerSteps,*_spHelper);
+        _showerStepMaker.clear();
+    }
+
+
+    void CaloReadoutSD::setShowerStepOutput(CaloShowerStepCollection* showerSteps, bool keepStepPoints)
+    {
+        _showerSteps    = showerSteps;
+        _keepStepPoints = keepStepPoints || showerSteps == nullptr;
+    }
+
+
 } 
@@ -0,0 +1,324 @@
+//
+// Sum the G4 steps of the calorimeter sensitive detectors into CaloShowerSteps.
+// See the header file for the description of the algorithm.
+//
+
+#include <algorithm>
+#include <cmath>
+
+// Framework includes
+#include "cetlib_except/exception.h"
+
+// Mu2e includes
+#include "Mu2eG4/inc/CaloShowerStepMaker.hh"
+#include "Mu2eG4/inc/SimParticleHelper.hh"
+#include "CalorimeterGeom/inc/Calorimeter.hh"
+#include "GeometryService/inc/GeomHandle.hh"
+#include "ConfigTools/inc/SimpleConfig.hh"
+
+// CLHEP includes
+#include "CLHEP/Matrix/SymMatrix.h"
+
+// G4 includes
+#include "G4Step.hh"
+#include "G4Track.hh"
+
+namespace mu2e {
+
+  CaloShowerStepMaker::CaloShowerStepMaker(SimpleConfig const& config, bool isCrystal):
+    _isCrystal(isCrystal),
+    _numZSlices(config.getInt("calorimeter.showerSteps.numZSlices",20)),
+    _deltaTime(config.getDouble("calorimeter.showerSteps.deltaTime",0.2)),
+    _zSliceSize(0.),
+    _nsteps(0),
+    _cal(nullptr),
+    _procCodes(),
+    _buckets(),
+    _openBuckets(),
+    _tracks()
+  {
+    if ( _numZSlices < 1 ) {
+      throw cet::exception("CONFIG")
+        << "CaloShowerStepMaker: calorimeter.showerSteps.numZSlices must be positive\n";
+    }
+
+    GeomHandle<Calorimeter> cal;
+    _cal        = cal.get();
+    _zSliceSize = (_cal->caloInfo().getDouble("crystalZLength")+0.01)/float(_numZSlices);
+
+    // Same process codes as CaloShowerStepFromStepPt, see MCDataProducts/inc/ProcessCode.hh
+    // --- These are hardcoded to make sure changes are intended and carefully considered ---
+    _procCodes[11].insert(   {2,16,17,21,23,29,40,49,58} );    // electron
+    _procCodes[-11].insert(  {2,16,17,21,23,29,40,49,58} );    // positron
+    _procCodes[22].insert(   {2,12,16,17,21,23,29,40,49,58} ); // photon
+    _procCodes[2112].insert( {2,16,17,21,23,29,40,49,58,74} ); // neutron
+    _procCodes[2212].insert( {16,17,21,23,29,40,45,49,58} );   // proton
+    if ( config.getBool("calorimeter.showerSteps.compressMuons",false) ) {
+      _procCodes[13].insert(  {2,12,16,17,21,23,29,30,31,34,40,49,58,59} );  // mu-
+      _procCodes[-13].insert( {2,12,16,17,21,23,29,30,31,34,40,49,58,59} );  // mu+
+    }
+  }
+
+
+  void CaloShowerStepMaker::clear(){
+    _buckets.clear();
+    _openBuckets.clear();
+    _tracks.clear();
+    _nsteps = 0;
+  }
+
+
+  void CaloShowerStepMaker::addTrack(G4Step const* aStep, CLHEP::Hep3Vector const& mu2eOrigin){
+
+    if ( !_isCrystal ) return;
+
+    TrackInfo& info = registerTrack(aStep->GetTrack(),mu2eOrigin);
+    info.endPos = aStep->GetPostStepPoint()->GetPosition() - mu2eOrigin;
+  }
+
+
+  CaloShowerStepMaker::TrackInfo& CaloShowerStepMaker::registerTrack(G4Track const* track,
+                                                                     CLHEP::Hep3Vector const& mu2eOrigin){
+
+    auto ins = _tracks.emplace(track->GetTrackID(),TrackInfo());
+    TrackInfo& info = ins.first->second;
+    if ( ins.second ) {
+      double mass = track->GetDefinition()->GetPDGMass();
+      double ekin = track->GetVertexKineticEnergy();
+      info.parentId = track->GetParentID();
+      info.pdgId    = track->GetDefinition()->GetPDGEncoding();
+      info.startMom = std::sqrt(ekin*(ekin+2.*mass));
+      info.startPos = track->GetVertexPosition() - mu2eOrigin;
+      info.inside   = _cal->geomUtil().isInsideCalorimeter(info.startPos);
+    }
+    return info;
+  }
+
+
+  void CaloShowerStepMaker::addStep(G4Step const* aStep, int volId,
+                                    CLHEP::Hep3Vector const& posMu2e, ProcessCode endCode){
+
+    G4StepPoint const* pre = aStep->GetPreStepPoint();
+    int trackId = aStep->GetTrack()->GetTrackID();
+
+    addToBucket(volId, trackId, pre->GetGlobalTime(),
+                aStep->GetTotalEnergyDeposit(),
+                pre->GetMomentum().mag(), posMu2e);
+
+    if ( _isCrystal ) _tracks[trackId].procs.set(endCode.id());
+  }
+
+
+  // The fast simulation deposits carry no process code, so a library shower is always compressible.
+  void CaloShowerStepMaker::addDeposit(G4Track const* track, int volId, double time, double edep,
+                                       double momentum, CLHEP::Hep3Vector const& posMu2e,
+                                       CLHEP::Hep3Vector const& mu2eOrigin){
+
+    if ( _isCrystal ) registerTrack(track,mu2eOrigin).endPos = posMu2e;
+    addToBucket(volId, track->GetTrackID(), time, edep, momentum, posMu2e);
+  }
+
+
+  void CaloShowerStepMaker::addToBucket(int volId, int trackId, double time, double edep,
+                                        double momentum, CLHEP::Hep3Vector const& posMu2e){
+
+    ++_nsteps;
+
+    int crystalId = _isCrystal ? volId : _cal->caloInfo().crystalByRO(volId);
+    CLHEP::Hep3Vector pos = _cal->geomUtil().mu2eToCrystal(crystalId,posMu2e);
+    int slice = _isCrystal ? std::min(int(std::max(1e-6,pos.z())/_zSliceSize),_numZSlices-1) : 0;
+
+    // The steps of a track come in time order, so the bucket of the first step is the
+    // one CaloShowerStepFromStepPt would have filled.
+    auto ins = _openBuckets.emplace(BucketKey(volId,trackId,slice),_buckets.size());
+    if ( ins.second || time - _buckets[ins.first->second].t0 > _deltaTime ) {
+      Bucket bucket;
+      bucket.volId   = volId;
+      bucket.trackId = trackId;
+      bucket.slice   = slice;
+      bucket.t0      = time;
+      bucket.pIn     = momentum;
+      bucket.posIn   = pos;
+      ins.first->second = _buckets.size();
+      _buckets.push_back(bucket);
+    }
+    _buckets[ins.first->second].add(edep,time,momentum,pos);
+  }
+
+
+  void CaloShowerStepMaker::fill(CaloShowerStepCollection& showerSteps, SimParticleHelper const& spHelper){
+
+    _openBuckets.clear();
+
+    // Buckets of each track, ordered by volume and time
+    std::map<int,std::vector<Bucket const*>> trackBuckets;
+    for ( auto const& bucket : _buckets ) trackBuckets[bucket.trackId].push_back(&bucket);
+    for ( auto& itrk : trackBuckets ) {
+      std::stable_sort(itrk.second.begin(),itrk.second.end(),
+                       [](Bucket const* a, Bucket const* b){ return a->volId < b->volId ||
+                           (a->volId == b->volId && a->t0 < b->t0); });
+    }
+
+    if ( !_isCrystal ) {
+      for ( auto const& itrk : trackBuckets ) {
+        for ( Bucket const* bucket : itrk.second ) addShowerStep(*bucket,itrk.first,showerSteps,spHelper);
+      }
+      return;
+    }
+
+    std::map<int,std::vector<int>> showers;
+    for ( auto const& itrk : trackBuckets ) showers[ancestorOf(itrk.first)].push_back(itrk.first);
+
+    for ( auto const& ishower : showers ) {
+
+      int ancestor = ishower.first;
+      std::vector<int> const& tracks = ishower.second;
+
+      if ( isCompressible(ancestor,tracks) ) {
+        std::map<int,std::vector<Bucket const*>> volBuckets;
+        for ( int trackId : tracks ) {
+          for ( Bucket const* bucket : trackBuckets[trackId] ) volBuckets[bucket->volId].push_back(bucket);
+        }
+        for ( auto& ivol : volBuckets ) mergeBuckets(ivol.second,ancestor,showerSteps,spHelper);
+      } else {
+        for ( int trackId : tracks ) {
+          for ( Bucket const* bucket : trackBuckets[trackId] ) addShowerStep(*bucket,trackId,showerSteps,spHelper);
+        }
+      }
+    }
+  }
+
+
+  // Walk up the parents while they start inside the calorimeter and stay in one section,
+  // as CaloShowerStepFromStepPt::collectStepBySimAncestor.  The end of a track is the last
+  // point it was seen in the calorimeter volumes.
+  int CaloShowerStepMaker::ancestorOf(int trackId){
+
+    std::vector<int> inspected;
+    int current = trackId;
+    while ( true ) {
+      auto it = _tracks.find(current);
+      if ( it == _tracks.end() ) break;
+
+      TrackInfo const& info = it->second;
+      if ( info.parentId == 0 || !info.inside ) break;
+      if ( !_cal->geomUtil().isContainedSection(info.startPos,info.endPos) ) break;
+      if ( info.ancestor >= 0 ) { current = info.ancestor; break; }
+
+      inspected.push_back(current);
+      current = info.parentId;
+    }
+
+    for ( int id : inspected ) _tracks[id].ancestor = current;
+    return current;
+  }
+
+
+  bool CaloShowerStepMaker::isCompressible(int ancestorId, std::vector<int> const& tracks) const {
+
+    // an ancestor that never reached a crystal: keep one step per track
+    auto it = _tracks.find(ancestorId);
+    if ( it == _tracks.end() ) return false;
+
+    int pdgId = it->second.pdgId;
+    if ( pdgId > 1000000000 ) return true;  //ions are always compressed
+
+    auto ip = _procCodes.find(pdgId);
+    if ( ip == _procCodes.end() ) return false;
+
+    ProcessBits procs;
+    for ( int trackId : tracks ) procs |= _tracks.at(trackId).procs;
+    for ( std::size_t i=0; i<procs.size(); ++i ) {
+      if ( procs.test(i) && ip->second.find(i) == ip->second.end() ) return false;
+    }
+
+    if ( pdgId == 2212 || pdgId == 2112 ) {
+      for ( int trackId : tracks ) {
+        if ( trackId == ancestorId ) continue;
+        TrackInfo const& info = _tracks.at(trackId);
+        if ( info.pdgId == 22 || std::abs(info.pdgId) == 11 ) {
+          if ( info.startMom > 1 ) return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+
+  // Merge the per-track buckets of one volume; a merged bucket is closed when a bucket
+  // starts more than deltaTime after it.
+  void CaloShowerStepMaker::mergeBuckets(std::vector<Bucket const*>& buckets, int simId,
+                                         CaloShowerStepCollection& showerSteps,
+                                         SimParticleHelper const& spHelper) const {
+
+    std::sort(buckets.begin(),buckets.end(),
+              [](Bucket const* a, Bucket const* b){ return a->slice < b->slice ||
+                  (a->slice == b->slice && a->t0 < b->t0); });
+
+    Bucket merged = *buckets.front();
+    for ( auto ib=buckets.begin()+1; ib != buckets.end(); ++ib ) {
+      Bucket const& bucket = **ib;
+      if ( bucket.slice == merged.slice && bucket.t0 - merged.t0 <= _deltaTime ) {
+        merged.merge(bucket);
+      } else {
+        addShowerStep(merged,simId,showerSteps,spHelper);
+        merged = bucket;
+      }
+    }
+    addShowerStep(merged,simId,showerSteps,spHelper);
+  }
+
+
+  void CaloShowerStepMaker::addShowerStep(Bucket const& bucket, int simId,
+                                          CaloShowerStepCollection& showerSteps,
+                                          SimParticleHelper const& spHelper) const {
+
+    CLHEP::Hep3Vector pos(bucket.x/bucket.w,bucket.y/bucket.w,bucket.z/bucket.w);
+
+    double norm = bucket.w/(bucket.w*bucket.w-bucket.w2);
+    CLHEP::HepSymMatrix cov(3,0);
+    cov[0][0] = norm*(bucket.x2 - bucket.x*bucket.x/bucket.w);
+    cov[1][1] = norm*(bucket.y2 - bucket.y*bucket.y/bucket.w);
+    cov[2][2] = norm*(bucket.z2 - bucket.z*bucket.z/bucket.w);
+    cov[0][1] = norm*(bucket.xy - bucket.x*bucket.y/bucket.w);
+    cov[0][2] = norm*(bucket.xz - bucket.x*bucket.z/bucket.w);
+    cov[1][2] = norm*(bucket.yz - bucket.y*bucket.z/bucket.w);
+
+    showerSteps.push_back(CaloShowerStep(bucket.volId, spHelper.particlePtrFromG4TrackID(simId),
+                                         bucket.n, bucket.t/bucket.w, bucket.edep, bucket.pIn,
+                                         bucket.posIn, pos, cov));
+  }
+
+
+  void CaloShowerStepMaker::Bucket::add(double e, double time, double p, CLHEP::Hep3Vector const& pos){
+    n    += 1;
+    edep += e;
+    pIn   = std::max(pIn,p);
+    t    += time*e;
+    x    += pos.x()*e;
+    y    += pos.y()*e;
+    z    += pos.z()*e;
+    x2   += pos.x()*pos.x()*e;
+    y2   += pos.y()*pos.y()*e;
+    z2   += pos.z()*pos.z()*e;
+    xy   += pos.x()*pos.y()*e;
+    xz   += pos.x()*pos.z()*e;
+    yz   += pos.y()*pos.z()*e;
+    w    += e;
+    w2   += e*e;
+  }
+
+  void CaloShowerStepMaker::Bucket::merge(Bucket const& other){
+    n    += other.n;
+    edep += other.edep;
+    pIn   = std::max(pIn,other.pIn);
+    t    += other.t;
+    x    += other.x;   y  += other.y;   z  += other.z;
+    x2   += other.x2;  y2 += other.y2; z2 += other.z2;
+    xy   += other.xy;  xz += other.xz; yz += other.yz;
+    w    += other.w;
+    w2   += other.w2;
+  }
+
+} // end namespace mu2e
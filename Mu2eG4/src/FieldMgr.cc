@@ -11,7 +11,19 @@
 // G4 includes.
 #include "G4UniformMagField.hh"
 #include "G4Mag_UsualEqRhs.hh"
+#include "G4Mag_SpinEqRhs.hh"
 #include "G4ExactHelixStepper.hh"
+#include "G4ClassicalRK4.hh"
+#include "G4ImplicitEuler.hh"
+#include "G4ExplicitEuler.hh"
+#include "G4SimpleRunge.hh"
+#include "G4SimpleHeum.hh"
+#include "G4HelixImplicitEuler.hh"
+#include "G4HelixSimpleRunge.hh"
+#if G4VERSION>4103
+#include "G4DormandPrince745.hh"
+#include "G4BogackiShampine23.hh"
+#endif
 #include "G4ChordFinder.hh"
 #include "G4FieldManager.hh"
 
@@ -19,6 +31,8 @@
 #include "Mu2eG4/inc/FieldMgr.hh"
 #include "Mu2eG4/inc/DSGradientField.hh"
 
+#include "cetlib_except/exception.h"
+
 using namespace std;
 
 namespace mu2e {
@@ -67,6 +81,80 @@ namespace mu2e {
     return std::move(mgr);
   }
 
+  // Factory method to construct a manager for the field map in one region.  See notes in header file.
+  std::unique_ptr<FieldMgr> FieldMgr::forRegion(const std::string& region,
+                                                const std::string& stepperName,
+                                                const G4ThreeVector& mu2eOrigin,
+                                                double stepMinimum ){
+
+    unique_ptr<FieldMgr> mgr(new FieldMgr() );
+
+    auto counts = FieldRegionCounters::book(region);
+
+    if ( stepperName == "FieldOff" ){
+      mgr->_manager   = std::unique_ptr<G4FieldManager>         (new CountingFieldManager ( nullptr, nullptr, counts ));
+      return mgr;
+    }
+
+    mgr->_field       = std::unique_ptr<G4MagneticField>        (new CountingMagneticField( new Mu2eGlobalField(mu2eOrigin),
+                                                                                            counts ));
+    G4Mag_EqRhs* rhs  = new G4Mag_UsualEqRhs( mgr->field() );
+    mgr->_integrator  = std::unique_ptr<G4MagIntegratorStepper> (makeStepper          ( stepperName, mgr->field(), rhs ));
+    mgr->_rhs         = std::unique_ptr<G4Mag_EqRhs>            (rhs);
+    mgr->_chordFinder = std::unique_ptr<G4ChordFinder>          (new G4ChordFinder     ( mgr->field(),
+                                                                                         stepMinimum,
+                                                                                         mgr->integrator()) );
+    mgr->_manager     = std::unique_ptr<G4FieldManager>         (new CountingFieldManager( mgr->field(),
+                                                                                           mgr->chordFinder(),
+                                                                                           counts ));
+    return mgr;
+  }
+
+  // Make a G4 stepper from its name.
+  G4MagIntegratorStepper* FieldMgr::makeStepper(const std::string& stepperName,
+                                                G4MagneticField* field,
+                                                G4Mag_EqRhs*& rhs ){
+
+    if ( stepperName  == "G4ClassicalRK4" ) {
+      return new G4ClassicalRK4(rhs);
+    } else if ( stepperName  == "G4ClassicalRK4WSpin" ) {
+      delete rhs;
+      rhs = new G4Mag_SpinEqRhs(field);
+      return new G4ClassicalRK4(rhs, 12);
+#if G4VERSION>4103
+    } else if ( stepperName  == "G4DormandPrince745WSpin" ) {
+      delete rhs;
+      rhs = new G4Mag_SpinEqRhs(field);
+      return new G4DormandPrince745(rhs, 12);
+#endif
+    } else if ( stepperName  == "G4ExactHelixStepper" ) {
+      return new G4ExactHelixStepper(rhs);
+    } else if ( stepperName  == "G4ImplicitEuler" ) {
+      return new G4ImplicitEuler(rhs);
+    } else if ( stepperName  == "G4ExplicitEuler" ) {
+      return new G4ExplicitEuler(rhs);
+    } else if ( stepperName  == "G4SimpleHeum" ) {
+      return new G4SimpleHeum(rhs);
+    } else if ( stepperName  == "G4HelixImplicitEuler" ) {
+      return new G4HelixImplicitEuler(rhs);
+    } else if ( stepperName  == "G4HelixSimpleRunge" ) {
+      return new G4HelixSimpleRunge(rhs);
+#if G4VERSION>4103
+    } else if ( stepperName  == "G4DormandPrince745" ) {
+      return new G4DormandPrince745(rhs);
+    } else if ( stepperName  == "G4BogackiShampine23" ) {
+      return new G4BogackiShampine23(rhs);
+#endif
+    } else if ( stepperName  == "G4SimpleRunge" ) {
+      return new G4SimpleRunge(rhs);
+    }
+
+    throw cet::exception("GEOM")
+      << "Unrecognized stepper : "
+      << stepperName
+      << "\n";
+  }
+
   // Release all of the objects that this class owns.
   void FieldMgr::release(){
     _field.release();
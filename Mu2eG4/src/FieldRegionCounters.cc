@@ -0,0 +1,81 @@
+//
+// Count the G4 steps and the magnetic field evaluations per region of magnetic field.
+//
+
+// Mu2e includes
+#include "Mu2eG4/inc/FieldRegionCounters.hh"
+
+// G4 includes
+#include "G4ChordFinder.hh"
+
+// C++ includes
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace mu2e {
+
+  namespace {
+
+    // All counters booked so far, by region.  The map is ordered so that the
+    // regions are always printed in the same order.
+    std::mutex registryMutex;
+    std::map<std::string, std::vector<std::shared_ptr<FieldRegionCounters::Counts>>> registry;
+
+  }
+
+  std::shared_ptr<FieldRegionCounters::Counts> FieldRegionCounters::book( const std::string& region ){
+    auto counts = std::make_shared<Counts>();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry[region].push_back(counts);
+    return counts;
+  }
+
+  void FieldRegionCounters::print( std::ostream& os ){
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if ( registry.empty() ) return;
+
+    std::ios_base::fmtflags flags(os.flags());
+    std::streamsize precision(os.precision());
+
+    os << "FieldRegionCounters: steps and field evaluations per region of magnetic field\n"
+       << "   " << std::setw(15) << std::left << "region"
+       << std::right << std::setw(16) << "steps"
+       << std::setw(16) << "field calls"
+       << std::setw(12) << "calls/step" << "\n";
+
+    for ( auto const& region : registry ){
+      unsigned long long steps(0), fieldCalls(0);
+      for ( auto const& counts : region.second ){
+        steps      += counts->steps;
+        fieldCalls += counts->fieldCalls;
+      }
+      os << "   " << std::setw(15) << std::left << region.first
+         << std::right << std::setw(16) << steps
+         << std::setw(16) << fieldCalls
+         << std::setw(12) << std::fixed << std::setprecision(1)
+         << ( steps > 0 ? double(fieldCalls)/double(steps) : 0. ) << "\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+    os << std::flush;
+  }
+
+  CountingMagneticField::CountingMagneticField( G4MagneticField* field,
+                                                std::shared_ptr<FieldRegionCounters::Counts> counts ):
+    G4MagneticField(),
+    _field(field),
+    _counts(counts){
+  }
+
+  CountingFieldManager::CountingFieldManager( G4MagneticField* field, G4ChordFinder* chordFinder,
+                                              std::shared_ptr<FieldRegionCounters::Counts> counts ):
+    G4FieldManager(field,chordFinder,true),
+    _counts(counts){
+  }
+
+} // end namespace mu2e
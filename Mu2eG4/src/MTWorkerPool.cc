@@ -0,0 +1,134 @@
+//
+//
+// Implementation of the MTWorkerPool class, see the header for the description.
+//
+//
+
+//Mu2e includes
+#include "Mu2eG4/inc/MTWorkerPool.hh"
+#include "Mu2eG4/inc/Mu2eG4WorkerRunManager.hh"
+
+//art includes
+#include "fhiclcpp/ParameterSet.h"
+
+//TBB includes
+#include "tbb/task_arena.h"
+#include "tbb/task_group.h"
+
+//C++ includes
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+
+using namespace std;
+
+namespace mu2e {
+
+MTWorkerPool::MTWorkerPool(const fhicl::ParameterSet& pset, int nThreads)
+    :
+    pset_(pset),
+    nThreads_(nThreads),
+    masterRM_(nullptr),
+    originInWorld_(),
+    runNumber_(0),
+    workers_()
+    {}
+
+
+MTWorkerPool::~MTWorkerPool()
+    {
+        if (!workers_.empty()) {
+            destroyWorkers();
+        }
+    }
+
+
+void MTWorkerPool::beginRun(Mu2eG4MTRunManager* masterRM,
+                            const G4ThreeVector& origin_in_world,
+                            art::RunNumber_t run_number) {
+
+    masterRM_ = masterRM;
+    originInWorld_ = origin_in_world;
+    runNumber_ = run_number;
+
+    runOnEachThread([this]() { makeWorker()->initializeRun(runNumber_); });
+    std::cout << "MTWorkerPool: " << workers_.size() << " workers ready for run " << runNumber_ << std::endl;
+}
+
+
+void MTWorkerPool::endRun() {
+
+    runOnEachThread([this]() {
+        WorkerMap::accessor access_workerMap;
+        if (workers_.find(access_workerMap, std::this_thread::get_id())) {
+            access_workerMap->second->terminateRun();
+        }
+    });
+}
+
+
+void MTWorkerPool::destroyWorkers() {
+
+    runOnEachThread([this]() {
+        WorkerMap::accessor access_workerMap;
+        if (workers_.find(access_workerMap, std::this_thread::get_id())) {
+            access_workerMap->second.reset();
+        }
+    });
+    workers_.clear();
+}
+
+
+Mu2eG4WorkerRunManager* MTWorkerPool::worker() {
+
+    Mu2eG4WorkerRunManager* workerRM = makeWorker();
+    workerRM->initializeRun(runNumber_);
+    return workerRM;
+}
+
+
+Mu2eG4WorkerRunManager* MTWorkerPool::makeWorker() {
+
+    auto const tid = std::this_thread::get_id();
+
+    // only the calling thread uses this entry, holding the accessor while the worker
+    // is initialized does not block the other threads
+    WorkerMap::accessor access_workerMap;
+    if (workers_.insert(access_workerMap, tid)) {
+        std::cout << "MTWorkerPool: making the worker of thread " << tid << std::endl;
+        access_workerMap->second = std::make_unique<Mu2eG4WorkerRunManager>(pset_, tid);
+        access_workerMap->second->initializeThread(masterRM_, originInWorld_);
+    }
+    return access_workerMap->second.get();
+}
+
+
+// The tasks block, they do not spin, until all of them have started; as there are as
+// many tasks as threads, each thread of the arena runs exactly one of them.  The wait
+// is isolated so that the calling thread does not pick up unrelated work meanwhile.
+void MTWorkerPool::runOnEachThread(const std::function<void()>& task) {
+
+    std::mutex barrierMutex;
+    std::condition_variable allStarted;
+    int nStarted(0);
+
+    tbb::this_task_arena::isolate([&]() {
+        tbb::task_group g;
+        for (int i = 0; i < nThreads_; ++i) {
+            g.run([&]() {
+                {
+                    std::unique_lock<std::mutex> lk(barrierMutex);
+                    if (++nStarted == nThreads_) {
+                        allStarted.notify_all();
+                    } else {
+                        allStarted.wait(lk, [&]() { return nStarted == nThreads_; });
+                    }
+                }
+                task();
+            });
+        }
+        g.wait();
+    });
+}
+
+}// end namespace mu2e
@@ -0,0 +1,139 @@
+// Variance reduction in Mu2eG4: Russian roulette and geometric splitting.
+
+#include <limits>
+
+#include "cetlib_except/exception.h"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VTouchable.hh"
+#include "G4VPhysicalVolume.hh"
+#include "Randomize.hh"
+
+#include "Mu2eG4/inc/Mu2eG4Biasing.hh"
+#include "Mu2eG4/inc/getPhysicalVolumeOrThrow.hh"
+
+namespace mu2e {
+
+  Mu2eG4Biasing::Mu2eG4Biasing(const fhicl::ParameterSet& pset)
+    : rouletteConfig_(pset.get<std::vector<fhicl::ParameterSet> >("roulette", {}))
+    , importanceConfig_(pset.get<std::vector<fhicl::ParameterSet> >("importance", {}))
+  {
+    for(const auto& p: rouletteConfig_) {
+      const double prob = p.get<double>("survivalProbability");
+      if(!(prob > 0. && prob <= 1.)) {
+        throw cet::exception("CONFIG")<<"Mu2eG4Biasing: roulette survivalProbability must be in (0,1], got "
+                                      <<prob<<"\n";
+      }
+    }
+
+    for(const auto& p: importanceConfig_) {
+      const auto vols = p.get<std::vector<std::string> >("volumes");
+      const auto imps = p.get<std::vector<double> >("importances");
+      if(vols.size() != imps.size()) {
+        throw cet::exception("CONFIG")<<"Mu2eG4Biasing: importance needs one importance per volume, got "
+                                      <<vols.size()<<" volumes and "<<imps.size()<<" importances\n";
+      }
+      for(const auto imp: imps) {
+        if(!(imp > 0.)) {
+          throw cet::exception("CONFIG")<<"Mu2eG4Biasing: volume importances must be positive, got "
+                                        <<imp<<"\n";
+        }
+      }
+    }
+  }
+
+  void Mu2eG4Biasing::finishConstruction() {
+
+    roulette_.clear();
+    for(const auto& p: rouletteConfig_) {
+      Roulette r;
+      for(const auto& vol: p.get<std::vector<std::string> >("volumes", {})) {
+        r.volumes.insert(getPhysicalVolumeOrThrow(vol));
+      }
+      const auto ids = p.get<std::vector<int> >("pdgIds", {});
+      r.pdgIds.insert(ids.begin(), ids.end());
+      r.survivalProbability = p.get<double>("survivalProbability");
+      r.maxKineticEnergy = p.get<double>("maxKineticEnergy", std::numeric_limits<double>::max());
+      roulette_.push_back(r);
+    }
+
+    importance_.clear();
+    for(const auto& p: importanceConfig_) {
+      Importance imp;
+      const auto vols = p.get<std::vector<std::string> >("volumes");
+      const auto imps = p.get<std::vector<double> >("importances");
+      for(unsigned i=0; i<vols.size(); ++i) {
+        imp.volumes[getPhysicalVolumeOrThrow(vols[i])] = imps[i];
+      }
+      const auto ids = p.get<std::vector<int> >("pdgIds", {});
+      imp.pdgIds.insert(ids.begin(), ids.end());
+      importance_.push_back(imp);
+    }
+  }
+
+  bool Mu2eG4Biasing::stackingRoulette(G4Track* trk) const {
+    if(roulette_.empty() || trk->GetParentID() == 0) {
+      return false;
+    }
+
+    const int pdgId = trk->GetDefinition()->GetPDGEncoding();
+    for(const auto& r: roulette_) {
+      if(!hasParticle(r.pdgIds, pdgId)) continue;
+      if(trk->GetKineticEnergy() > r.maxKineticEnergy) continue;
+      if(!r.volumes.empty() && r.volumes.count(trk->GetVolume()) == 0) continue;
+
+      // the first matching entry decides
+      if(G4UniformRand() >= r.survivalProbability) {
+        return true;
+      }
+      trk->SetWeight(trk->GetWeight()/r.survivalProbability);
+      return false;
+    }
+    return false;
+  }
+
+  int Mu2eG4Biasing::splitting(const G4Step* step, double& newWeight) const {
+    if(importance_.empty()) {
+      return -1;
+    }
+
+    const G4StepPoint* postpt = step->GetPostStepPoint();
+    const G4Track* trk = step->GetTrack();
+    if(postpt->GetStepStatus() != fGeomBoundary || !postpt->GetPhysicalVolume() ||
+       trk->GetTrackStatus() != fAlive) {
+      return -1;
+    }
+
+    const int pdgId = trk->GetDefinition()->GetPDGEncoding();
+    for(const auto& imp: importance_) {
+      if(!hasParticle(imp.pdgIds, pdgId)) continue;
+
+      const double iold = importance(imp, step->GetPreStepPoint()->GetTouchable());
+      const double inew = importance(imp, postpt->GetTouchable());
+      if(inew == iold) {
+        return -1;
+      }
+
+      const double ratio = inew/iold;
+      newWeight = trk->GetWeight()/ratio;
+      if(ratio < 1.) {
+        return (G4UniformRand() < ratio) ? 1 : 0;
+      }
+      const int n = int(ratio);
+      return (G4UniformRand() < ratio - n) ? n + 1 : n;
+    }
+    return -1;
+  }
+
+  double Mu2eG4Biasing::importance(const Importance& imp, const G4VTouchable* touchable) const {
+    for(int depth = 0; depth <= touchable->GetHistoryDepth(); ++depth) {
+      const auto i = imp.volumes.find(touchable->GetVolume(depth));
+      if(i != imp.volumes.end()) {
+        return i->second;
+      }
+    }
+    return 1.;
+  }
+
+} // end namespace mu2e
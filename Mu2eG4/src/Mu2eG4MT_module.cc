@@ -16,6 +16,7 @@
 #include "GeometryService/inc/GeomHandle.hh"
 #include "GeometryService/inc/WorldG4.hh"
 #include "Mu2eG4/inc/PhysicalVolumeHelper.hh"
+#include "Mu2eG4/inc/FieldRegionCounters.hh"
 #include "ConfigTools/inc/ConfigFileLookupPolicy.hh"
 #include "SeedService/inc/SeedService.hh"
 #include "Mu2eG4/inc/Mu2eG4ResourceLimits.hh"
@@ -24,6 +25,7 @@
 #include "Mu2eG4/inc/Mu2eG4MTRunManager.hh"
 #include "Mu2eG4/inc/Mu2eG4WorkerRunManager.hh"
 #include "Mu2eG4/inc/MTMasterThread.hh"
+#include "Mu2eG4/inc/MTWorkerPool.hh"
 #include "Mu2eG4/inc/SimParticleHelper.hh"
 #include "Mu2eG4/inc/SimParticlePrimaryHelper.hh"
 
@@ -50,6 +52,8 @@
 #include "G4Run.hh"
 
 // C++ includes.
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
@@ -61,28 +65,26 @@
 #include <vector>
 
 // TBB includes
-#include "tbb/concurrent_hash_map.h"
+#include "tbb/task_arena.h"
 #include "tbb/task_group.h"
 
 using namespace std;
 
 namespace {
   art::InputTag const invalid_tag{};
-}
 
-namespace tbb {
-  template<>
-  struct tbb_hash_compare<std::thread::id> {
-    tbb_hash_compare() {}
-    static size_t hash(std::thread::id tid) {
-      std::ostringstream oss;
-      oss << tid;
-      return std::stoull(oss.str());
-    }
-    static bool equal(std::thread::id const k1, std::thread::id const k2) {
-      return k1==k2;
+  // Seed of a G4 engine for one sub-event, a splitmix64 hash of the module seed and of the
+  // event and sub-event numbers, in the range accepted by all of the CLHEP engines.
+  long subEventSeed(long baseSeed, art::EventID const& id, unsigned isub, unsigned iseed) {
+    uint64_t x = uint64_t(baseSeed);
+    for (uint64_t v : {uint64_t(id.run()), uint64_t(id.subRun()), uint64_t(id.event()), uint64_t(isub), uint64_t(iseed)}) {
+      x += 0x9e3779b97f4a7c15ULL + v;
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+      x = x ^ (x >> 31);
     }
-  };
+    return 1 + long(x % 899999999ULL);
+  }
 }
 
 namespace mu2e {
@@ -99,12 +101,22 @@ namespace mu2e {
     void endRun(art::Run &r, art::ProcessingFrame const& pf) override;
     void beginSubRun(art::SubRun &sr, art::ProcessingFrame const& pf) override;
 
+    // Simulate the primaries in sub-events spread over the workers.
+    void produceSubEvents(art::Event& event,
+                          art::Handle<GenParticleCollection> const& gensHandle,
+                          HitHandles& genInputHits,
+                          unsigned nPrimaries);
+
+    void putEventData(Mu2eG4PerThreadStorage* perThreadStore,
+                      art::EDProductGetter const* simProductGetter);
+
     fhicl::ParameterSet pset_;
     Mu2eG4ResourceLimits mu2elimits_;
     Mu2eG4TrajectoryControl trajectoryControl_;
     Mu2eG4MultiStageParameters multiStagePars_;
 
     std::unique_ptr<MTMasterThread> masterThread;
+    std::unique_ptr<MTWorkerPool> workerPool_;
       
     // Do we issue warnings about multiple runs?
     bool _warnEveryNewRun;
@@ -149,11 +161,15 @@ namespace mu2e {
       
     CLHEP::HepJamesRandom _engine;
 
+    // Events with more than subEventSize_ primaries are split into sub-events of at most
+    // subEventSize_ primaries, simulated in parallel on the workers and merged in order.
+    // Sub-event i numbers its SimParticles from simParticleNumberOffset + i*subEventIdStride_.
+    unsigned subEventSize_;
+    unsigned subEventIdStride_;
+    long subEventBaseSeed_;
+
     int const num_schedules{art::Globals::instance()->nschedules()};
     int const num_threads{art::Globals::instance()->nthreads()};
-
-    typedef tbb::concurrent_hash_map< std::thread::id, std::unique_ptr<Mu2eG4WorkerRunManager> > WorkerRMMap;
-    WorkerRMMap myworkerRunManagerMap;
   }; // end G4 header
 
     
@@ -165,6 +181,7 @@ namespace mu2e {
     multiStagePars_(pSet.get<fhicl::ParameterSet>("MultiStageParameters")),
 
     masterThread(std::make_unique<MTMasterThread>(pSet)),
+    workerPool_(std::make_unique<MTWorkerPool>(pset_, art::Globals::instance()->nthreads())),
     
     _warnEveryNewRun(pSet.get<bool>("debug.warnEveryNewRun",false)),
     _exportPDTStart(pSet.get<bool>("debug.exportPDTStart",false)),
@@ -186,13 +203,32 @@ namespace mu2e {
     standardMu2eDetector_((art::ServiceHandle<GeometryService>())->isStandardMu2eDetector()),
     
     //NEED TO FIGURE OUT HOW TO CONNECT THIS ENGINE TO THE G4 ENGINE
-    _engine{art::ServiceHandle<SeedService>{}->getSeed()}
+    _engine{art::ServiceHandle<SeedService>{}->getSeed()},
+    subEventSize_(pSet.get<unsigned>("subEventSize", 0)),
+    subEventIdStride_(pSet.get<unsigned>("subEventIdStride", 1000000)),
+    subEventBaseSeed_(art::ServiceHandle<SeedService>{}->getSeed())
     {
         if((_generatorModuleLabel == art::InputTag()) && multiStagePars_.genInputHits().empty()) {
             throw cet::exception("CONFIG")
             << "Error: both generatorModuleLabel and genInputHits are empty - nothing to do!\n";
         }
         
+        if (subEventSize_ > 0) {
+            if (subEventIdStride_ == 0) {
+                throw cet::exception("CONFIG")
+                << "Error: subEventIdStride must be positive when subEventSize is set\n";
+            }
+            if (pSet.get<bool>("G4InteralFiltering", false)) {
+                throw cet::exception("CONFIG")
+                << "Error: subEventSize can not be used with G4InteralFiltering, the filter decides on full events\n";
+            }
+            // pre-simulated hits would be copied once per sub-event
+            if (!pSet.get<fhicl::ParameterSet>("SDConfig", fhicl::ParameterSet()).get<std::vector<std::string> >("preSimulatedHits", std::vector<std::string>()).empty()) {
+                throw cet::exception("CONFIG")
+                << "Error: subEventSize can not be used with preSimulatedHits\n";
+            }
+        }
+        
     // This statement requires that the external libraries the module uses are thread-safe,
     // and that the data member members are used in a thread-safe manner
     async<art::InEvent>();
@@ -276,6 +312,9 @@ void Mu2eG4MT::beginRun( art::Run &run, art::ProcessingFrame const& procFrame) {
         }
     }
     
+    // Build the workers on the first run, and start the G4 run on all of them
+    workerPool_->beginRun(masterThread->masterRunManagerPtr(), originInWorld, run.id().run());
+    
     if ( ncalls == 1 && _exportPDTStart) {
         exportG4PDT( "Start:" );//once per job
     }
@@ -338,6 +377,17 @@ void Mu2eG4MT::produce(art::Event& event, art::ProcessingFrame const& procFrame)
         genInputHits.emplace_back(event.getValidHandle<StepPointMCCollection>(i));
     }
     
+    if (subEventSize_ > 0) {
+        unsigned nPrimaries = gensHandle.isValid() ? gensHandle->size() : 0;
+        for (const auto& hits : genInputHits) {
+            nPrimaries += hits->size();
+        }
+        if (nPrimaries > subEventSize_) {
+            produceSubEvents(event, gensHandle, genInputHits, nPrimaries);
+            return;
+        }
+    }
+    
     art::ProductID simPartId(event.getProductID<SimParticleCollection>());
     art::EDProductGetter const* simProductGetter = event.productGetter(simPartId);
     
@@ -348,39 +398,103 @@ void Mu2eG4MT::produce(art::Event& event, art::ProcessingFrame const& procFrame)
     int schedID = std::stoi(std::to_string(procFrame.scheduleID().id()));
     auto const tid = std::this_thread::get_id();
     
-    WorkerRMMap::accessor access_workerMap;
-    
-    if (!myworkerRunManagerMap.find(access_workerMap, tid)){
-        G4cout << "FOR TID: " << tid << ", NO WORKER.  We are making one.\n";
-        myworkerRunManagerMap.insert(access_workerMap, tid);
-        //std::ostringstream oss;
-        //oss << tid;
-        //std::string workerID = oss.str();
-        access_workerMap->second = std::make_unique<Mu2eG4WorkerRunManager>(pset_, tid);
-    }
-
-    if (event.id().event() == 1) {
-        G4cout << "Our RMmap has " << myworkerRunManagerMap.size() << " members\n";
-    }
-
-    myworkerRunManagerMap.find(access_workerMap, tid);
-    Mu2eG4WorkerRunManager* scheduleWorkerRM = (access_workerMap->second).get();
-    access_workerMap.release();
+    Mu2eG4WorkerRunManager* scheduleWorkerRM = workerPool_->worker();
     
     G4cout << "FOR SchedID: " << schedID << ", TID=" << tid << ", workerRunManagers[schedID].get() is:" << scheduleWorkerRM << "\n";
     
-    //if this is the first time the thread is being used, it should be initialized
-    if (!scheduleWorkerRM->workerRMInitialized()){
-        scheduleWorkerRM->initializeThread(masterThread->masterRunManagerPtr(), originInWorld);
-        scheduleWorkerRM->initializeRun(&event);
-    }
-    
     Mu2eG4PerThreadStorage* perThreadStore = scheduleWorkerRM->getMu2eG4PerThreadStorage();
     perThreadStore->initializeEventInfo(&event, &spHelper, &parentHelper, &genInputHits, _generatorModuleLabel);
     scheduleWorkerRM->processEvent(&event);
     
     G4cout << "Current Event in RM is: " << scheduleWorkerRM->GetCurrentEvent()->GetEventID() << "\n";
     
+    putEventData(perThreadStore, simProductGetter);
+    
+    perThreadStore->clearData();
+    scheduleWorkerRM->TerminateOneEvent();
+    
+}//end Mu2eG4MT::produce
+
+    
+    
+// The sub-events run as tasks on whichever workers are free.  The wait is isolated so that
+// a thread waiting here only picks up sub-events of this event, and never starts another
+// art event on a worker run manager that is still in use.  The outputs are merged in
+// sub-event order, so the event does not depend on the scheduling.
+void Mu2eG4MT::produceSubEvents(art::Event& event,
+                                art::Handle<GenParticleCollection> const& gensHandle,
+                                HitHandles& genInputHits,
+                                unsigned nPrimaries) {
+    
+    art::ProductID simPartId(event.getProductID<SimParticleCollection>());
+    art::EDProductGetter const* simProductGetter = event.productGetter(simPartId);
+    
+    unsigned const nSubEvents = (nPrimaries + subEventSize_ - 1)/subEventSize_;
+    std::vector<std::unique_ptr<Mu2eG4PerThreadStorage>> subEventData(nSubEvents);
+    std::mutex eventMutex;
+    
+    if ( _rmvlevel > 0 ) {
+        G4cout << "Event " << event.id() << ": splitting " << nPrimaries
+               << " primaries into " << nSubEvents << " sub-events" << G4endl;
+    }
+    
+    auto simulate = [&](unsigned isub) {
+        
+        unsigned const offset = multiStagePars_.simParticleNumberOffset() + isub*subEventIdStride_;
+        SimParticleHelper spHelper(offset, simPartId, &event, simProductGetter);
+        SimParticlePrimaryHelper parentHelper(&event, simPartId, gensHandle, simProductGetter);
+        
+        Mu2eG4WorkerRunManager* workerRM = workerPool_->worker();
+        Mu2eG4PerThreadStorage* perThreadStore = workerRM->getMu2eG4PerThreadStorage();
+        {
+            // the sub-events share one art::Event
+            std::lock_guard<std::mutex> lock(eventMutex);
+            perThreadStore->initializeEventInfo(&event, &spHelper, &parentHelper, &genInputHits, _generatorModuleLabel);
+        }
+        perThreadStore->setPrimaryRange(isub*subEventSize_, std::min((isub+1)*subEventSize_, nPrimaries));
+        workerRM->setEventSeeds(subEventSeed(subEventBaseSeed_, event.id(), isub, 0),
+                                subEventSeed(subEventBaseSeed_, event.id(), isub, 1));
+        workerRM->processEvent(&event);
+        
+        auto const* sims = perThreadStore->simPartCollection.get();
+        if (sims != nullptr && !sims->empty() &&
+            sims->rbegin()->first.asUint() > offset + subEventIdStride_) {
+            throw cet::exception("RANGE")
+            << "Mu2eG4MT: sub-event " << isub << " of event " << event.id()
+            << " has SimParticle ids beyond subEventIdStride = " << subEventIdStride_ << "\n";
+        }
+        
+        subEventData[isub] = std::make_unique<Mu2eG4PerThreadStorage>(pset_);
+        subEventData[isub]->mergeEventData(*perThreadStore);
+        
+        perThreadStore->clearData();
+        workerRM->TerminateOneEvent();
+    };
+    
+    tbb::this_task_arena::isolate([&] {
+        tbb::task_group g;
+        for (unsigned isub = 0; isub < nSubEvents; ++isub) {
+            g.run([&simulate, isub] { simulate(isub); });
+        }
+        g.wait();
+    });
+    
+    Mu2eG4PerThreadStorage* merged = subEventData[0].get();
+    for (unsigned isub = 1; isub < nSubEvents; ++isub) {
+        merged->mergeEventData(*subEventData[isub]);
+    }
+    merged->artEvent = &event;
+    
+    putEventData(merged, simProductGetter);
+}
+    
+    
+    
+void Mu2eG4MT::putEventData(Mu2eG4PerThreadStorage* perThreadStore,
+                            art::EDProductGetter const* simProductGetter) {
+    
+    art::Event& event = *perThreadStore->artEvent;
+    
 /////////////////////////////////////////////////////////////////////////////////////
     G4cout << "Putting data into the EVENT" << G4endl;
     
@@ -392,6 +506,12 @@ void Mu2eG4MT::produce(art::Event& event, art::ProcessingFrame const& procFrame)
         event.put(std::move(perThreadStore->getG4Status()));
         event.put(std::move(simsToCheck));
         perThreadStore->putSensitiveDetectorData(simProductGetter);
+        if(sensitiveDetectorHelper_.strawGasStepsEnabled()) {
+            perThreadStore->putStrawGasStepData(simProductGetter);
+        }
+        if(sensitiveDetectorHelper_.caloShowerStepsEnabled()) {
+            perThreadStore->putCaloShowerStepData(simProductGetter);
+        }
         perThreadStore->putCutsData(simProductGetter);
         
         if(!timeVDtimes_.empty()) {
@@ -410,39 +530,16 @@ void Mu2eG4MT::produce(art::Event& event, art::ProcessingFrame const& procFrame)
             event.put(std::move(perThreadStore->getExtMonFNALSimHitCollection()));
         }
     }
-    
-    perThreadStore->clearData();
-    scheduleWorkerRM->TerminateOneEvent();
-    
-}//end Mu2eG4MT::produce
+}
 
         
 // Tell G4 that this run is over.
 void Mu2eG4MT::endRun(art::Run & run, art::ProcessingFrame const& procFrame) {
 
-    G4cout << "At endRun, we have " << myworkerRunManagerMap.size() << " members in the map\n";    
-    // KJK - should move this to endJob
+    G4cout << "At endRun, we have " << workerPool_->size() << " workers\n";
     
-    std::atomic<int> threads_left = myworkerRunManagerMap.size();//num_threads;
-    
-
-    tbb::task_group g;
-    for (int i = 0; i < static_cast<int>(myworkerRunManagerMap.size()); ++i) {
-    
-      auto destroy_worker = [&threads_left, this] {
-          WorkerRMMap::accessor access_workerMap;
-          std::thread::id this_tid = std::this_thread::get_id();
-        if (myworkerRunManagerMap.find(access_workerMap, this_tid)) {
-          access_workerMap->second.reset();
-        }
-          access_workerMap.release();
-          --threads_left;
-          while (threads_left != 0) {}
-          return;
-      };
-      g.run(destroy_worker);
-    }
-    g.wait();
+    // The workers are kept for the next run, they are destroyed in endJob
+    workerPool_->endRun();
     
     if (storePhysicsTablesDir_!="") {
         if ( _rmvlevel > 0 ) {
@@ -454,16 +551,18 @@ void Mu2eG4MT::endRun(art::Run & run, art::ProcessingFrame const& procFrame) {
      }
     
     G4cout << "at endRun: numExcludedEvents = " << numExcludedEvents << G4endl;
-    myworkerRunManagerMap.clear();
-    masterThread->endRun();
 }
 
 
         
 void Mu2eG4MT::endJob(art::ProcessingFrame const& procFrame) {
 
+    workerPool_->destroyWorkers();
+    masterThread->endRun();
+    
     if ( _exportPDTEnd ) exportG4PDT( "End:" );
     physVolHelper_.endRun();
+    FieldRegionCounters::print(std::cout);
 }
 
 
@@ -1,6 +1,7 @@
 // Andrei Gaponenko, 2015
 
 #include "Mu2eG4/inc/Mu2eG4StackingAction.hh"
+#include "Mu2eG4/inc/Mu2eG4Biasing.hh"
 
 #include <vector>
 #include <string>
@@ -10,9 +11,11 @@ namespace mu2e {
 
   Mu2eG4StackingAction::Mu2eG4StackingAction(const fhicl::ParameterSet&,
                                              IMu2eG4Cut& stackingCuts,
-                                             IMu2eG4Cut& commonCuts)
+                                             IMu2eG4Cut& commonCuts,
+                                             const Mu2eG4Biasing& biasing)
     : stackingCuts_(&stackingCuts)
     , commonCuts_(&commonCuts)
+    , biasing_(&biasing)
   {}
     
     G4ClassificationOfNewTrack Mu2eG4StackingAction::ClassifyNewTrack(const G4Track* trk){
@@ -22,6 +25,10 @@ namespace mu2e {
         if(commonCuts_->stackingActionCut(trk)) {
             return fKill;
         }
+        // Need to cast away const-ness to change the weight of the survivors.
+        if(biasing_->stackingRoulette(const_cast<G4Track*>(trk))) {
+            return fKill;
+        }
         return fUrgent;
     }
 
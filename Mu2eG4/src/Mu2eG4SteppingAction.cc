@@ -11,6 +11,7 @@
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
 #include "G4Step.hh"
+#include "G4SteppingManager.hh"
 #include "G4Threading.hh"
 
 // Mu2e includes
@@ -23,6 +24,7 @@
 #include "Mu2eG4/inc/PhysicsProcessInfo.hh"
 #include "Mu2eG4/inc/Mu2eG4ResourceLimits.hh"
 #include "Mu2eG4/inc/Mu2eG4TrajectoryControl.hh"
+#include "Mu2eG4/inc/Mu2eG4Biasing.hh"
 
 using namespace std;
 
@@ -32,12 +34,14 @@ namespace mu2e {
                                              const std::vector<double>& timeVDtimes,
                                              IMu2eG4Cut& steppingCuts,
                                              IMu2eG4Cut& commonCuts,
+                                             Mu2eG4Biasing& biasing,
                                              const Mu2eG4TrajectoryControl& trajectoryControl,
                                              const Mu2eG4ResourceLimits& lim) :
     pset_(pset),
 
     steppingCuts_(&steppingCuts),
     commonCuts_(&commonCuts),
+    biasing_(&biasing),
 
     mu2elimits_(&lim),
 
@@ -99,6 +103,8 @@ namespace mu2e {
           auto vol = getPhysicalVolumeOrThrow(spec.first);
           mcTrajectoryVolumePtDistances_[vol] = spec.second;
       }
+
+      biasing_->finishConstruction();
   }
     
   void Mu2eG4SteppingAction::BeginOfTrack() {
@@ -161,6 +167,12 @@ namespace mu2e {
           killTrack(track, ProcessCode::mu2eKillerVolume, fStopAndKill);
       } else if(killTooManySteps(track)) {
           killTrack( track, ProcessCode::mu2eMaxSteps, fStopAndKill);
+      } else {
+          double newWeight(0.);
+          const int ncopies = biasing_->splitting(step, newWeight);
+          if(ncopies >= 0) {
+              splitTrack(step, ncopies, newWeight);
+          }
       }
       
       //----------------------------------------------------------------
@@ -269,6 +281,31 @@ namespace mu2e {
       track->SetTrackStatus(status);
   }
 
+  // The copies start at the post step point as daughters of the track, so that
+  // the weight is constant along each SimParticle; see Mu2eG4Biasing.
+  void Mu2eG4SteppingAction::splitTrack( const G4Step* step, int ncopies, double newWeight ){
+
+      G4Track* track = step->GetTrack();
+
+      if(ncopies == 0) {
+          killTrack(track, ProcessCode::mu2eRussianRoulette, fStopAndKill);
+          return;
+      }
+
+      G4TrackVector* secondaries = fpSteppingManager->GetfSecondary();
+      for(int i=0; i<ncopies; ++i) {
+          // the copy has neither creator process nor user information
+          G4Track* copy = new G4Track(*track);
+          copy->SetParentID(track->GetTrackID());
+          copy->SetTouchableHandle(step->GetPostStepPoint()->GetTouchableHandle());
+          copy->SetTrackStatus(fAlive);
+          copy->SetWeight(newWeight);
+          secondaries->push_back(copy);
+      }
+
+      killTrack(track, ProcessCode::mu2eSplitting, fStopAndKill);
+  }
+
   G4bool Mu2eG4SteppingAction::addTimeVDHit(const G4Step* aStep, int id){
 
       if(tvd_collection_->size() >= mu2elimits_->maxStepPointCollectionSize()) {
@@ -99,9 +99,10 @@ namespace mu2e {
     ProcessCode findCreationCode(G4Track const* const trk){
       G4VProcess const* process = trk->GetCreatorProcess();
 
-      // If there is no creator process, then the G4Track was created by PrimaryGenerator action.
+      // If there is no creator process, then the G4Track was created by PrimaryGenerator action,
+      // or, if it has a parent, it is a copy made by the Mu2eG4Biasing splitting.
       if ( process == 0 ){
-        return ProcessCode::mu2ePrimary;
+        return trk->GetParentID() == 0 ? ProcessCode::mu2ePrimary : ProcessCode::mu2eSplitting;
       }
 
       // Extract the name from the process and look up the code.
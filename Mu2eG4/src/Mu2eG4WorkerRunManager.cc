@@ -22,6 +22,7 @@
 #include "Mu2eG4/inc/PrimaryGeneratorAction.hh"
 #include "Mu2eG4/inc/Mu2eG4SteppingAction.hh"
 #include "Mu2eG4/inc/Mu2eG4StackingAction.hh"
+#include "Mu2eG4/inc/Mu2eG4Biasing.hh"
 #include "Mu2eG4/inc/TrackingAction.hh"
 #include "Mu2eG4/inc/Mu2eG4RunAction.hh"
 #include "Mu2eG4/inc/Mu2eG4EventAction.hh"
@@ -36,6 +37,7 @@
 #include "G4TransportationManager.hh"
 #include "G4VUserPhysicsList.hh"
 #include "G4ParallelWorldProcessStore.hh"
+#include "Randomize.hh"
 
 //Other includes
 #include "CLHEP/Random/JamesRandom.h"
@@ -78,7 +80,10 @@ namespace mu2e {
     extMonFNALPixelSD_(),
     stackingCuts_(createMu2eG4Cuts(pset_.get<fhicl::ParameterSet>("Mu2eG4StackingOnlyCut", fhicl::ParameterSet()), mu2elimits_)),
     steppingCuts_(createMu2eG4Cuts(pset_.get<fhicl::ParameterSet>("Mu2eG4SteppingOnlyCut",fhicl::ParameterSet()), mu2elimits_)),
-    commonCuts_(createMu2eG4Cuts(pset_.get<fhicl::ParameterSet>("Mu2eG4CommonCut", fhicl::ParameterSet()), mu2elimits_))
+    commonCuts_(createMu2eG4Cuts(pset_.get<fhicl::ParameterSet>("Mu2eG4CommonCut", fhicl::ParameterSet()), mu2elimits_)),
+    biasing_(std::make_unique<Mu2eG4Biasing>(pset_.get<fhicl::ParameterSet>("Mu2eG4Biasing", fhicl::ParameterSet()))),
+    useEventSeeds_(false),
+    eventSeeds_{0, 0}
 {
     std::cout << "WorkerRM on thread " << workerID_ << " is being created\n!";
     
@@ -178,13 +183,15 @@ void Mu2eG4WorkerRunManager::initializeUserActions(const G4ThreeVector& origin_i
                                                pset_.get<std::vector<double> >("SDConfig.TimeVD.times"),
                                                *steppingCuts_.get(),
                                                *commonCuts_.get(),
+                                               *biasing_.get(),
                                                trajectoryControl_,
                                                mu2elimits_);
     SetUserAction(steppingAction_);
 
     SetUserAction( new Mu2eG4StackingAction(pset_,
                                             *stackingCuts_.get(),
-                                            *commonCuts_.get()) );
+                                            *commonCuts_.get(),
+                                            *biasing_.get()) );
     
     trackingAction_ = new TrackingAction(pset_,
                                          steppingAction_,
@@ -214,12 +221,13 @@ void Mu2eG4WorkerRunManager::initializeUserActions(const G4ThreeVector& origin_i
 
 }
 
-void Mu2eG4WorkerRunManager::initializeRun(art::Event* art_event){
+// Begin the G4 run of this worker for a new art run; the geometry and the physics
+// set up in initializeThread are kept from the previous runs.
+void Mu2eG4WorkerRunManager::initializeRun(art::RunNumber_t run_number){
     
     
-    if (art_event->id().run() != perThreadObjects_->currentRunNumber) {
+    if (run_number != perThreadObjects_->currentRunNumber || perThreadObjects_->runTerminated) {
         if (perThreadObjects_->currentRunNumber != 0 && !perThreadObjects_->runTerminated) {
-            //terminateRun();
             throw cet::exception("WorkerRUNMANAGER") << "Error: There is a problem with Run Numbering\n";
         }
     
@@ -276,10 +284,22 @@ void Mu2eG4WorkerRunManager::initializeRun(art::Event* art_event){
     
     }
     
-    perThreadObjects_->currentRunNumber = art_event->id().run();
+    perThreadObjects_->currentRunNumber = run_number;
+    perThreadObjects_->runTerminated = false;
 
     m_managerInitialized = true;
 }
+    
+
+// G4RunManager::RunTermination, not the G4WorkerRunManager one: the workers are driven
+// by art, there is no G4 event loop to synchronize with the master.
+void Mu2eG4WorkerRunManager::terminateRun(){
+    
+    if (!m_managerInitialized || perThreadObjects_->runTerminated) return;
+    
+    G4RunManager::RunTermination();
+    perThreadObjects_->runTerminated = true;
+}
 
     
 void Mu2eG4WorkerRunManager::processEvent(art::Event* event){
@@ -302,5 +322,27 @@ void Mu2eG4WorkerRunManager::processEvent(art::Event* event){
  
 }
     
+
+void Mu2eG4WorkerRunManager::setEventSeeds(long seed1, long seed2){
+    eventSeeds_[0] = seed1;
+    eventSeeds_[1] = seed2;
+    useEventSeeds_ = true;
+}
+    
+    
+// The primaries are copied from the art::Event without random numbers, so reseeding
+// after the base class has set up the event covers all of the G4 tracking.
+G4Event* Mu2eG4WorkerRunManager::GenerateEvent(G4int i_event){
+    
+    G4Event* anEvent = G4WorkerRunManager::GenerateEvent(i_event);
+    
+    if (useEventSeeds_) {
+        long seeds[3] = { eventSeeds_[0], eventSeeds_[1], 0 };
+        G4Random::setTheSeeds(seeds, -1);
+        useEventSeeds_ = false;
+    }
+    return anEvent;
+}
+    
     
 } // end namespace mu2e
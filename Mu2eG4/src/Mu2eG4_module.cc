@@ -20,6 +20,7 @@
 #include "GeometryService/inc/WorldG4.hh"
 #include "Mu2eG4/inc/ActionInitialization.hh"
 #include "Mu2eG4/inc/PhysicalVolumeHelper.hh"
+#include "Mu2eG4/inc/FieldRegionCounters.hh"
 #include "Mu2eG4/inc/physicsListDecider.hh"
 #include "Mu2eG4/inc/preG4InitializeTasks.hh"
 #include "Mu2eG4/inc/Mu2eSensitiveDetector.hh"
@@ -485,6 +486,12 @@ void Mu2eG4::produce(art::Event& event) {
         event.put(std::move(perThreadStore.getG4Status()));
         event.put(std::move(simsToCheck));
         perThreadStore.putSensitiveDetectorData(simProductGetter);
+        if(_sensitiveDetectorHelper.strawGasStepsEnabled()) {
+            perThreadStore.putStrawGasStepData(simProductGetter);
+        }
+        if(_sensitiveDetectorHelper.caloShowerStepsEnabled()) {
+            perThreadStore.putCaloShowerStepData(simProductGetter);
+        }
         perThreadStore.putCutsData(simProductGetter);
         
         if(!timeVDtimes_.empty()) {
@@ -522,6 +529,7 @@ void Mu2eG4::endJob(){
 
     if ( _exportPDTEnd ) exportG4PDT( "End:" );
     _physVolHelper.endRun();
+    FieldRegionCounters::print(std::cout);
 }
 
 
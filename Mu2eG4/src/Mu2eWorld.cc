@@ -20,6 +20,7 @@
 //
 
 // C++ includes
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -57,6 +58,7 @@
 #include "Mu2eG4/inc/CaloReadoutSD.hh"
 #include "Mu2eG4/inc/CaloReadoutCardSD.hh"
 #include "Mu2eG4/inc/CaloCrateSD.hh"
+#include "Mu2eG4/inc/CaloFastSimModel.hh"
 #include "Mu2eG4/inc/ExtMonFNALPixelSD.hh"
 #include "Mu2eG4/inc/TrackerWireSD.hh"
 #include "Mu2eG4/inc/Mu2eSensitiveDetector.hh"
@@ -85,6 +87,8 @@
 #include "Mu2eG4/inc/constructDummyStoppingTarget.hh"
 #include "Mu2eG4/inc/constructDiskCalorimeter.hh"
 #include "Mu2eG4/inc/SensitiveDetectorHelper.hh"
+#include "CaloMC/inc/CaloShowerLibrary.hh"
+#include "ConfigTools/inc/ConfigFileLookupPolicy.hh"
 #include "TrackerGeom/inc/Tracker.hh"
 #include "ExtinctionMonitorFNAL/Geometry/inc/ExtMonFNAL.hh"
 
@@ -115,20 +119,10 @@
 #include "G4PropagatorInField.hh"
 #include "G4MagIntegratorDriver.hh"
 #include "G4UserLimits.hh"
-#include "G4ClassicalRK4.hh"
-#include "G4ImplicitEuler.hh"
-#include "G4ExplicitEuler.hh"
-#include "G4SimpleRunge.hh"
-#include "G4SimpleHeum.hh"
-#include "G4HelixImplicitEuler.hh"
-#include "G4HelixSimpleRunge.hh"
-#if G4VERSION>4103
-#include "G4DormandPrince745.hh"
-#include "G4BogackiShampine23.hh"
-#endif
 #include "G4GDMLParser.hh"
 #include "G4ProductionCuts.hh"
 #include "G4Region.hh"
+#include "G4RegionStore.hh"
 
 #include "Mu2eG4/inc/Mu2eGlobalField.hh"
 
@@ -153,6 +147,10 @@ namespace mu2e {
     , bfieldMaxStep_(_config.getDouble("bfield.maxStep", 20.)*CLHEP::mm)
     , strawGasMaxStep_(_config.getDouble("strawGas.maxStep", 20.)*CLHEP::mm)
     , useEmOption4InTracker_(_config.getBool("g4.useEmOption4InTracker",false))
+    , caloFastSim_(false)
+    , caloFastSimMinEnergy_(0.)
+    , caloFastSimLibrary_()
+    , fieldRegions_()
   {
     _verbosityLevel = _config.getInt("world.verbosityLevel", 0);
     _g4VerbosityLevel = _config.getInt("g4.diagLevel", 0);
@@ -177,6 +175,10 @@ namespace mu2e {
     , strawGasMaxStep_(pset.get<double>("physics.strawGasMaxStep")*CLHEP::mm)
     , limitStepInAllVolumes_(pset.get<bool>("physics.limitStepInAllVolumes"))
     , useEmOption4InTracker_(pset.get<bool>("physics.useEmOption4InTracker",false))
+    , caloFastSim_(pset.get<bool>("physics.caloFastSim",false))
+    , caloFastSimMinEnergy_(caloFastSim_ ? pset.get<double>("physics.caloFastSimMinEnergy")*CLHEP::MeV : 0.)
+    , caloFastSimLibrary_(caloFastSim_ ? pset.get<std::string>("physics.caloFastSimLibrary") : std::string())
+    , fieldRegions_(pset.get<fhicl::ParameterSet>("physics.fieldRegions",fhicl::ParameterSet()))
   {
     _verbosityLevel = pset.get<int>("debug.worldVerbosityLevel");
     _g4VerbosityLevel = pset.get<int>("debug.diagLevel");
@@ -195,6 +197,7 @@ namespace mu2e {
 
       sdHelper_->instantiateLVSDs(_config);
       instantiateSensitiveDetectors();
+      if (caloFastSim_) instantiateCaloFastSim();
       constructBFieldAndManagers();
 
   }
@@ -332,6 +335,8 @@ namespace mu2e {
         region->AddRootLogicalVolume(trackerInfo.logical);
       }
 
+      if (caloFastSim_) constructCaloFastSimRegion();
+
       constructStepLimiters();
 
       // Write out mu2e geometry into a gdml file.
@@ -420,9 +425,6 @@ namespace mu2e {
     G4ThreeVector ds2Z0 = ds2VacuumVacInfo.centerInWorld;
     G4ThreeVector beamZ0( ds2Z0.x(), ds2Z0.y(), ds2Z0.z()+ds2HL );
 
-    // Decide on the G4 Stepper
-
-
       GeomHandle<BFieldConfig> bfConfig;
 
     bool needDSUniform = (bfConfig->dsFieldForm() == BFieldConfig::dsModelSplit || bfConfig->dsFieldForm() == BFieldConfig::dsModelUniform );
@@ -442,65 +444,22 @@ namespace mu2e {
       }
     }
 
-    // Create global field managers; don't use FieldMgr here to avoid problem with ownership
-
-    G4MagneticField * _field = new Mu2eGlobalField(worldGeom->mu2eOriginInWorld());
-    G4Mag_EqRhs * _rhs  = new G4Mag_UsualEqRhs(_field);
-    G4MagIntegratorStepper * _stepper;
-    if ( _g4VerbosityLevel > 0 ) G4cout << __func__ << " Setting up " << g4stepperName_ << " stepper" << G4endl;
-    if ( g4stepperName_  == "G4ClassicalRK4" ) {
-      _stepper = new G4ClassicalRK4(_rhs);
-    } else if ( g4stepperName_  == "G4ClassicalRK4WSpin" ) {
-      delete _rhs; // FIXME: avoid the delete
-      _rhs  = new G4Mag_SpinEqRhs(_field);
-      _stepper = new G4ClassicalRK4(_rhs, 12);
-      if ( _g4VerbosityLevel > 0) {
-        G4cout << __func__ << " Replaced G4Mag_UsualEqRhs with G4ClassicalRK4WSpin "
-             << "and used G4ClassicalRK4 with Spin" << G4endl;
-      }
-#if G4VERSION>4103
-    } else if ( g4stepperName_  == "G4DormandPrince745WSpin" ) {
-      delete _rhs; // FIXME: avoid the delete
-      _rhs  = new G4Mag_SpinEqRhs(_field);
-      _stepper = new G4DormandPrince745(_rhs, 12);
-      if ( _g4VerbosityLevel > 0) {
-        G4cout << __func__ << " Replaced G4Mag_UsualEqRhs with G4DormandPrince745WSpin "
-             << "and used G4DormandPrince745 with Spin" << G4endl;
-      }
-#endif
-    } else if ( g4stepperName_  == "G4ImplicitEuler" ) {
-      _stepper = new G4ImplicitEuler(_rhs);
-    } else if ( g4stepperName_  == "G4ExplicitEuler" ) {
-      _stepper = new G4ExplicitEuler(_rhs);
-    } else if ( g4stepperName_  == "G4SimpleHeum" ) {
-      _stepper = new G4SimpleHeum(_rhs);
-    } else if ( g4stepperName_  == "G4HelixImplicitEuler" ) {
-      _stepper = new G4HelixImplicitEuler(_rhs);
-    } else if ( g4stepperName_  == "G4HelixSimpleRunge" ) {
-      _stepper = new G4HelixSimpleRunge(_rhs);
-#if G4VERSION>4103
-    } else if ( g4stepperName_  == "G4DormandPrince745" ) {
-      _stepper = new G4DormandPrince745(_rhs);
-    } else if ( g4stepperName_  == "G4BogackiShampine23" ) {
-      _stepper = new G4BogackiShampine23(_rhs);
-#endif
-    } else if ( g4stepperName_  == "G4SimpleRunge" ) {
-      _stepper = new G4SimpleRunge(_rhs);
-    } else {
-        throw cet::exception("GEOM")
-          << "Unrecognized stepper : "
-          << g4stepperName_
-          << "\n";
-    }
+    // Create the field managers of the world (region "Hall") and of the regions configured
+    // in physics.fieldRegions.  This is called once per thread but Mu2eWorld is shared by
+    // the threads, so these managers are not kept in members: their parts are released
+    // and live as long as the G4 geometry of the thread.
 
-    G4ChordFinder * _chordFinder = new G4ChordFinder(_field,g4StepMinimum_,_stepper);
-    G4FieldManager * _manager = new G4FieldManager(_field,_chordFinder,true);
+    fhicl::ParameterSet const hallPars = fieldRegions_.get<fhicl::ParameterSet>("Hall",fhicl::ParameterSet());
+    std::unique_ptr<FieldMgr> hall = makeRegionFieldMgr("Hall", hallPars);
+    G4FieldManager * _manager = hall->manager();
+    G4ChordFinder * _chordFinder = hall->chordFinder();
 
     // G4TransportationManager takes ownership of _manager
 
     G4TransportationManager* transporationMgr =
       G4TransportationManager::GetTransportationManager();
     transporationMgr->SetFieldManager(_manager);
+    hall->release();
 
     // Define uniform field region in the detector solenoid, if neccessary
     if (bfConfig->dsFieldForm() == BFieldConfig::dsModelUniform  ){
@@ -524,6 +483,45 @@ namespace mu2e {
 
     }
 
+    // The regions with their own field managers and the volumes they are attached to.
+    // The managers are forced on all daughters, so the regions nested in others,
+    // tracker and calorimeter in the DS, must come after them.
+    static const std::vector<std::pair<std::string,std::vector<std::string>>> fieldRegionVolumes{
+      { "PS",          { "PSVacuum", "psVacuumVesselVacuum" } },
+      { "TS",          { "TS1Vacuum", "TS2Vacuum", "TS3Vacuum", "TS4Vacuum", "TS5Vacuum" } },
+      { "DSUpstream",  { "DS1Vacuum", "DS2Vacuum" } },
+      { "Tracker",     { "TrackerMother" } },
+      { "Calorimeter", { "CalorimeterMother" } }
+    };
+
+    for ( auto const& region : fieldRegions_.get_names() ){
+      auto known = std::find_if( fieldRegionVolumes.begin(), fieldRegionVolumes.end(),
+                                 [&region](auto const& rv){ return rv.first == region; } );
+      if ( region != "Hall" && known == fieldRegionVolumes.end() ) {
+        throw cet::exception("CONFIG")
+          << "Mu2eWorld: unknown region in physics.fieldRegions: " << region
+          << ", the known ones are Hall, PS, TS, DSUpstream, Tracker and Calorimeter\n";
+      }
+    }
+
+    for ( auto const& rv : fieldRegionVolumes ){
+      if ( !fieldRegions_.has_key(rv.first) ) continue;
+
+      // the regions of the DS would silently replace the uniform field model
+      if ( needDSUniform && rv.first != "PS" && rv.first != "TS" ) {
+        throw cet::exception("CONFIG")
+          << "Mu2eWorld: physics.fieldRegions." << rv.first
+          << " requires the mapped DS field, not the uniform one\n";
+      }
+
+      std::unique_ptr<FieldMgr> mgr = makeRegionFieldMgr(rv.first, fieldRegions_.get<fhicl::ParameterSet>(rv.first));
+      for ( auto const& vol : rv.second ){
+        _helper->locateVolInfo(vol).logical->SetFieldManager( mgr->manager(), true);
+        if ( _verbosityLevel > 0 ) G4cout << __func__ << " Use the " << rv.first << " field manager in " << vol << G4endl;
+      }
+      mgr->release();
+    }
+
     // Adjust properties of the integrators to control accuracy vs time.
 
     if ( _dsUniform.get() != 0 ){
@@ -536,12 +534,6 @@ namespace mu2e {
       _dsGradient->manager()->SetDeltaIntersection(deltaIntersection);
     }
 
-    _manager->SetMinimumEpsilonStep(g4epsilonMin_);
-    _manager->SetMaximumEpsilonStep(g4epsilonMax_);
-    _manager->SetDeltaOneStep(g4DeltaOneStep_);
-    _manager->SetDeltaIntersection(g4DeltaIntersection_);
-    _chordFinder->SetDeltaChord(g4DeltaChord_);
-
     G4PropagatorInField* _propInField = transporationMgr->GetPropagatorInField();
     _propInField->SetMaxLoopCount(g4MaxIntSteps_);
 
@@ -552,18 +544,53 @@ namespace mu2e {
       G4cout << __func__ << " g4epsilonMax        " << _manager->GetMaximumEpsilonStep() << G4endl;
       G4cout << __func__ << " g4DeltaOneStep      " << _manager->GetDeltaOneStep() << G4endl;
       G4cout << __func__ << " g4DeltaIntersection " << _manager->GetDeltaIntersection() << G4endl;
-      G4cout << __func__ << " g4DeltaChord        " << _chordFinder->GetDeltaChord() << G4endl;
+      if ( _chordFinder ) {
+        G4cout << __func__ << " g4DeltaChord        " << _chordFinder->GetDeltaChord() << G4endl;
+      }
       G4cout << __func__ << " g4StepMinimum       "
       // << dynamic_cast<G4MagInt_Driver*>(_chordFinder->GetIntegrationDriver())->GetHmin() << G4endl;
       // the above assumes G4ChordFinder is instantiated in the way it is done above with the 3 parameters
       // does not work in 10.5+; fixme
-	     << g4StepMinimum_ << G4endl;
+	     << hallPars.get<double>("stepMinimum",g4StepMinimum_/CLHEP::mm)*CLHEP::mm << G4endl;
       G4cout << __func__ << " g4MaxIntStep        " << _propInField->GetMaxLoopCount() << G4endl;
     }
 
   } // end Mu2eWorld::constructBFieldAndManagers
 
 
+  // Make the field manager of one region of the field map.  The stepper and the accuracy
+  // parameters not given in the region's parameter set are the global ones from physics.
+  std::unique_ptr<FieldMgr> Mu2eWorld::makeRegionFieldMgr(const std::string& region,
+                                                          const fhicl::ParameterSet& regionPars){
+
+    GeomHandle<WorldG4> worldGeom;
+
+    std::string const stepperName = regionPars.get<std::string>("stepper", g4stepperName_);
+    double const stepMinimum = regionPars.get<double>("stepMinimum", g4StepMinimum_/CLHEP::mm)*CLHEP::mm;
+    if ( _g4VerbosityLevel > 0 ) G4cout << __func__ << " Setting up " << stepperName << " stepper in " << region << G4endl;
+
+    std::unique_ptr<FieldMgr> mgr = FieldMgr::forRegion(region, stepperName,
+                                                        worldGeom->mu2eOriginInWorld(), stepMinimum);
+    if ( stepperName == "FieldOff" ) return mgr;
+
+    G4FieldManager* manager = mgr->manager();
+    manager->SetMinimumEpsilonStep(regionPars.get<double>("epsilonMin", g4epsilonMin_));
+    manager->SetMaximumEpsilonStep(regionPars.get<double>("epsilonMax", g4epsilonMax_));
+    manager->SetDeltaOneStep(regionPars.get<double>("deltaOneStep", g4DeltaOneStep_/CLHEP::mm)*CLHEP::mm);
+    manager->SetDeltaIntersection(regionPars.get<double>("deltaIntersection", g4DeltaIntersection_/CLHEP::mm)*CLHEP::mm);
+    mgr->chordFinder()->SetDeltaChord(regionPars.get<double>("deltaChord", g4DeltaChord_/CLHEP::mm)*CLHEP::mm);
+
+    if ( _g4VerbosityLevel > 0 && region != "Hall" ) {
+      G4cout << __func__ << " " << region << " epsilonMin " << manager->GetMinimumEpsilonStep()
+             << " epsilonMax " << manager->GetMaximumEpsilonStep()
+             << " deltaOneStep " << manager->GetDeltaOneStep()
+             << " deltaIntersection " << manager->GetDeltaIntersection()
+             << " deltaChord " << mgr->chordFinder()->GetDeltaChord() << G4endl;
+    }
+    return mgr;
+  }
+
+
     // A helper function for Mu2eWorld::constructStepLimiters().
     // Find all logical volumes matching a wildcarded name and add steplimiters to them.
   void Mu2eWorld::stepLimiterHelper ( std::string const& regexp, G4UserLimits* stepLimit ) {
@@ -778,6 +805,60 @@ namespace mu2e {
   }//Mu2eWorld::constructCal
 
 
+  // Region of the calorimeter fast simulation: the envelopes of the crystal disks.
+  // The library is read here, by the master, and shared by the models of the workers.
+  void Mu2eWorld::constructCaloFastSimRegion(){
+
+    if ( caloFastSimLibrary_.empty() ) {
+      throw cet::exception("CONFIG")
+        << "Mu2eWorld: physics.caloFastSim requires physics.caloFastSimLibrary\n";
+    }
+    ConfigFileLookupPolicy path;
+    caloShowerLibrary_ = std::make_unique<CaloShowerLibrary>(path(caloFastSimLibrary_));
+
+    G4Region* region = new G4Region("CaloFastSim"); // G4RegionStore takes ownership
+    G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+    for (auto lv : *store) {
+      if (lv->GetName().find("calofullCrystalDiskLog_") != std::string::npos) {
+        lv->SetRegion(region);
+        region->AddRootLogicalVolume(lv);
+      }
+    }
+
+    if ( region->GetNumberOfRootVolumes() == 0 ) {
+      throw cet::exception("CONFIG")
+        << "Mu2eWorld: physics.caloFastSim requires a disk calorimeter\n";
+    }
+
+    if ( _verbosityLevel > 0 ) {
+      G4cout << __func__ << " Calorimeter fast simulation in " << region->GetNumberOfRootVolumes()
+             << " disks with " << caloFastSimLibrary_ << " above "
+             << caloFastSimMinEnergy_/CLHEP::MeV << " MeV" << G4endl;
+    }
+  }
+
+
+  // The fast simulation model is thread-local, like the SD it fills.
+  void Mu2eWorld::instantiateCaloFastSim(){
+
+    if ( !sdHelper_->caloShowerStepsEnabled() ) {
+      throw cet::exception("CONFIG")
+        << "Mu2eWorld: physics.caloFastSim requires SDConfig.caloShowerSteps\n";
+    }
+
+    CaloCrystalSD* ccSD = dynamic_cast<CaloCrystalSD*>
+      (G4SDManager::GetSDMpointer()->FindSensitiveDetector(SensitiveDetectorName::CaloCrystal(),false));
+    if ( ccSD == nullptr ) {
+      throw cet::exception("CONFIG")
+        << "Mu2eWorld: physics.caloFastSim requires the calorimeter SD\n";
+    }
+
+    G4Region* region = G4RegionStore::GetInstance()->GetRegion("CaloFastSim",false);
+    new CaloFastSimModel("CaloFastSimModel", region, *caloShowerLibrary_, caloFastSimMinEnergy_, ccSD);
+    // the region G4FastSimulationManager takes ownership
+  }
+
+
   // A place holder for now.
   void Mu2eWorld::constructMagnetYoke(){
   }//Mu2eWorld::constructMagnetYoke
@@ -13,6 +13,7 @@
 
 // C++ includes
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 
 // Framework includes
@@ -59,6 +60,8 @@ namespace mu2e {
 
   PrimaryGeneratorAction::PrimaryGeneratorAction(int verbosityLevel, Mu2eG4PerThreadStorage* tls)
     :
+    firstPrimary_(0),
+    lastPrimary_(std::numeric_limits<unsigned>::max()),
     verbosityLevel_(verbosityLevel),
     perThreadObjects_(tls)
   {
@@ -89,6 +92,9 @@ void PrimaryGeneratorAction::setEventData()
         hitInputs_ = perThreadObjects_->genInputHits;
 
         parentMapping_ = perThreadObjects_->simParticlePrimaryHelper;
+
+        firstPrimary_ = perThreadObjects_->firstPrimary;
+        lastPrimary_ = perThreadObjects_->lastPrimary;
         
     }
 
@@ -119,9 +125,14 @@ void PrimaryGeneratorAction::fromEvent(G4Event* event)
         (!_config.getBool("mu2e.standardDetector",true) || !(geom->isStandardMu2eDetector()))
         ?  G4ThreeVector(0.0,0.0,0.0) : (GeomHandle<WorldG4>())->mu2eOriginInWorld();
 
+        // Index of the primary over the GenParticles and the input hits, only those
+        // in [firstPrimary_,lastPrimary_) are given to G4 (sub-events of Mu2eG4MT).
+        unsigned iprimary(0);
+
         // For each generated particle, add it to the event.
         if(genParticles_) {
-            for (unsigned i=0; i < genParticles_->size(); ++i) {
+            for (unsigned i=0; i < genParticles_->size(); ++i, ++iprimary) {
+                if (iprimary < firstPrimary_ || iprimary >= lastPrimary_) continue;
                 const GenParticle& genpart = (*genParticles_)[i];
                 addG4Particle(event,
                               genpart.pdgId(),
@@ -153,15 +164,22 @@ void PrimaryGeneratorAction::fromEvent(G4Event* event)
         for(const auto& hitcoll : *hitInputs_) {
 
             for(const auto& hit : *hitcoll) {
+                bool const selected = iprimary >= firstPrimary_ && iprimary < lastPrimary_;
+                ++iprimary;
+                if (!selected) continue;
+
                 addG4Particle(event,
                               hit.simParticle()->pdgId(),
                               // Transform into G4 world coordinate system
                               hit.position() + mu2eOrigin,
                               hit.time(),
                               hit.properTime(),
-                              hit.momentum());
+                              hit.momentum(),
+                              // keep the Mu2eG4Biasing weight across stages
+                              hit.simParticle()->weight());
 
-                parentMapping_->addEntryFromStepPointMC(hit.simParticle()->id());
+                parentMapping_->addEntryFromStepPointMC(hit.simParticle()->id(),
+                                                        hit.simParticle()->weight());
 
             }
         }
@@ -174,7 +192,8 @@ void PrimaryGeneratorAction::addG4Particle(G4Event *event,
                                            const G4ThreeVector& pos,
                                            double time,
                                            double properTime,
-                                           const G4ThreeVector& mom)
+                                           const G4ThreeVector& mom,
+                                           double weight)
     {
     // Create a new vertex
     G4PrimaryVertex* vertex = new G4PrimaryVertex(pos, time);
@@ -259,6 +278,7 @@ void PrimaryGeneratorAction::addG4Particle(G4Event *event,
                             mom.x(),
                             mom.y(),
                             mom.z());
+    particle->SetWeight(weight);
         
     // Add the particle to the event.
     vertex->SetPrimary( particle );
@@ -20,14 +20,28 @@
 //    to transfer it into the unique_ptr that will be given to the event.  This is
 //    a very small CPU time penalty but it saves us from doing any explicit memory management.
 //
+// 3) With strawGasSteps : true the tracker SD sums its steps per (straw, track) and the
+//    StrawGasStepCollection is written by this module, so MakeStrawGasSteps is not needed.
+//    With strawStepPoints : false the tracker StepPointMC collection is still declared but
+//    stays empty.  Pre-simulated tracker hits are not converted into StrawGasSteps.
+//
+// 4) With caloShowerSteps : true the crystal and readout SDs compress their steps into
+//    CaloShowerSteps, written with the calorimeter and calorimeterRO instance names together
+//    with the SimParticlePtrCollection of CaloShowerStepFromStepPt, which is then not needed.
+//    caloStepPoints : false leaves the two calorimeter StepPointMC collections empty.
+//
 
 // From Mu2e
 #include "Mu2eG4/inc/SensitiveDetectorHelper.hh"
 #include "MCDataProducts/inc/StepPointMCCollection.hh"
 #include "MCDataProducts/inc/ExtMonFNALSimHitCollection.hh"
+#include "MCDataProducts/inc/SimParticlePtrCollection.hh"
 #include "Mu2eG4/inc/SensitiveDetectorName.hh"
 #include "G4Helper/inc/G4Helper.hh"
 #include "Mu2eG4/inc/Mu2eG4PerThreadStorage.hh"
+#include "Mu2eG4/inc/StrawSD.hh"
+#include "Mu2eG4/inc/CaloCrystalSD.hh"
+#include "Mu2eG4/inc/CaloReadoutSD.hh"
 #include "GeometryService/inc/GeometryService.hh"
 
 // From art and its tool chain
@@ -50,6 +64,10 @@ namespace mu2e {
 SensitiveDetectorHelper::SensitiveDetectorHelper(fhicl::ParameterSet const& pset)
     :
     extMonPixelsEnabled_(false),
+    strawGasStepsEnabled_(pset.get<bool>("strawGasSteps",false)),
+    strawStepPointsEnabled_(pset.get<bool>("strawStepPoints",true)),
+    caloShowerStepsEnabled_(pset.get<bool>("caloShowerSteps",false)),
+    caloStepPointsEnabled_(pset.get<bool>("caloStepPoints",true)),
     standardMu2eDetector_((art::ServiceHandle<GeometryService>())->isStandardMu2eDetector()),
     verbosityLevel_(pset.get<int>("verbosityLevel",0)),
     cutMomentumMin_(pset.get<double>("cutMomentumMin",0)),
@@ -102,6 +120,25 @@ SensitiveDetectorHelper::SensitiveDetectorHelper(fhicl::ParameterSet const& pset
             throw cet::exception("CONFIG")<<os.str();
         }
 
+        //----------------
+        if(strawGasStepsEnabled_ || !strawStepPointsEnabled_) {
+            if(!enabled(StepInstanceName::tracker)) {
+                throw cet::exception("CONFIG")<<"SensitiveDetectorHelper: strawGasSteps and strawStepPoints require the tracker SD\n";
+            }
+            if(!strawGasStepsEnabled_) {
+                throw cet::exception("CONFIG")<<"SensitiveDetectorHelper: strawStepPoints : false requires strawGasSteps : true\n";
+            }
+        }
+
+        if(caloShowerStepsEnabled_ || !caloStepPointsEnabled_) {
+            if(!enabled(StepInstanceName::calorimeter)) {
+                throw cet::exception("CONFIG")<<"SensitiveDetectorHelper: caloShowerSteps and caloStepPoints require the calorimeter SD\n";
+            }
+            if(!caloShowerStepsEnabled_) {
+                throw cet::exception("CONFIG")<<"SensitiveDetectorHelper: caloStepPoints : false requires caloShowerSteps : true\n";
+            }
+        }
+
         //----------------
         std::vector<string> lvlist(pset.get<vector<string>>("sensitiveVolumes", {}));
         for(const auto& name : lvlist) {
@@ -163,6 +200,23 @@ void SensitiveDetectorHelper::registerSensitiveDetectors(){
             dynamic_cast<Mu2eSensitiveDetector*>(sdManager->FindSensitiveDetector(step.stepName.c_str(),printWarnings));
         }
 
+        if(strawGasStepsEnabled_) {
+            strawSD_ = dynamic_cast<StrawSD*>(stepInstances_[StepInstanceName::tracker].sensitiveDetector);
+            if(!strawSD_) {
+                throw cet::exception("CONFIG")<<"SensitiveDetectorHelper: strawGasSteps requested but no StrawSD found\n";
+            }
+        }
+
+        if(caloShowerStepsEnabled_) {
+            caloCrystalSD_ = dynamic_cast<CaloCrystalSD*>(stepInstances_[StepInstanceName::calorimeter].sensitiveDetector);
+            if(!caloCrystalSD_) {
+                throw cet::exception("CONFIG")<<"SensitiveDetectorHelper: caloShowerSteps requested but no CaloCrystalSD found\n";
+            }
+            if(enabled(StepInstanceName::calorimeterRO)) {
+                caloReadoutSD_ = dynamic_cast<CaloReadoutSD*>(stepInstances_[StepInstanceName::calorimeterRO].sensitiveDetector);
+            }
+        }
+
         extMonFNALPixelSD_ = ( standardMu2eDetector_ && extMonPixelsEnabled_) ?
         dynamic_cast<ExtMonFNALPixelSD*>(sdManager->
                                          FindSensitiveDetector(SensitiveDetectorName::ExtMonFNAL()))
@@ -209,6 +263,10 @@ void SensitiveDetectorHelper::createProducts(const art::Event& event,
             }//for auto& hit
         }//for auto& i
 
+        strawGasSteps_.clear();
+        caloShowerSteps_.clear();
+        caloROShowerSteps_.clear();
+
         //----------------
         // Clean and pre-fill the logical volume collections
 
@@ -251,6 +309,17 @@ void SensitiveDetectorHelper::updateSensitiveDetectors( PhysicsProcessInfo&   in
         i.second.sensitiveDetector->beforeG4Event(i.second.p, info, spHelper);
     }//for
 
+    if(strawSD_) {
+        strawSD_->setGasStepOutput(&strawGasSteps_, strawStepPointsEnabled_);
+    }
+
+    if(caloCrystalSD_) {
+        caloCrystalSD_->setShowerStepOutput(&caloShowerSteps_, caloStepPointsEnabled_);
+    }
+    if(caloReadoutSD_) {
+        caloReadoutSD_->setShowerStepOutput(&caloROShowerSteps_, caloStepPointsEnabled_);
+    }
+
 }
     
     
@@ -269,6 +338,22 @@ void SensitiveDetectorHelper::insertSDDataIntoPerThreadStorage(Mu2eG4PerThreadSt
             std::swap( i.second.p, *p);
             per_thread_store->insertSDStepPointMC(std::move(p), i.second.stepName);
         }
+
+        if(strawGasStepsEnabled_) {
+            unique_ptr<StrawGasStepCollection> p(new StrawGasStepCollection);
+            std::swap( strawGasSteps_, *p);
+            per_thread_store->insertStrawGasSteps(std::move(p));
+        }
+
+        if(caloShowerStepsEnabled_) {
+            unique_ptr<CaloShowerStepCollection> p(new CaloShowerStepCollection);
+            std::swap( caloShowerSteps_, *p);
+            per_thread_store->insertCaloShowerSteps(std::move(p), StepInstanceName(StepInstanceName::calorimeter).name());
+
+            unique_ptr<CaloShowerStepCollection> pro(new CaloShowerStepCollection);
+            std::swap( caloROShowerSteps_, *pro);
+            per_thread_store->insertCaloShowerSteps(std::move(pro), StepInstanceName(StepInstanceName::calorimeterRO).name());
+        }
 }
 
     
@@ -333,6 +418,11 @@ bool SensitiveDetectorHelper::filterTrackerStepPoints(){
                 passed = true;
             }
         }//for stepInstances
+
+        // without the tracker StepPointMCs, count the StrawGasSteps instead
+        if (!strawStepPointsEnabled_ && strawGasSteps_.size() >= minTrackerStepPoints_) {
+            passed = true;
+        }
         
         for (auto& i: lvsd_) {
             
@@ -372,6 +462,13 @@ void SensitiveDetectorHelper::declareProducts(art::ProducesCollector& collector)
     }
     if(extMonPixelsEnabled_)
       collector.produces<ExtMonFNALSimHitCollection>();
+    if(strawGasStepsEnabled_)
+      collector.produces<StrawGasStepCollection>();
+    if(caloShowerStepsEnabled_) {
+      collector.produces<CaloShowerStepCollection>(StepInstanceName(StepInstanceName::calorimeter).name());
+      collector.produces<CaloShowerStepCollection>(StepInstanceName(StepInstanceName::calorimeterRO).name());
+      collector.produces<SimParticlePtrCollection>();
+    }
 }
 
   
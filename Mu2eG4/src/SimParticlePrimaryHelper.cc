@@ -21,11 +21,12 @@ namespace mu2e {
     }
     
     
-    void SimParticlePrimaryHelper::addEntryFromStepPointMC(SimParticleCollection::key_type simId)
+    void SimParticlePrimaryHelper::addEntryFromStepPointMC(SimParticleCollection::key_type simId, double weight)
     {
         entries_.emplace_back(art::Ptr<GenParticle>(gensHandle_.id()),
                               art::Ptr<SimParticle>(simProdID_,
                                                     simId.asUint(),
-                                                    simProductGetter_));
+                                                    simProductGetter_),
+                              weight);
     }
 }
@@ -30,11 +30,16 @@
 #include "Mu2eUtilities/inc/TwoLinePCA.hh"
 #include "GeneralUtilities/inc/LinePointPCA.hh"
 #include "ConfigTools/inc/SimpleConfig.hh"
+#include "BFieldGeom/inc/BFieldManager.hh"
+
+// CLHEP includes
+#include "CLHEP/Units/PhysicalConstants.h"
 
 // G4 includes
 #include "G4RunManager.hh"
 #include "G4Step.hh"
 #include "G4ThreeVector.hh"
+#include "G4VProcess.hh"
 #include "G4ios.hh"
 
 //
@@ -53,7 +58,18 @@ namespace mu2e {
     _nStrawsPerPanel(0),
     _TrackerVersion(0),
     _supportModel(),
-    _verbosityLevel(0)
+    _verbosityLevel(0),
+    _gasSteps(nullptr),
+    _keepStepPoints(true),
+    _gasStepSums(),
+    _tracker(nullptr),
+    _combineDeltas(config.getBool("tracker.gasSteps.combineDeltas",true)),
+    _maxDeltaLength(config.getDouble("tracker.gasSteps.maxDeltaLength",0.5)),
+    _minionBG(config.getDouble("tracker.gasSteps.minionBetaGamma",0.5)),
+    _minionKE(config.getDouble("tracker.gasSteps.minionKineticEnergy",20.0)),
+    _curlMom(0.),
+    _lineMom(0.),
+    _bnom(0.)
   {
 
     art::ServiceHandle<GeometryService> geom;
@@ -81,6 +97,17 @@ namespace mu2e {
 
       _verbosityLevel = max(verboseLevel,config.getInt("tracker.verbosityLevel",0)); // Geant4 SD verboseLevel
       _supportModel   = tracker->getSupportModel();
+      _tracker        = tracker.get();
+
+      // field at the tracker center, used to classify the StrawGasSteps; same as MakeStrawGasSteps
+      GeomHandle<BFieldManager> bfmgr;
+      GeomHandle<DetectorSystem> det;
+      CLHEP::Hep3Vector bnom = bfmgr->getBField(det->toMu2e(CLHEP::Hep3Vector()));
+      _bdir = bnom.unit();
+      _bnom = bnom.mag()*CLHEP::c_light*1.e-3;
+      double pstraw = _bnom*tracker->getStraw(StrawId(0,0,0)).innerRadius();
+      _curlMom = config.getDouble("tracker.gasSteps.curlRatio",1.0)*pstraw;
+      _lineMom = config.getDouble("tracker.gasSteps.lineRatio",10.0)*pstraw;
 
       if ( _TrackerVersion < 3 ) {
         throw cet::exception("StrawSD")
@@ -229,24 +256,32 @@ namespace mu2e {
 
     }
 
-    // We add the hit object to the framework strawHit collection created in produce
-
-    // Which process caused this step to end?
-    ProcessCode endCode(_processInfo->
-                        findAndCount(Mu2eG4UserHelpers::findStepStoppingProcessName(aStep)));
-
+    // Sum the step into the StrawGasStep of this straw and track
+    if ( _gasSteps != nullptr ) {
+      addGasStep(aStep, sid, prePosTracker,
+                 aStep->GetPostStepPoint()->GetPosition() - detectorOrigin);
+    }
 
-    _collection->push_back( StepPointMC(_spHelper->particlePtr(aStep->GetTrack()),
-                                        sid.asUint16(),
-                                        edep,
-                                        aStep->GetNonIonizingEnergyDeposit(),
-                                        aStep->GetPreStepPoint()->GetGlobalTime(),
-                                        aStep->GetPreStepPoint()->GetProperTime(),
-                                        prePosTracker,
-                                        preMomWorld,
-                                        step,
-                                        endCode
-                                        ));
+    // We add the hit object to the framework strawHit collection created in produce
+    if ( _keepStepPoints ) {
+
+      // Which process caused this step to end?
+      ProcessCode endCode(_processInfo->
+                          findAndCount(Mu2eG4UserHelpers::findStepStoppingProcessName(aStep)));
+
+
+      _collection->push_back( StepPointMC(_spHelper->particlePtr(aStep->GetTrack()),
+                                          sid.asUint16(),
+                                          edep,
+                                          aStep->GetNonIonizingEnergyDeposit(),
+                                          aStep->GetPreStepPoint()->GetGlobalTime(),
+                                          aStep->GetPreStepPoint()->GetProperTime(),
+                                          prePosTracker,
+                                          preMomWorld,
+                                          step,
+                                          endCode
+                                          ));
+    }
 
     if (_verbosityLevel>3) {
 
@@ -409,6 +444,164 @@ namespace mu2e {
   }
 
 
+  void StrawSD::Initialize(G4HCofThisEvent* HCE){
+    Mu2eSensitiveDetector::Initialize(HCE);
+    _gasStepSums.clear();
+  }
+
+  void StrawSD::EndOfEvent(G4HCofThisEvent* HCE){
+
+    Mu2eSensitiveDetector::EndOfEvent(HCE);
+
+    if ( _gasSteps == nullptr ) return;
+
+    if ( _combineDeltas ) compressDeltas();
+
+    // The map is ordered by straw and track, as the output of MakeStrawGasSteps.
+    _gasSteps->reserve(_gasSteps->size()+_gasStepSums.size());
+    for ( auto const& isum : _gasStepSums ) {
+      StrawGasStep sgs;
+      fillGasStep(StrawId(isum.first.first), isum.second, sgs);
+      _gasSteps->push_back(sgs);
+    }
+    _gasStepSums.clear();
+
+    if (_verbosityLevel>0) {
+      G4cout << __func__ << " " << SensitiveDetectorName << ": " << _gasSteps->size()
+             << " StrawGasSteps from " << _currentSize << " steps" << G4endl;
+    }
+  }
+
+  void StrawSD::setGasStepOutput(StrawGasStepCollection* gasSteps, bool keepStepPoints){
+    _gasSteps       = gasSteps;
+    _keepStepPoints = keepStepPoints || gasSteps == nullptr;
+  }
+
+  // Same selection as MakeStrawGasSteps: the straw must exist and the step must be inside
+  // its active length.  Dead straws are left to the downstream conditions.
+  void StrawSD::addGasStep(G4Step const* aStep, StrawId const& sid,
+                           G4ThreeVector const& prePos, G4ThreeVector const& postPos){
+
+    if ( !_tracker->strawExists(sid) ) return;
+    Straw const& straw = _tracker->getStraw(sid);
+    double wpos = std::abs((prePos-straw.getMidPoint()).dot(straw.getDirection()));
+    if ( wpos >= straw.activeHalfLength() ) return;
+
+    G4Track const* track = aStep->GetTrack();
+    G4StepPoint const* pre = aStep->GetPreStepPoint();
+    double time = pre->GetGlobalTime();
+
+    auto ins = _gasStepSums.emplace(StrawTrackKey(sid.asUint16(),track->GetTrackID()),GasStepSum());
+    GasStepSum& sum = ins.first->second;
+    if ( ins.second ) {
+      G4VProcess const* creator = track->GetCreatorProcess();
+      sum.simp     = _spHelper->particlePtr(track);
+      sum.parentId = track->GetParentID();
+      sum.delta    = creator != nullptr &&
+        ( creator->GetProcessName() == "eIoni" || creator->GetProcessName() == "hIoni" );
+      sum.charge   = track->GetDefinition()->GetPDGCharge();
+      sum.mass     = track->GetDefinition()->GetPDGMass();
+      sum.tFirst   = sum.tLast = time;
+      sum.startPos = prePos;
+      sum.startMom = pre->GetMomentum();
+      sum.endPos   = postPos;
+      sum.endMom   = pre->GetMomentum();
+    } else {
+      if ( time < sum.tFirst ) {
+        sum.tFirst   = time;
+        sum.startPos = prePos;
+        sum.startMom = pre->GetMomentum();
+      }
+      if ( time > sum.tLast ) {
+        sum.tLast  = time;
+        sum.endPos = postPos;
+        sum.endMom = pre->GetMomentum();
+      }
+    }
+    sum.eIon    += aStep->GetTotalEnergyDeposit() - aStep->GetNonIonizingEnergyDeposit();
+    sum.pathLen += aStep->GetStepLength();
+  }
+
+  // Fold short delta-rays that never leave their straw into the parent's step, following
+  // the parent chain in case the parent was itself compressed.
+  void StrawSD::compressDeltas(){
+
+    map<int,uint16_t> trackStraw;
+    map<int,int> deltaParent;
+    for ( auto const& isum : _gasStepSums ) {
+      auto ins = trackStraw.emplace(isum.first.second,isum.first.first);
+      if ( !ins.second && ins.first->second != isum.first.first ) ins.first->second = StrawId::_invalid;
+    }
+
+    auto isum = _gasStepSums.begin();
+    while ( isum != _gasStepSums.end() ) {
+      int tid = isum->first.second;
+      GasStepSum const& dsum = isum->second;
+      if ( dsum.delta && trackStraw[tid] != StrawId::_invalid && dsum.pathLen < _maxDeltaLength ) {
+        int pid = dsum.parentId;
+        deltaParent[tid] = pid;
+        auto jfnd = deltaParent.find(pid);
+        while ( jfnd != deltaParent.end() ) {
+          pid  = jfnd->second;
+          jfnd = deltaParent.find(pid);
+        }
+        auto ifnd = _gasStepSums.find(StrawTrackKey(isum->first.first,pid));
+        if ( ifnd != _gasStepSums.end() ) {
+          ifnd->second.eIon += dsum.eIon;
+          isum = _gasStepSums.erase(isum);
+          continue;
+        }
+      }
+      ++isum;
+    }
+  }
+
+  // Same physics as MakeStrawGasSteps::fillStep, except that the exit point is the real
+  // post-step point of the last step instead of an extrapolation.
+  void StrawSD::fillGasStep(StrawId const& sid, GasStepSum const& sum, StrawGasStep& sgs) const{
+
+    Straw const& straw = _tracker->getStraw(sid);
+
+    int itype, shape;
+    double mom = sum.startMom.mag();
+    if ( sum.charge == 0.0 ) {
+      itype = StrawGasStep::StepType::neutral;
+      shape = StrawGasStep::StepType::point;
+    } else {
+      if ( mom < _curlMom )
+        shape = StrawGasStep::StepType::curl;
+      else if ( mom < _lineMom )
+        shape = StrawGasStep::StepType::arc;
+      else
+        shape = StrawGasStep::StepType::line;
+      double bg = mom/sum.mass;
+      double ke = sqrt(mom*mom + sum.mass*sum.mass) - sum.mass;
+      if ( bg > _minionBG && ke > _minionKE )
+        itype = StrawGasStep::StepType::minion;
+      else
+        itype = StrawGasStep::StepType::highion;
+    }
+    StrawGasStep::StepType stype( (StrawGasStep::StepType::Shape)shape,
+                                  (StrawGasStep::StepType::Ionization)itype );
+
+    XYZVec momvec = Geom::toXYZVec(0.5*(sum.startMom + sum.endMom));
+    float  pmag   = sqrt(momvec.mag2());
+    double width(0.);
+    if ( pmag > 0. && _bnom > 0. ) {
+      G4ThreeVector pdir = sum.startMom.unit();
+      double pperp = pdir.perp(_bdir);
+      float bendrms = 0.5*std::min(straw.innerRadius(),pmag*pperp/_bnom);
+      float sint = (_bdir.cross(pdir).cross(straw.getDirection())).mag();
+      static const float prms(1.0/(12.0*sqrt(5.0)));
+      float sagrms = prms*sint*sum.pathLen*sum.pathLen*_bnom*pperp/pmag;
+      width = std::min(sagrms,bendrms);
+    }
+
+    sgs = StrawGasStep( sid, stype,
+                        (float)sum.eIon, (float)sum.pathLen, (float)width, sum.tFirst,
+                        Geom::toXYZVec(sum.startPos), Geom::toXYZVec(sum.endPos), momvec, sum.simp);
+  }
+
   // The previous version of this code assumed that the tracker was centered in its mother.
   // That is no longer true.
   G4ThreeVector StrawSD::GetTrackerOrigin() {
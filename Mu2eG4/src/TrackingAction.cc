@@ -326,6 +326,15 @@ void TrackingAction::saveSimParticleStart(const G4Track* trk){
     if(parentId == 0) { // primary
       genPtr = _primaryHelper->genParticlePtr(trk->GetTrackID());
       parentPtr = _primaryHelper->simParticlePrimaryPtr(trk->GetTrackID());
+      // A primary made from a StepPointMC carries the weight of its SimParticle
+      // in the previous stage, see PrimaryGeneratorAction.
+      if ( trk->GetWeight() != _primaryHelper->primaryWeight(trk->GetTrackID()) ) {
+        throw cet::exception("BIASING")
+          << "Primary G4 track " << trk->GetTrackID()
+          << " has weight " << trk->GetWeight()
+          << " instead of " << _primaryHelper->primaryWeight(trk->GetTrackID())
+          << " from the previous stage\n";
+      }
     }
     else { // not a primary
       parentPtr = _spHelper->particlePtrFromG4TrackID(parentId);
@@ -425,7 +434,8 @@ void TrackingAction::saveSimParticleStart(const G4Track* trk){
                                                          trk->GetProperTime(),
                                                          _physVolHelper->index(trk),
                                                          trk->GetTrackStatus(),
-                                                         creationCode)));
+                                                         creationCode,
+                                                         trk->GetWeight())));
 
     // If this track has a parent, tell the parent about this track.
     if ( parentPtr.isNonnull() ){
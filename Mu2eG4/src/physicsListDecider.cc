@@ -57,6 +57,7 @@
 
 #if G4VERSION>4103
 #include "G4EmParameters.hh"
+#include "G4FastSimulationPhysics.hh"
 #endif
 #if G4VERSION<4099
 #include "QGSP.hh"
@@ -100,6 +101,10 @@ namespace mu2e{
     bool modifyEMOption0(const fhicl::ParameterSet& pset) {
       return pset.get<bool>("physics.modifyEMOption0",false);
     }
+
+    bool caloFastSim(const fhicl::ParameterSet& pset) {
+      return pset.get<bool>("physics.caloFastSim",false);
+    }
 #endif
 
   }
@@ -194,6 +199,18 @@ namespace mu2e{
       }
       tmpPL->RegisterPhysics( new Mu2eEmStandardPhysics(getDiagLevel(pset)));
     }
+
+    // the CaloFastSimModel itself is attached to the CaloFastSim region by Mu2eWorld
+    if ( caloFastSim(pset) ) {
+      if (getDiagLevel(pset)>0) {
+        G4cout << __func__ << " Activating the calorimeter fast simulation" << G4endl;
+      }
+      G4FastSimulationPhysics* fastSimPhysics = new G4FastSimulationPhysics();
+      fastSimPhysics->ActivateFastSimulation("e-");
+      fastSimPhysics->ActivateFastSimulation("e+");
+      fastSimPhysics->ActivateFastSimulation("gamma");
+      tmpPL->RegisterPhysics(fastSimPhysics);
+    }
 #endif
 
     // Muon Spin and Radiative decays plus pion muons with spin
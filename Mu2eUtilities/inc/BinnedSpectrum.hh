@@ -33,7 +33,7 @@ namespace mu2e {
     BinnedSpectrum(const fhicl::ParameterSet& psphys);
     BinnedSpectrum() : _fixMax(false), _finalBin(false), _binWidth(0.), _nBins(0) {}
 
-    // To make accessible to CLHEP::RandGeneral and ROOT::TGraph,
+    // To make accessible to RandAliasTable, CLHEP::RandGeneral and ROOT::TGraph,
     // return pointer to first vector entries
     double const * getPDF()         const { return &(*_spectrum.second.begin() ); }
     double         getPDF(size_t i) const { return _spectrum.second.at(i); }
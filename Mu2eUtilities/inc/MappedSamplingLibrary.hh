@@ -0,0 +1,75 @@
+// A read-only, memory-mapped file of fixed size records, used by
+// RootTreeSampler as an alternative to reading ROOT trees into memory.
+//
+// The file is a 128 byte header followed by the records, stored as the
+// raw bytes of the record struct, e.g. IO::StoppedParticleF.  The header
+// holds the record size and the branchDescription() of the record type,
+// which the users check against the type they expect.  Such files are
+// made from the existing ROOT trees by the makeSamplingLibrary program.
+//
+// The mapping is shared: all of the users of a file in a process get the
+// same mapping, which is released when the last of them goes away, and
+// the pages are shared with the other processes on the node through the
+// page cache.  Nothing is read at open time beyond the header.
+
+#ifndef Mu2eUtilities_MappedSamplingLibrary_hh
+#define Mu2eUtilities_MappedSamplingLibrary_hh
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mu2e {
+
+  class MappedSamplingLibrary {
+  public:
+
+    struct Header {
+      char     magic[8];
+      uint32_t version;
+      uint32_t recordSize;
+      uint64_t numRecords;
+      uint64_t dataOffset;
+      char     description[96];
+    };
+
+    static constexpr const char* magicString = "MU2ESLIB";
+    static constexpr uint32_t currentVersion = 1;
+
+    // The shared mapping of the file; throws if the file is not a valid library.
+    static std::shared_ptr<const MappedSamplingLibrary> open(const std::string& fileName);
+
+    // Write a library of n records of recordSize bytes each.
+    static void write(const std::string& fileName,
+                      const std::string& description,
+                      uint32_t recordSize,
+                      const void* data,
+                      uint64_t n);
+
+    ~MappedSamplingLibrary();
+
+    MappedSamplingLibrary(const MappedSamplingLibrary&) = delete;
+    MappedSamplingLibrary& operator=(const MappedSamplingLibrary&) = delete;
+
+    const std::string& fileName()  const { return fileName_; }
+    std::string description()      const { return std::string(header().description); }
+    uint32_t recordSize()          const { return header().recordSize; }
+    uint64_t numRecords()          const { return header().numRecords; }
+
+    // The start of the records.
+    const void* data() const { return static_cast<const char*>(base_) + header().dataOffset; }
+
+  private:
+    MappedSamplingLibrary(const std::string& fileName);
+
+    const Header& header() const { return *static_cast<const Header*>(base_); }
+
+    std::string fileName_;
+    void*       base_;
+    std::size_t size_;
+  };
+
+}
+
+#endif/*Mu2eUtilities_MappedSamplingLibrary_hh*/
@@ -15,10 +15,10 @@
 // Mu2e includes
 #include "ConditionsService/inc/AcceleratorParams.hh"
 #include "GeneralUtilities/inc/EnumToStringSparse.hh"
+#include "Mu2eUtilities/inc/RandAliasTable.hh"
 #include "Mu2eUtilities/inc/Table.hh"
 
 // CLHEP includes
-#include "CLHEP/Random/RandGeneral.h"
 #include "CLHEP/Random/RandomEngine.h"
 
 // Framework includes
@@ -121,7 +121,7 @@ namespace mu2e {
 
     const std::vector<double> spectrum_;
 
-    CLHEP::RandGeneral randSpectrum_;
+    RandAliasTable     randSpectrum_;
 
     // Modifiers
     double setTmin();
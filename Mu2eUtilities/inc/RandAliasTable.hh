@@ -0,0 +1,80 @@
+#ifndef Mu2eUtilities_RandAliasTable_hh
+#define Mu2eUtilities_RandAliasTable_hh
+//
+// Sample a binned PDF in constant time with the Walker alias method,
+// with the table built by Vose's algorithm.  This is a replacement for
+// CLHEP::RandGeneral, which searches the cumulative distribution, with
+// the same constructor arguments and the same fire() semantics:
+//
+//   intType == 0: fire() returns a value in [0,1), uniformly distributed
+//                 within the bin that was drawn (the RandGeneral default);
+//   intType == 1: fire() returns the lower edge of the bin, i/nBins.
+//
+// As for RandGeneral, the caller maps the unit interval onto its abscissa,
+// e.g. with BinnedSpectrum::sample().  fireArray() fills a batch of values
+// from one call to the engine.
+//
+
+// C++ includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// CLHEP includes
+#include "CLHEP/Random/RandomEngine.h"
+
+namespace mu2e {
+
+  class RandAliasTable {
+
+  public:
+
+    RandAliasTable(CLHEP::HepRandomEngine& engine, const double* pdf, int nBins, int intType = 0);
+    RandAliasTable(CLHEP::HepRandomEngine& engine, const std::vector<double>& pdf, int intType = 0);
+
+    // A value in [0,1), see above.
+    double fire() {
+      const double u = _engine.flat()*_prob.size();
+      return value(u, _interpolate ? _engine.flat() : 0.);
+    }
+
+    // The index of a bin.
+    std::size_t fireBin() {
+      return bin(_engine.flat()*_prob.size());
+    }
+
+    // n values of fire() at once.
+    void fireArray(std::size_t n, double* vect);
+    std::vector<double> fire(std::size_t n) {
+      std::vector<double> res(n);
+      fireArray(n, res.data());
+      return res;
+    }
+
+    std::size_t nBins() const { return _prob.size(); }
+
+  private:
+
+    void makeTable(const double* pdf, int nBins);
+
+    // u in [0,nBins): its integer part picks a column of the table and its
+    // fractional part decides between the column and its alias.
+    std::size_t bin(double u) const {
+      const std::size_t i = static_cast<std::size_t>(u);
+      return (u - i < _prob[i]) ? i : _alias[i];
+    }
+
+    double value(double u, double withinBin) const {
+      return (bin(u) + withinBin)/_prob.size();
+    }
+
+    CLHEP::HepRandomEngine& _engine;
+    bool                    _interpolate;
+    std::vector<double>     _prob;
+    std::vector<uint32_t>   _alias;
+
+  };
+
+} // end of namespace mu2e
+
+#endif /* Mu2eUtilities_RandAliasTable_hh */
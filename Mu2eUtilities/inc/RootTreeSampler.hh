@@ -25,6 +25,14 @@
 // the feature (the default). If the number of inputs is less than
 // averageNumRecordsToUse, all input records are used.
 //
+// Instead of ROOT trees, the single record samplers can use libraryFiles
+// made from the trees by the makeSamplingLibrary program, see
+// MappedSamplingLibrary.hh.  These are memory-mapped read-only and shared
+// by all of the samplers of a process, and by the processes of a node,
+// rather than copied into each sampler.  fire() then returns a reference
+// into the mapping.  With averageNumRecordsToUse, the sampler stores one
+// pointer per selected record instead of the record.
+//
 // See StoppedParticleReactionGun_module.cc and InFlightParticleSampler_module.cc
 // for examples of use.
 //
@@ -33,6 +41,8 @@
 #ifndef RootTreeSampler_hh
 #define RootTreeSampler_hh
 
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "fhiclcpp/types/Atom.h"
@@ -52,6 +62,7 @@
 #include "TFile.h"
 
 #include "ConfigTools/inc/ConfigFileLookupPolicy.hh"
+#include "Mu2eUtilities/inc/MappedSamplingLibrary.hh"
 
 namespace mu2e {
 
@@ -63,19 +74,29 @@ namespace mu2e {
       using Name=fhicl::Name;
       using Comment=fhicl::Comment;
 
+      fhicl::Sequence<std::string> libraryFiles {
+        Name("libraryFiles"),
+          Comment("List of memory-mapped sampling libraries made by makeSamplingLibrary.\n"
+                  "If not empty, they are used instead of the inputFiles trees."),
+          std::vector<std::string>()
+      };
+
       fhicl::Sequence<std::string> inputFiles {
         Name("inputFiles"),
-          Comment("List of input ntuple files")
+          Comment("List of input ntuple files"),
+          [this](){ return libraryFiles().empty(); }
       };
 
       fhicl::Atom<std::string> treeName {
         Name("treeName"),
-          Comment("Name of the ROOT tree object containing particle records")
+          Comment("Name of the ROOT tree object containing particle records"),
+          [this](){ return libraryFiles().empty(); }
           };
 
       fhicl::Atom<std::string> branchName {
         Name("branchName"),
-          Comment("Name of the ROOT tree branch containing particle records")
+          Comment("Name of the ROOT tree branch containing particle records"),
+          [this](){ return libraryFiles().empty(); }
           };
 
       fhicl::Atom<long> averageNumRecordsToUse {
@@ -107,10 +128,15 @@ namespace mu2e {
     RootTreeSampler(art::RandomNumberGenerator::base_engine_t& engine,
                     const fhicl::ParameterSet& pset);
 
-    const EventRecord& fire() { return records_.at(randFlat_.fireInt(records_.size())); }
+    const EventRecord& fire() {
+      return libraries_.empty() ? records_.at(randFlat_.fireInt(records_.size())) : fireMapped();
+    }
 
     typename std::vector<EventRecord>::size_type
-    numRecords() const { return records_.size(); }
+    numRecords() const {
+      return libraries_.empty() ? records_.size() :
+        (mappedSelection_.empty() ? numMapped_ : mappedSelection_.size());
+    }
 
   private:
     CLHEP::RandFlat randFlat_;
@@ -118,6 +144,28 @@ namespace mu2e {
 
     typedef std::vector<std::string> Strings;
 
+    // The memory-mapped libraries, and either all of their records or a selection.
+    std::vector<std::shared_ptr<const MappedSamplingLibrary> > libraries_;
+    std::vector<std::pair<const EventRecord*, unsigned long> > mappedRanges_;
+    unsigned long numMapped_ = 0;
+    std::vector<const EventRecord*> mappedSelection_;
+
+    void loadLibraries(const Strings& files, long averageNumRecordsToUse, int verbosityLevel);
+
+    const EventRecord& fireMapped() {
+      if(!mappedSelection_.empty()) {
+        return *mappedSelection_[randFlat_.fireInt(mappedSelection_.size())];
+      }
+      unsigned long i = randFlat_.fireInt(numMapped_);
+      for(const auto& r : mappedRanges_) {
+        if(i < r.second) {
+          return r.first[i];
+        }
+        i -= r.second;
+      }
+      throw cet::exception("BUG")<<"RootTreeSampler::fireMapped(): index out of range\n";
+    }
+
     long countInputRecords(const art::ServiceHandle<art::TFileService>& tfs,
                            const Strings& files,
                            const std::string& treeName);
@@ -340,6 +388,11 @@ namespace mu2e {
                   const Config& conf)
     : randFlat_(engine)
   {
+    if(!conf.libraryFiles().empty()) {
+      loadLibraries(conf.libraryFiles(), conf.averageNumRecordsToUse(), conf.verbosityLevel());
+      return;
+    }
+
     const auto inputFiles(conf.inputFiles());
     const auto treeName(conf.treeName());
     const long averageNumRecordsToUse(conf.averageNumRecordsToUse());
@@ -448,6 +501,12 @@ namespace mu2e {
                   const fhicl::ParameterSet& pset)
     : randFlat_(engine)
   {
+    const auto libraryFiles(pset.get<std::vector<std::string> >("libraryFiles", std::vector<std::string>()));
+    if(!libraryFiles.empty()) {
+      loadLibraries(libraryFiles, pset.get<long>("averageNumRecordsToUse", 0), pset.get<int>("verbosityLevel", 0));
+      return;
+    }
+
     const auto inputFiles(pset.get<std::vector<std::string> >("inputFiles"));
     const auto treeName(pset.get<std::string>("treeName"));
     const long averageNumRecordsToUse(pset.get<long>("averageNumRecordsToUse", 0));
@@ -549,6 +608,62 @@ namespace mu2e {
 
   } // Constructor (pset)
 
+  //================================================================
+  template<class EventRecord, class NtupleRecord>
+  void RootTreeSampler<EventRecord, NtupleRecord>::loadLibraries(const Strings& files,
+                                                                 long averageNumRecordsToUse,
+                                                                 int verbosityLevel)
+  {
+    if(!std::is_same<EventRecord,NtupleRecord>::value || !std::is_trivially_copyable<EventRecord>::value) {
+      throw cet::exception("BADCONFIG")<<"RootTreeSampler: libraryFiles can only be used to sample single records\n";
+    }
+
+    for(const auto& fn : files) {
+      const std::string resolvedFileName = ConfigFileLookupPolicy()(fn);
+      auto lib = MappedSamplingLibrary::open(resolvedFileName);
+
+      if((lib->recordSize() != sizeof(EventRecord)) ||
+         (lib->description() != NtupleRecord::branchDescription())) {
+        throw cet::exception("BADINPUT")<<"RootTreeSampler: library \""<<resolvedFileName
+                                        <<"\" holds records \""<<lib->description()
+                                        <<"\" of "<<lib->recordSize()
+                                        <<" bytes, expect \""<<NtupleRecord::branchDescription()
+                                        <<"\" of "<<sizeof(EventRecord)<<" bytes\n";
+      }
+
+      mappedRanges_.emplace_back(static_cast<const EventRecord*>(lib->data()), lib->numRecords());
+      numMapped_ += lib->numRecords();
+      libraries_.push_back(lib);
+
+      if(verbosityLevel > 0) {
+        std::cout<<"RootTreeSampler: mapped "<<lib->numRecords()
+                 <<" records from "<<resolvedFileName<<std::endl;
+      }
+    }
+
+    if(numMapped_ == 0) {
+      throw cet::exception("BADINPUT")<<"RootTreeSampler: no records in libraryFiles\n";
+    }
+
+    if((averageNumRecordsToUse > 0) && (averageNumRecordsToUse < long(numMapped_))) {
+      const double recordUseFraction = averageNumRecordsToUse/double(numMapped_);
+      if(verbosityLevel > 0) {
+        std::cout<<"RootTreeSampler: recordUseFraction = "<<recordUseFraction
+                 <<" for the requested average = "<<averageNumRecordsToUse
+                 <<" and total number of input records = "<<numMapped_
+                 <<std::endl;
+      }
+      mappedSelection_.reserve(averageNumRecordsToUse + 3*sqrt(double(averageNumRecordsToUse)));
+      for(const auto& r : mappedRanges_) {
+        for(unsigned long i=0; i<r.second; ++i) {
+          if(randFlat_.fire() < recordUseFraction) {
+            mappedSelection_.push_back(r.first + i);
+          }
+        }
+      }
+    }
+  }
+
   //================================================================
   template<class EventRecord, class NtupleRecord>
   long RootTreeSampler<EventRecord, NtupleRecord>::countInputRecords(const art::ServiceHandle<art::TFileService>& tfs,
@@ -0,0 +1,115 @@
+#include "Mu2eUtilities/inc/MappedSamplingLibrary.hh"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cetlib_except/exception.h"
+
+namespace mu2e {
+
+  namespace {
+    // The libraries opened so far in this process, so that the module
+    // instances that sample the same file share one mapping.
+    std::mutex registryMutex;
+    std::map<std::string, std::weak_ptr<const MappedSamplingLibrary>> registry;
+  }
+
+  //================================================================
+  std::shared_ptr<const MappedSamplingLibrary> MappedSamplingLibrary::open(const std::string& fileName) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto lib = registry[fileName].lock();
+    if(!lib) {
+      lib.reset(new MappedSamplingLibrary(fileName));
+      registry[fileName] = lib;
+    }
+    return lib;
+  }
+
+  //================================================================
+  MappedSamplingLibrary::MappedSamplingLibrary(const std::string& fileName)
+    : fileName_(fileName)
+    , base_(nullptr)
+    , size_(0)
+  {
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if(fd < 0) {
+      throw cet::exception("BADINPUT")<<"MappedSamplingLibrary: can not open \""<<fileName
+                                      <<"\": "<<std::strerror(errno)<<"\n";
+    }
+
+    struct stat st;
+    if(::fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(Header)) {
+      ::close(fd);
+      throw cet::exception("BADINPUT")<<"MappedSamplingLibrary: \""<<fileName<<"\" is too short\n";
+    }
+    size_ = st.st_size;
+
+    base_ = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(base_ == MAP_FAILED) {
+      base_ = nullptr;
+      throw cet::exception("BADINPUT")<<"MappedSamplingLibrary: can not map \""<<fileName
+                                      <<"\": "<<std::strerror(errno)<<"\n";
+    }
+
+    const Header& h = header();
+    const bool valid = (std::strncmp(h.magic, magicString, sizeof(h.magic)) == 0)
+      && (h.version == currentVersion)
+      && (h.recordSize > 0)
+      && (h.dataOffset + h.numRecords*h.recordSize <= size_);
+
+    if(!valid) {
+      ::munmap(base_, size_);
+      base_ = nullptr;
+      throw cet::exception("BADINPUT")<<"MappedSamplingLibrary: \""<<fileName
+                                      <<"\" is not a valid sampling library\n";
+    }
+
+    // The records are sampled at random.
+    ::madvise(base_, size_, MADV_RANDOM);
+  }
+
+  //================================================================
+  MappedSamplingLibrary::~MappedSamplingLibrary() {
+    if(base_) {
+      ::munmap(base_, size_);
+    }
+  }
+
+  //================================================================
+  void MappedSamplingLibrary::write(const std::string& fileName,
+                                    const std::string& description,
+                                    uint32_t recordSize,
+                                    const void* data,
+                                    uint64_t n)
+  {
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, magicString, sizeof(h.magic));
+    h.version = currentVersion;
+    h.recordSize = recordSize;
+    h.numRecords = n;
+    h.dataOffset = sizeof(Header);
+
+    if(description.size() >= sizeof(h.description)) {
+      throw cet::exception("BADCONFIG")<<"MappedSamplingLibrary: description \""<<description<<"\" is too long\n";
+    }
+    std::strncpy(h.description, description.c_str(), sizeof(h.description)-1);
+
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(static_cast<const char*>(data), n*recordSize);
+    if(!out) {
+      throw cet::exception("FILE")<<"MappedSamplingLibrary: error writing \""<<fileName<<"\"\n";
+    }
+  }
+
+}
@@ -0,0 +1,94 @@
+//
+// Sample a binned PDF in constant time with the alias method.
+//
+
+// Mu2e includes
+#include "Mu2eUtilities/inc/RandAliasTable.hh"
+
+// Framework includes
+#include "cetlib_except/exception.h"
+
+// C++ includes
+#include <cmath>
+
+namespace mu2e {
+
+  RandAliasTable::RandAliasTable(CLHEP::HepRandomEngine& engine, const double* pdf, int nBins, int intType)
+    : _engine(engine),
+      _interpolate(intType == 0)
+  {
+    makeTable(pdf, nBins);
+  }
+
+  RandAliasTable::RandAliasTable(CLHEP::HepRandomEngine& engine, const std::vector<double>& pdf, int intType)
+    : _engine(engine),
+      _interpolate(intType == 0)
+  {
+    makeTable(pdf.data(), pdf.size());
+  }
+
+  void RandAliasTable::makeTable(const double* pdf, int nBins) {
+
+    if ( nBins <= 0 ) {
+      throw cet::exception("BADCONFIG") << "RandAliasTable: empty PDF\n";
+    }
+
+    double sum(0.);
+    for ( int i=0; i<nBins; ++i ) {
+      if ( !(pdf[i] >= 0.) || !std::isfinite(pdf[i]) ) {
+        throw cet::exception("BADCONFIG") << "RandAliasTable: invalid PDF value " << pdf[i]
+                                          << " in bin " << i << "\n";
+      }
+      sum += pdf[i];
+    }
+    if ( !(sum > 0.) ) {
+      throw cet::exception("BADCONFIG") << "RandAliasTable: the PDF integrates to zero\n";
+    }
+
+    // Vose's algorithm: the probabilities are scaled to a mean of 1; each
+    // column below 1 is topped up by one column above 1, its alias.
+    _prob.resize(nBins);
+    _alias.resize(nBins);
+
+    std::vector<uint32_t> small, large;
+    small.reserve(nBins);
+    large.reserve(nBins);
+
+    std::vector<double> scaled(nBins);
+    for ( int i=0; i<nBins; ++i ) {
+      scaled[i] = pdf[i]*nBins/sum;
+      ( scaled[i] < 1. ? small : large ).push_back(i);
+    }
+
+    while ( !small.empty() && !large.empty() ) {
+      const uint32_t s = small.back(); small.pop_back();
+      const uint32_t l = large.back();
+      _prob[s]  = scaled[s];
+      _alias[s] = l;
+      scaled[l] = (scaled[l] + scaled[s]) - 1.;
+      if ( scaled[l] < 1. ) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+
+    // What is left is 1 up to rounding.
+    for ( auto i : large ) { _prob[i] = 1.; _alias[i] = i; }
+    for ( auto i : small ) { _prob[i] = 1.; _alias[i] = i; }
+  }
+
+  void RandAliasTable::fireArray(std::size_t n, double* vect) {
+    if ( n == 0 ) return;
+
+    const std::size_t nPerValue = _interpolate ? 2 : 1;
+    std::vector<double> flat(n*nPerValue);
+    _engine.flatArray(flat.size(), flat.data());
+
+    const double nBins = _prob.size();
+    for ( std::size_t i=0; i<n; ++i ) {
+      const double* r = &flat[i*nPerValue];
+      vect[i] = value(r[0]*nBins, _interpolate ? r[1] : 0.);
+    }
+  }
+
+} // end of namespace mu2e
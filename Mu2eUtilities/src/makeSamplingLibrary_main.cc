@@ -0,0 +1,114 @@
+// Convert the RootTreeSampler input trees into a memory-mapped sampling
+// library, see Mu2eUtilities/inc/MappedSamplingLibrary.hh.
+//
+// Usage:
+//   makeSamplingLibrary recordType treeName branchName output.slib input.root [input.root ...]
+//
+// where recordType is one of the single record types of GeneralUtilities/inc/RSNTIO.hh:
+// StoppedParticleF or StoppedParticleTauNormF.  All of the entries of all
+// of the inputs are written, in order.
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+
+#include "cetlib_except/exception.h"
+
+#include "GeneralUtilities/inc/RSNTIO.hh"
+#include "Mu2eUtilities/inc/MappedSamplingLibrary.hh"
+
+namespace {
+
+  template<class Record>
+  void convert(const std::string& treeName,
+               const std::string& branchName,
+               const std::string& outFile,
+               const std::vector<std::string>& inFiles)
+  {
+    std::vector<Record> records;
+
+    for(const auto& fn : inFiles) {
+      std::unique_ptr<TFile> infile(TFile::Open(fn.c_str(), "READ"));
+      if(!infile || infile->IsZombie()) {
+        throw cet::exception("BADINPUT")<<"makeSamplingLibrary: can not open \""<<fn<<"\"\n";
+      }
+
+      TTree *nt = dynamic_cast<TTree*>(infile->Get(treeName.c_str()));
+      if(!nt) {
+        throw cet::exception("BADINPUT")<<"makeSamplingLibrary: no tree \""<<treeName
+                                        <<"\" in \""<<fn<<"\"\n";
+      }
+
+      TBranch *bb = nt->GetBranch(branchName.c_str());
+      if(!bb) {
+        throw cet::exception("BADINPUT")<<"makeSamplingLibrary: no branch \""<<branchName
+                                        <<"\" in tree \""<<treeName<<"\" of \""<<fn<<"\"\n";
+      }
+
+      if(unsigned(bb->GetNleaves()) != Record::numBranchLeaves()) {
+        throw cet::exception("BADINPUT")<<"makeSamplingLibrary: wrong number of leaves: expect "
+                                        <<Record::numBranchLeaves()<<", branch \""<<branchName
+                                        <<"\" in \""<<fn<<"\" has "<<bb->GetNleaves()<<"\n";
+      }
+
+      Record r;
+      bb->SetAddress(&r);
+      const Long64_t n = nt->GetEntries();
+      records.reserve(records.size() + n);
+      for(Long64_t i=0; i<n; ++i) {
+        bb->GetEntry(i);
+        records.push_back(r);
+      }
+      nt->ResetBranchAddresses();
+
+      std::cout<<"makeSamplingLibrary: read "<<n<<" records from "<<fn<<std::endl;
+    }
+
+    mu2e::MappedSamplingLibrary::write(outFile, Record::branchDescription(), sizeof(Record),
+                                       records.data(), records.size());
+
+    std::cout<<"makeSamplingLibrary: wrote "<<records.size()<<" records to "<<outFile<<std::endl;
+  }
+
+}
+
+int main(int argc, char** argv) {
+
+  if(argc < 6) {
+    std::cerr<<"Usage: "<<argv[0]
+             <<" recordType treeName branchName output.slib input.root [input.root ...]\n"
+             <<"  recordType: StoppedParticleF or StoppedParticleTauNormF"<<std::endl;
+    return 1;
+  }
+
+  const std::string recordType(argv[1]);
+  const std::string treeName(argv[2]);
+  const std::string branchName(argv[3]);
+  const std::string outFile(argv[4]);
+  const std::vector<std::string> inFiles(argv+5, argv+argc);
+
+  try {
+    if(recordType == "StoppedParticleF") {
+      convert<mu2e::IO::StoppedParticleF>(treeName, branchName, outFile, inFiles);
+    }
+    else if(recordType == "StoppedParticleTauNormF") {
+      convert<mu2e::IO::StoppedParticleTauNormF>(treeName, branchName, outFile, inFiles);
+    }
+    else {
+      std::cerr<<argv[0]<<": unknown record type "<<recordType<<std::endl;
+      return 1;
+    }
+  }
+  catch(cet::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 2;
+  }
+
+  return 0;
+}
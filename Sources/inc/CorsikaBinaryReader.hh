@@ -0,0 +1,73 @@
+// Indexed access to the showers of a CORSIKA binary output file.
+//
+// The file is memory mapped and scanned once when it is opened.  The scan
+// strips the Fortran record structure and makes an index of the particle
+// data blocks of every shower, so that showers can be read in any order,
+// skipped or restarted in constant time and without further system calls.
+//
+// Both the standard output (records of 21 sub-blocks of 273 floats) and
+// the compact output (variable size blocks with EVHW event headers) are
+// supported.  A shower starts at its event header, EVTH or EVHW; its
+// particles are stored as groups of 7 floats, see the CORSIKA user guide.
+
+#ifndef Sources_inc_CorsikaBinaryReader_hh
+#define Sources_inc_CorsikaBinaryReader_hh
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mu2e {
+
+  class CorsikaBinaryReader {
+  public:
+
+    // A block of particle data: nParticles groups of 7 floats.
+    struct Block {
+      const float* data;
+      unsigned     nParticles;
+    };
+
+    CorsikaBinaryReader(const std::string& fileName, bool compact);
+    ~CorsikaBinaryReader();
+
+    CorsikaBinaryReader(const CorsikaBinaryReader&) = delete;
+    CorsikaBinaryReader& operator=(const CorsikaBinaryReader&) = delete;
+
+    const std::string& fileName() const { return fileName_; }
+    bool compact() const { return compact_; }
+
+    std::size_t numShowers() const { return showers_.size(); }
+
+    // The particle data blocks of shower i.
+    std::pair<const Block*, const Block*> blocks(std::size_t i) const {
+      const auto& s = showers_.at(i);
+      return std::make_pair(blocks_.data() + s.first, blocks_.data() + s.second);
+    }
+
+    static constexpr unsigned particleSize = 7;
+    static constexpr unsigned subBlockSize = 273;
+
+  private:
+    void indexStandard();
+    void indexCompact();
+
+    void beginShower();
+    void endShower();
+
+    std::string fileName_;
+    bool        compact_;
+
+    const char* base_;
+    std::size_t size_;
+
+    std::vector<Block> blocks_;
+    // Each shower is a [first,second) range of blocks_.
+    std::vector<std::pair<std::size_t, std::size_t>> showers_;
+    bool inShower_;
+  };
+
+}
+
+#endif/*Sources_inc_CorsikaBinaryReader_hh*/
@@ -35,6 +35,9 @@
 #include "fhiclcpp/types/ConfigurationTable.h"
 
 #include "Mu2eUtilities/inc/VectorVolume.hh"
+#include "Sources/inc/CorsikaBinaryReader.hh"
+
+#include <memory>
 
 
 namespace art
@@ -68,6 +71,8 @@ struct Config
   fhicl::Atom<int> seed{Name("seed"), Comment("Seed for particle random offset")};
   fhicl::Atom<bool> resample{Name("resample"), Comment("Resampling flag")};
   fhicl::Atom<bool> compact{Name("compact"), Comment("CORSIKA compact output flag")};
+  fhicl::Atom<unsigned> firstShower{Name("firstShower"), Comment("Index of the first shower read from each file, to split a file between jobs"), 0};
+  fhicl::Atom<unsigned> numShowers{Name("numShowers"), Comment("Number of showers read from each file, 0 for all of them from firstShower on"), 0};
 };
 typedef fhicl::WrappedTable<Config> Parameters;
 
@@ -216,11 +221,13 @@ namespace mu2e {
       };
 
       virtual bool generate(GenParticleCollection &, unsigned int &);
-      void openFile(FILE *f);
+      void openFile(const std::string &fileName);
+      void closeFile();
 
     private:
       bool genEvent(std::map<std::pair<int,int>, GenParticleCollection> &particles_map);
-      bool genEventCompact(std::map<std::pair<int,int>, GenParticleCollection> &particles_map);
+      void addParticle(const float *p, float xOffset, float zOffset,
+                       std::map<std::pair<int,int>, GenParticleCollection> &particles_map);
       float wrapvarBoxNo(const float var, const float low, const float high, int &boxno);
 
       std::vector<CLHEP::Hep3Vector> _targetBoxIntersections;
@@ -248,14 +255,17 @@ namespace mu2e {
       float _targetBoxZmin = 0;
       float _targetBoxZmax = 0;
 
-      FILE *in = nullptr;
-      int _loops = 0; // number of loops, necessary to skip the garbage data between blocks
-      float _garbage;
+      std::unique_ptr<CorsikaBinaryReader> _reader;
+      std::size_t _firstShower = 0;  // range of showers to read from the current file
+      std::size_t _endShower = 0;
+      std::size_t _nextShower = 0;
 
       unsigned int _primaries = 0;
 
       bool _resample = false;
       bool _compact = true;
+      unsigned _firstShowerConf = 0;
+      unsigned _numShowersConf = 0;
 
       CLHEP::HepJamesRandom _engine;
       CLHEP::RandFlat _randFlatX;
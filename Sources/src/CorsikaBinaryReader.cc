@@ -0,0 +1,199 @@
+#include "Sources/inc/CorsikaBinaryReader.hh"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cetlib_except/exception.h"
+
+namespace mu2e {
+
+  namespace {
+    bool hasName(const char* p, const char* name) {
+      return std::memcmp(p, name, 4) == 0;
+    }
+
+    int32_t wordAsInt(const char* p) {
+      int32_t res;
+      std::memcpy(&res, p, sizeof(res));
+      return res;
+    }
+  }
+
+  //================================================================
+  CorsikaBinaryReader::CorsikaBinaryReader(const std::string& fileName, bool compact)
+    : fileName_(fileName)
+    , compact_(compact)
+    , base_(nullptr)
+    , size_(0)
+    , inShower_(false)
+  {
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if(fd < 0) {
+      throw cet::exception("BADINPUT")<<"CorsikaBinaryReader: can not open \""<<fileName
+                                      <<"\": "<<std::strerror(errno)<<"\n";
+    }
+
+    struct stat st;
+    if(::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw cet::exception("BADINPUT")<<"CorsikaBinaryReader: can not stat \""<<fileName<<"\"\n";
+    }
+    size_ = st.st_size;
+
+    if(size_ > 0) {
+      void *addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if(addr == MAP_FAILED) {
+        throw cet::exception("BADINPUT")<<"CorsikaBinaryReader: can not map \""<<fileName
+                                        <<"\": "<<std::strerror(errno)<<"\n";
+      }
+      base_ = static_cast<const char*>(addr);
+      // The index is built in one sequential pass and showers are usually read in order.
+      ::madvise(addr, size_, MADV_SEQUENTIAL);
+    }
+    else {
+      ::close(fd);
+    }
+
+    if(compact_) {
+      indexCompact();
+    }
+    else {
+      indexStandard();
+    }
+    endShower();
+  }
+
+  //================================================================
+  CorsikaBinaryReader::~CorsikaBinaryReader() {
+    if(base_) {
+      ::munmap(const_cast<char*>(base_), size_);
+    }
+  }
+
+  //================================================================
+  void CorsikaBinaryReader::beginShower() {
+    endShower();
+    showers_.emplace_back(blocks_.size(), blocks_.size());
+    inShower_ = true;
+  }
+
+  void CorsikaBinaryReader::endShower() {
+    if(inShower_) {
+      showers_.back().second = blocks_.size();
+      inShower_ = false;
+    }
+  }
+
+  //================================================================
+  // Fortran records, each of them a 4 byte length, the data and the length
+  // again; the data are sub-blocks of 273 floats with a 4 character name.
+  void CorsikaBinaryReader::indexStandard() {
+    const std::size_t subBlockBytes = subBlockSize*sizeof(float);
+
+    // Particles are read up to the first empty slot of a shower.
+    bool validParticles = false;
+
+    std::size_t pos = 0;
+    while(pos + sizeof(int32_t) <= size_) {
+      const int32_t recordLength = wordAsInt(base_ + pos);
+      pos += sizeof(int32_t);
+
+      if(recordLength <= 0 || pos + recordLength + sizeof(int32_t) > size_) {
+        std::cerr<<"CorsikaBinaryReader: truncated record at byte "<<pos-sizeof(int32_t)
+                 <<" of "<<fileName_<<", ignoring the rest of the file"<<std::endl;
+        return;
+      }
+      if(recordLength % subBlockBytes != 0) {
+        throw cet::exception("BADINPUT")<<"CorsikaBinaryReader: record of "<<recordLength
+                                        <<" bytes in "<<fileName_
+                                        <<" is not a multiple of the sub-block size; is it a compact file?\n";
+      }
+
+      for(const char* sb = base_ + pos; sb < base_ + pos + recordLength; sb += subBlockBytes) {
+        if(hasName(sb, "RUNH") || hasName(sb, "LONG")) {
+          continue;
+        }
+        else if(hasName(sb, "EVTH")) {
+          beginShower();
+          validParticles = true;
+        }
+        else if(hasName(sb, "EVTE")) {
+          endShower();
+          validParticles = false;
+        }
+        else if(hasName(sb, "RUNE")) {
+          return;
+        }
+        else if(inShower_ && validParticles) {
+          const float* data = reinterpret_cast<const float*>(sb);
+          unsigned n = 0;
+          while(n < subBlockSize/particleSize && int(data[n*particleSize]/1000) != 0) {
+            ++n;
+          }
+          if(n < subBlockSize/particleSize) {
+            validParticles = false;
+          }
+          if(n > 0) {
+            blocks_.push_back(Block{data, n});
+          }
+        }
+      }
+
+      pos += recordLength + sizeof(int32_t);
+    }
+  }
+
+  //================================================================
+  // Blocks of the compact output start with their size in floats, a multiple
+  // of 7, and are followed by a 4 byte trailer.  The events after the first
+  // start with an EVHW word and 11 floats instead of a full EVTH block.  Words
+  // that are neither, i.e. the record markers, are skipped.
+  void CorsikaBinaryReader::indexCompact() {
+    const std::size_t eventHeaderBytes = 12*sizeof(float);
+
+    std::size_t pos = sizeof(int32_t);
+    while(pos + sizeof(int32_t) <= size_) {
+      const char* word = base_ + pos;
+
+      if(hasName(word, "EVHW")) {
+        beginShower();
+        pos += eventHeaderBytes;
+        continue;
+      }
+
+      const int32_t blockSize = wordAsInt(word);
+      pos += sizeof(int32_t);
+
+      if(blockSize > 0 && blockSize % particleSize == 0 && unsigned(blockSize) <= subBlockSize) {
+        const char* block = base_ + pos;
+        pos += blockSize*sizeof(float) + sizeof(int32_t);
+        if(pos > size_) {
+          std::cerr<<"CorsikaBinaryReader: truncated block at the end of "<<fileName_<<std::endl;
+          return;
+        }
+
+        if(hasName(block, "RUNE")) {
+          return;
+        }
+        else if(hasName(block, "RUNH") || hasName(block, "EVTE") || hasName(block, "LONG")) {
+          continue;
+        }
+        else if(hasName(block, "EVTH")) {
+          beginShower();
+        }
+        else if(inShower_) {
+          blocks_.push_back(Block{reinterpret_cast<const float*>(block), unsigned(blockSize)/particleSize});
+        }
+      }
+    }
+  }
+
+}
@@ -54,8 +54,6 @@ namespace mu2e {
       std::set<art::SubRunID> seenSRIDs_;
 
       std::string currentFileName_;
-      FILE *currentFile_ = nullptr;
-      float garbage;
 
       unsigned currentSubRunNumber_; // from file
       // A helper function used to manage the principals.
@@ -131,8 +129,7 @@ namespace mu2e {
       currentSubRunNumber_ = getSubRunNumber(filename);
       currentEventNumber_ = 0;
 
-      currentFile_ = fopen(filename.c_str(), "r");
-      _corsikaGen.openFile(currentFile_);
+      _corsikaGen.openFile(filename);
       fb = new art::FileBlock(art::FileFormatVersion(1, "CorsikaBinaryInput"), currentFileName_);
     }
 
@@ -151,7 +148,7 @@ namespace mu2e {
     //----------------------------------------------------------------
     void CorsikaBinaryDetail::closeCurrentFile() {
       currentFileName_ = "";
-      fclose(currentFile_);
+      _corsikaGen.closeFile();
     }
 
     //----------------------------------------------------------------
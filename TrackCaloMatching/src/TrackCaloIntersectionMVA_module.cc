@@ -5,21 +5,15 @@
 //
 // Original author B. Echenard
 //
-// A generic algorithm would either scan the track along every section in sequence or check every section along the path 
-// First option is optimal when sections are separated in z (e.g disks), second is ideal when sections are ovelapping in z (e.g. vanes)
-// Since it is very likely we have disks, the first choice has been selected (implementing the second should be straightforward)
+// The crossings of the track with the disks are found in one pass by CaloDiskIntersection: the local helix is intersected
+// analytically with the disk envelopes, then the entry / exit points are refined on the full trajectory against the crystals.
 
 // a few notes
 
-// Currently, we must extend the tracks to the calorimeter, but D. Brown said he would do that by default, so remove the corresponding 
+// Currently, we must extend the tracks to the calorimeter, but D. Brown said he would do that by default, so remove the corresponding
 // lines when this is ready
 
-// There are a bunch of methods only available for HelixTraj, but not for TrajDifTraj. D. Brown will add them later
-// and this code should be updated when they are available
 
-// There are some optimizations for the disk that can be set by defaults when we get rid of the vanes
-
- 
 // Framework includes.
 #include "art/Framework/Core/EDProducer.h"
 #include "art/Framework/Principal/Event.h"
@@ -55,6 +49,7 @@
 #include "BTrk/TrkBase/TrkRep.hh"
 #include "RecoDataProducts/inc/TrkCaloIntersectCollection.hh"
 #include "RecoDataProducts/inc/TrkFitDirection.hh"
+#include "TrkReco/inc/CaloDiskIntersection.hh"
 
 
 // Other includes.
@@ -123,17 +118,6 @@ namespace mu2e {
 
 	   void fillTrkNtup(int itrk, KalRepPtr const &kalrep,  TrkDifTraj const& traj, std::vector<TrkCaloInter> const& intersec);
 	   void doExtrapolation(TrkCaloIntersectCollection& extrapolatedTracks, KalRepPtrCollection const& trksPtrColl);
-	   void findIntersectSection(Calorimeter const& cal, TrkDifTraj const& traj, 
-	                             HelixTraj const& trkHel, unsigned int iSection, std::vector<TrkCaloInter>& intersect);
-	   
-           double scanIn(      Calorimeter const& cal, TrkDifTraj const& traj, HelixTraj const& trkHel, int iSection, double rangeStart, double rangeEnd);
-           double scanOut(     Calorimeter const& cal, TrkDifTraj const& traj, HelixTraj const& trkHel, int iSection, double rangeStart, double rangeEnd);
-           double scanBinary(  Calorimeter const& cal, TrkDifTraj const& traj, int iSection, double rangeIn, double rangeOut);
-
-           double fastForwardDisk(Calorimeter const& cal, TrkDifTraj const& traj, HelixTraj const& trkHel, double rangeInit, CLHEP::Hep3Vector& trjVec);
-           double extendToRadius(HelixTraj const& trkHel, TrkDifTraj const& traj, double range, double cylinderRad);
-           void   updateTrjVec(Calorimeter const& cal, TrkDifTraj const& traj, double range, CLHEP::Hep3Vector& trjVec);
-	   double radiusAtRange(TrkDifTraj const& traj, double range);
 	   
 
 	   std::string  _trkModuleLabel;
@@ -234,7 +218,7 @@ namespace mu2e {
     void TrackCaloIntersectionMVA::doExtrapolation(TrkCaloIntersectCollection& extrapolatedTracks, KalRepPtrCollection const& trksPtrColl)
     {
 	 Calorimeter const&  cal = *(GeomHandle<Calorimeter>());
-	 CLHEP::Hep3Vector   endCalTracker = cal.geomUtil().mu2eToTracker( CLHEP::Hep3Vector(cal.geomUtil().origin().x(),cal.geomUtil().origin().y(),cal.caloInfo().getDouble("envelopeZ1")) );
+	 CaloDiskIntersection diskInter(cal);
 	 
          	 
 	 for (unsigned int itrk=0; itrk< trksPtrColl.size(); ++itrk )
@@ -255,7 +239,17 @@ namespace mu2e {
 
 	      TrkDifTraj const& traj = krep->traj();
               
-	      for(unsigned int iSec=0; iSec<cal.nDisk(); ++iSec ) findIntersectSection(cal,traj,trkHel,iSec, intersectVec);  
+	      std::vector<CaloDiskIntersection::Crossing> crossings;
+	      diskInter.trajCrossings(cal,traj,trkHel,_pathStep,_tolerance,crossings);
+	      for (auto const& cross : crossings)
+	        {
+	          TrkCaloInter inter;
+	          inter.fSection  = cross.disk;
+	          inter.fSEntr    = cross.fltIn;
+	          inter.fSEntrErr = _tolerance;
+	          inter.fSExit    = _checkExit ? cross.fltOut : -1;
+	          intersectVec.push_back(inter);
+	        }
 	      if (_downstream) std::sort(intersectVec.begin(),intersectVec.end(),[](const TrkCaloInter& a, const TrkCaloInter& b ){ return a.fSEntr < b.fSEntr;});
 	      else             std::sort(intersectVec.begin(),intersectVec.end(),[](const TrkCaloInter& a, const TrkCaloInter& b ){ return a.fSEntr > b.fSEntr;});
 	      
@@ -272,274 +266,7 @@ namespace mu2e {
 
      }
 
-
-
-    //-----------------------------------------------------------------------------
-    // Find entry / exit points with a pseudo binary search
-    void TrackCaloIntersectionMVA::findIntersectSection(Calorimeter const& cal, TrkDifTraj const& traj,
-                                           HelixTraj const& trkHel, unsigned int iSection, std::vector<TrkCaloInter>& intersect)
-    {
-	 	 	 
-	 CLHEP::Hep3Vector frontFaceInTracker = cal.geomUtil().mu2eToTracker(cal.disk(iSection).geomInfo().frontFaceCenter());
-	 CLHEP::Hep3Vector backFaceInTracker  = cal.geomUtil().mu2eToTracker(cal.disk(iSection).geomInfo().backFaceCenter());
-	 
-	 double zStart       = (_downstream) ? frontFaceInTracker.z() : backFaceInTracker.z();
-	 double zEnd         = (_downstream) ? backFaceInTracker.z()  : frontFaceInTracker.z() ;	 	 
-	 double rangeStart   = trkHel.zFlight(zStart);
-	 double rangeEnd     = trkHel.zFlight(zEnd);
-         
-                  
-	 //apply first order correction to the helix model to match the trajDif model, add buffer to endRange to be on the safe side
-	 //D. Brown will add a zFlight() method for TrajDifTraj in the future, rewrite code when available	 
-	 double sinDip         = sqrt(1.0-trkHel.cosDip()*trkHel.cosDip());
-	 double rangeStartCorr = (zStart-traj.position(rangeStart).z())/sinDip;
-         double rangeEndCorr   = (zEnd-traj.position(rangeEnd).z())/sinDip +2;
-	 	 
-	 if (_downstream) {rangeStart += rangeStartCorr;rangeEnd += rangeEndCorr;} 
-	 else             {rangeStart -= rangeStartCorr;rangeEnd -= rangeEndCorr;} 
-
-
-         if (_diagLevel>1) std::cout<<"TrackCaloIntersectionMVA inter   rangeStart = "<<rangeStart<<"   rangeEnd="<<rangeEnd
-	                            <<"  from z in Tracker="<<zStart<<" - "<<zEnd
-				    <<"  Start at position "<< traj.position(rangeStart)<<std::endl;
-
-
-	 double rangeIn = scanIn(cal,traj,trkHel,iSection,rangeStart, rangeEnd);
-
-	 if (rangeIn > rangeEnd)
-	 {
-	     if (_diagLevel>1) std::cout<<"TrackCaloIntersectionMVA end search behind Section "<<iSection<<",range= "<<rangeIn<<", position is : "<<traj.position(rangeIn)<<std::endl;
-	     return;
-	 }  
-	 
-
-	 double rangeOut(-1);
-         if (_checkExit) rangeOut = scanOut(cal, traj, trkHel, iSection, rangeIn+1, rangeEnd);
-
-	 
-	 TrkCaloInter inter;
-	 inter.fSection  = iSection;
-	 inter.fSEntr    = rangeIn;
-	 inter.fSEntrErr = _tolerance;
-	 inter.fSExit    = rangeOut;
-	 intersect.push_back(inter); 
-
-    }
-
-
-    //-----------------------------------------------------------------------------
-    // find two starting points inside and outside of the calorimeter, either move out if we're in, or move in if we're out
-    // if we are outside the calorimeter envelope, fast forward to the envelope
-    double TrackCaloIntersectionMVA::scanIn(Calorimeter const& cal, TrkDifTraj const& traj, HelixTraj const& trkHel, int iSection, double rangeStart, double rangeEnd)
-    {         
-
-	 //check if we're inside the rdial envelope, if not, fast forward to it
-	 double initRadius = radiusAtRange(traj,rangeStart);
-	 
-
-
-	 if (initRadius < cal.disk(iSection).geomInfo().innerEnvelopeR())  rangeStart += extendToRadius(trkHel, traj, rangeStart, cal.disk(iSection).geomInfo().innerEnvelopeR());	 
-	 if (initRadius > cal.disk(iSection).geomInfo().outerEnvelopeR()) rangeStart += extendToRadius(trkHel, traj, rangeStart, cal.disk(iSection).geomInfo().outerEnvelopeR()); 
-
-	 if (rangeStart > rangeEnd) return rangeEnd+1e-4;
-
-
-	 //now find two starting points, one inside the boundary, the other outside
-	 CLHEP::Hep3Vector trjVec;
-	 updateTrjVec(cal,traj,rangeStart,trjVec);
-	 
-	 double rangeIn(rangeStart),rangeOut(rangeStart);
-	 if ( cal.geomUtil().isInsideSection(iSection,trjVec))
-	 {
-	      while (cal.geomUtil().isInsideSection(iSection,trjVec))
-	      {
-		 rangeIn = rangeOut; 
-		 rangeOut -= _pathStep;
-		 updateTrjVec(cal,traj,rangeOut,trjVec);
-		 if (_diagLevel>2) std::cout<<"TrackExtrpol position scan In down "<<trjVec<<"  for currentRange="<<rangeOut<<"   "<<"radius="<<radiusAtRange(traj,rangeOut)<<std::endl;
-	      }	 
-
-	 } else {
-	 
-	      while ( !cal.geomUtil().isInsideSection(iSection,trjVec) )
-	      {
-		 rangeOut = rangeIn; 
-		 rangeIn += _pathStep;
-        	 updateTrjVec(cal,traj,rangeIn,trjVec);
-		 if (_diagLevel>2) std::cout<<"TrackExtrpol position scan In up "<<trjVec<<"  for currentRange="<<rangeIn<<"   "<<"radius="<<radiusAtRange(traj,rangeIn)<<std::endl;
-
-		 if ( rangeIn > rangeEnd) return rangeIn;
-	      }	    
-	 }
-	 
-	 //finally, run the binary search for the intersection
-	 return scanBinary(cal, traj, iSection, rangeIn, rangeOut);
-    }
-
-
-
-    //-----------------------------------------------------------------------------
-    // generic algorithm: step along the track (coarse search) until you reach the outside of the calo section, then refine with binary search
-    double TrackCaloIntersectionMVA::scanOut(Calorimeter const& cal, TrkDifTraj const& traj, HelixTraj const& trkHel, int iSection, double rangeStart, double rangeEnd)
-    {         
-
-	 double range(rangeStart);
-	 CLHEP::Hep3Vector trjVec;
-	 updateTrjVec(cal,traj,range,trjVec);
-
-         while ( cal.geomUtil().isInsideSection(iSection,trjVec) )
-	 {         	    
-	    range += _pathStep;
-	    updateTrjVec(cal,traj,range,trjVec);
-	    if (_diagLevel>2) std::cout<<"TrackExtrpol position scan Out up "<<trjVec<<"  for currentRange="<<range<<"   "<<"radius="<<radiusAtRange(traj,range)<<std::endl;	 	 
-	 }
-
-	 return scanBinary(cal, traj, iSection, range - _pathStep, range);
-    }
-    
-
-    //-----------------------------------------------------------------------------
-    double TrackCaloIntersectionMVA::scanBinary(Calorimeter const& cal, TrkDifTraj const& traj, int iSection, double rangeIn, double rangeOut)
-    {         
-         
-	 CLHEP::Hep3Vector trjVec;
-         
-	 double range = 0.5*(rangeOut+rangeIn);
-	 while ( fabs(rangeIn-rangeOut) > _tolerance)
-	 {
-	     updateTrjVec(cal,traj,range,trjVec);
-	     if (_diagLevel>2) std::cout<<"TrackExtrpol position scan Binary "<<trjVec<<"  for currentRange="<<range<<std::endl;
-	     
-	     if (cal.geomUtil().isInsideSection(iSection,trjVec)) rangeIn=range;
-	     else                                      rangeOut=range;
-	     range = 0.5*(rangeOut+rangeIn);	     
-	 }
-	 
-         return range;
-    }
-
-
- 
-
-
-
-
-    //-----------------------------------------------------------------------------
-    void TrackCaloIntersectionMVA::updateTrjVec(Calorimeter const& cal, TrkDifTraj const& traj, double range, CLHEP::Hep3Vector& trjVec)
-    {
-       HepPoint trjPoint = traj.position(range);
-       trjVec.set(trjPoint.x(),trjPoint.y(),trjPoint.z());
-       trjVec = cal.geomUtil().trackerToMu2e(trjVec);    
-    }
-
-
-    //-----------------------------------------------------------------------------
-    double TrackCaloIntersectionMVA::radiusAtRange(TrkDifTraj const& traj, double range)
-    {
-       HepPoint trjPoint = traj.position(range);
-       return sqrt(trjPoint.x()*trjPoint.x()+trjPoint.y()*trjPoint.y());
-    }
-
-    
-    //-----------------------------------------------------------------------------
-    // see http://paulbourke.net/geometry/circlesphere  for notation
-    double TrackCaloIntersectionMVA::extendToRadius(HelixTraj const& trkHel, TrkDifTraj const& traj, double range, double cylinderRad)
-    {         
-
-	 double radius    = 1.0/trkHel.omega();
-	 double centerX   = -(trkHel.d0() + radius)*sin(trkHel.phi0());
-	 double centerY   =  (trkHel.d0() + radius)*cos(trkHel.phi0());
-	 double d         = fabs(trkHel.d0() + radius);
-	 double a         = (cylinderRad*cylinderRad-radius*radius+d*d)/2.0/d;
-
-	 //if a <cylinderRad, track never crosses cylinder, return overflow value
-	 if (a>cylinderRad) return 1e6;
-
-	 double h       = sqrt(cylinderRad*cylinderRad-a*a);	     
-	 double xi1     = (a*centerX+h*centerY)/d;
-	 double yi1     = (a*centerY-h*centerX)/d;
-	 double xi2     = (a*centerX-h*centerY)/d;
-	 double yi2     = (a*centerY+h*centerX)/d;
-
-	 HepPoint trjPoint = traj.position(range); 
-	 double phi_i      = (trjPoint.y()-centerY>0) ? atan2(trjPoint.y()-centerY,trjPoint.x()-centerX) : atan2(trjPoint.y()-centerY,trjPoint.x()-centerX) + 2*Constants::pi;
-	 double phi_s1     = (yi1-centerY>0) ? atan2(yi1-centerY,xi1-centerX) : atan2(yi1-centerY,xi1-centerX) + 2*Constants::pi;
-	 double phi_s2     = (yi2-centerY>0) ? atan2(yi2-centerY,xi2-centerX) : atan2(yi2-centerY,xi2-centerX) + 2*Constants::pi;
-
-	 double dphi1      = (phi_s1 > phi_i) ? phi_s1-phi_i : phi_s1-phi_i + 2*Constants::pi;
-	 double dphi2      = (phi_s2 > phi_i) ? phi_s2-phi_i : phi_s2-phi_i + 2*Constants::pi;
-
-	 //for downstream tracks (need to check how upstream works)
-	 double dphi       = (radius>0) ? std::min(dphi1,dphi2) : 2*Constants::pi - std::max(dphi1,dphi2);
-	 double dlen       = fabs(radius)*dphi/trkHel.cosDip();
-
-	 //calculate first order correction between the helix representation and the actual trajectory
-	 double corr = (radiusAtRange(traj,range+dlen)-cylinderRad) / (radiusAtRange(traj,range+dlen) - radiusAtRange(traj,range+dlen+1) );
-	 dlen += corr;
-
-	 if (dlen < 0) dlen=0;
-
-	 return dlen;
-    }
-
-
-
-
 }
 
 using mu2e::TrackCaloIntersectionMVA;
 DEFINE_ART_MODULE(TrackCaloIntersectionMVA);
-
-
-
-
-
-/*
-
-//-----------------------------------------------------------------------------
-// This is an old routine to find the exit point for the disk. The mismatch between the true trajectory and the local helix approximation caused
-// an infinite loop. The idea is to try to fast-forward right outside the disk inner / outer boundaries, then backtrack a little bit to be inside. 
-// If the fast-forwarding keeps you inside instead of being outside, you backtrack to the origin, leading to an infinite loop...
-
-double TrackCaloIntersectionMVA::scanOutDisk(Calorimeter const& cal, TrkDifTraj const& traj, HelixTraj const& trkHel, int iSection, double rangeStart, double rangeEnd)
-{         
-
-     double rangeForward(0);
-     double caloRadiusIn  = cal.disk(iSection).innerEnvelopeR() + 2*cal.diskInfo().crystalXYLength();
-     double caloRadiusOut = cal.disk(iSection).outerEnvelopeR() - 2*cal.diskInfo().crystalXYLength();
-
-     double range(rangeStart);
-
-     CLHEP::Hep3Vector trjVec;
-     updateTrjVec(cal,traj,range,trjVec);
-
-     while ( cal.isInsideSection(iSection,trjVec) )
-     {         	    
-	  double radius = radiusAtRange(traj,range);
-
-	  if (radius > caloRadiusIn &&  radius < caloRadiusOut && fabs(range-rangeForward) > 10*_pathStep )
-	  {
-	      double lenInner = extendToRadius(trkHel, traj, range, caloRadiusIn );
-	      double lenOuter = extendToRadius(trkHel, traj, range, caloRadiusOut );
-	      double deltaLen = std::min(lenInner,lenOuter);
-
-	      //the mismatch between traj and trkHelk causes forwarding to remain at the same point in some instances
-	      if (deltaLen > 0 )
-	      {
-		  range += deltaLen;
-		  if (range > rangeEnd) range = rangeEnd - _pathStep;
-		  rangeForward = range;
-
-		  updateTrjVec(cal,traj,range,trjVec);
-		  while( !cal.isInsideSection(iSection,trjVec) ) {range -= _pathStep; updateTrjVec(cal,traj,range,trjVec);}
-	      }      
-	  }
-
-	range += _pathStep;
-	updateTrjVec(cal,traj,range,trjVec);
-     }         
-
-     return scanBinary(cal, traj, iSection, range - _pathStep, range);
-}
-
-*/
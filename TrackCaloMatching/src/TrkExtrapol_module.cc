@@ -44,6 +44,7 @@
 #include "MCDataProducts/inc/PtrStepPointMCVectorCollection.hh"
 #include "MCDataProducts/inc/StepPointMCCollection.hh"
 #include "RecoDataProducts/inc/TrkToCaloExtrapol.hh"
+#include "TrkReco/inc/CaloDiskIntersection.hh"
 
 
 //calorimeter includes
@@ -117,6 +118,8 @@ namespace mu2e {
       _fdir((TrkFitDirection::FitDirection)(pset.get<int>("fitdirection",TrkFitDirection::downstream))),
       _diagLevel(pset.get<int>("diagLevel",0)),
       _outPutNtup(pset.get<int>("outPutNtup",0)),
+      _pathStep(pset.get<double>("pathStep",2.)),
+      _tolerance(pset.get<double>("tolerance",1.)),
       _generatorModuleLabel(pset.get<std::string>("generatorModuleLabel",
 						  "generate")),
       _g4ModuleLabel(pset.get<std::string>("g4ModuleLabel", "g4run")),
@@ -175,6 +178,10 @@ namespace mu2e {
     int _diagLevel;
     int _outPutNtup;
 
+    // coarse step and precision of the search for the disk entry / exit, mm
+    double _pathStep;
+    double _tolerance;
+
     // Label of the generator.
     std::string _generatorModuleLabel;
 
@@ -214,25 +221,11 @@ namespace mu2e {
     double _ZbackFaceCalo;
 
 
-    CLHEP::Hep3Vector fromTrkToMu2eFrame(CLHEP::Hep3Vector  &vec);
-
     void filltrkdiag(int itrk, IntersectData_t *intersec,
 		     int size, KalRep const* kalrep);
 
   };
 
-  CLHEP::Hep3Vector TrkExtrapol::fromTrkToMu2eFrame(CLHEP::Hep3Vector  &vec){
-    art::ServiceHandle<GeometryService> geom;
-    double solenoidOffSetX = geom->config().getDouble("mu2e.solenoidOffset");
-    double solenoidOffSetZ = -geom->config().getDouble("mu2e.detectorSystemZ0");
-    CLHEP::Hep3Vector res;
-
-    res.setX(vec.x() - solenoidOffSetX);
-    res.setZ(vec.z() - solenoidOffSetZ);
-    res.setY(vec.y());
-    return res;
-  }
-
   void TrkExtrapol::caloExtrapol(int&             diagLevel,
 				 int              evtNumber,
 				 TrkFitDirection  fdir,
@@ -243,7 +236,6 @@ namespace mu2e {
 				 int              &res0,
 				 int&              NIntersections,
 				 IntersectData_t*  Intersection  ) {
-    art::ServiceHandle<GeometryService> geom;
     GeomHandle<DiskCalorimeter> cg;
     static const char* oname = "TrkExtrapol::caloExtrapol";
 
@@ -277,105 +269,30 @@ namespace mu2e {
 
     TrkDifTraj const &traj = Krep->traj();
 
-    double circleRadius; // P.Murat: has to be always positive
-    double startLowrange = lowrange;
-    if(fdir.dzdt() == -1.0) startLowrange = highrange;
-    circleRadius = fabs(1.0/trkHel.omega());
-
-    int nSections = cg->nDisk();
-
-    double *entr   = new double[nSections];
-    double *ex     = new double[nSections];
-    bool *isInside = new bool[nSections];
-
-    for(int jSection=0; jSection<nSections; ++jSection){
-      isInside[jSection] = false;
-      entr[jSection] = 0.0;
-      ex[jSection] = 0.0;
-    }
-    int nAngleSteps = 500;
-
-    double pathStepSize = Constants::twoPi / (double) nAngleSteps;
-    nAngleSteps *= 2.0;
-
-    pathStepSize *= circleRadius/fabs(trkHel.cosDip());
-
-    if (diagLevel>2){
-      cout<< "circle radius = "<< circleRadius<<
-	", pathStepSize = "<<pathStepSize<<endl;
-    }
-
-    double tmpRange = startLowrange;
+    //-----------------------------------------------------------------------------
+    // crossings of the track with the disks, the entry is the first crystal
+    // reached in the direction of the fit
+    //-----------------------------------------------------------------------------
+    CaloDiskIntersection diskInter(*cg);
+    std::vector<CaloDiskIntersection::Crossing> crossings;
+    diskInter.trajCrossings(*cg,traj,trkHel,_pathStep,_tolerance,crossings);
 
     NIntersections = 0;
-    CLHEP::Hep3Vector trjVec;
-    HepPoint trjPoint;
-
-    for(int iStep = 0; iStep< nAngleSteps; ++iStep){
-      for(int jSection=0; jSection<nSections; ++jSection){
-	trjPoint = traj.position(tmpRange);
-	if(diagLevel>4){
-	  cout<<" tmpRange = "<< tmpRange<<
-	    ", trj.position(tmpRange) = "<<trjPoint<<endl;
-	}
-
-	trjVec.setX(trjPoint.x());
-	trjVec.setY(trjPoint.y());
-	trjVec.setZ(trjPoint.z());
-
-	trjVec = fromTrkToMu2eFrame(trjVec);
-
-	if( cg->geomUtil().isInsideSection(jSection,trjVec ) ){
-	  if(!isInside[jSection]){
-	    if(diagLevel>4){
-	      cout<<"Event Number : "<< evtNumber<< endl;
-	      cout<<" vane "<<jSection<<
-		"isInside : true"<<
-		"pathLength entrance = "<<tmpRange<<endl;
-	    }
-	    isInside[jSection] = true;
-	    if(fdir.dzdt() == 1.0){
-	      entr[jSection] = tmpRange - pathStepSize;
-	    }else if(fdir.dzdt() == -1.0){
-	      entr[jSection] = tmpRange + pathStepSize;
-	    }
-	  }
-	}else if(isInside[jSection]){
-	  ex[jSection] = tmpRange + pathStepSize;
-	  if(diagLevel>4){
-	    cout<<"Event Number : "<< evtNumber<< endl;
-	    cout<<" vane "<<jSection<<
-	      "isInside : true"<<
-	      "hasExit : true"<<
-	      "pathLength entrance = "<<entr[jSection]<<
-	      "pathLength exit = "<<tmpRange<<endl;
-	  }
-	  isInside[jSection] = false;
-
-	  if (NIntersections < 100) {
-	    Intersection[NIntersections].fSection  = jSection;
-	    Intersection[NIntersections].fRC    = 0;
-	    Intersection[NIntersections].fSEntr = entr[jSection];
-	    Intersection[NIntersections].fSExit = ex  [jSection];
-	    NIntersections++;
-	  }
-	  else {
-	    printf("%s ERROR: NIntersections > 100, TRUNCATE LIST\n",oname);
-	  }
-	}
+    for (auto const& cross : crossings) {
+      if (NIntersections == 100) {
+	printf("%s ERROR: NIntersections > 100, TRUNCATE LIST\n",oname);
+	break;
       }
-      if(fdir.dzdt() == 1.0){
-	tmpRange += pathStepSize;
-      }else if(fdir.dzdt() == -1.0){
-	tmpRange -= pathStepSize;
+      IntersectData_t& inter = Intersection[NIntersections++];
+      inter.fSection = cross.disk;
+      inter.fRC      = 0;
+      inter.fSEntr   = (fdir.dzdt() == -1.0) ? cross.fltOut : cross.fltIn;
+      inter.fSExit   = (fdir.dzdt() == -1.0) ? cross.fltIn  : cross.fltOut;
+      if (diagLevel>4) {
+	cout<<"Event Number : "<< evtNumber<<" disk "<<cross.disk<<
+	  " pathLength entrance = "<<inter.fSEntr<<" exit = "<<inter.fSExit<<endl;
       }
     }
-    //  }
-
-
-    if (diagLevel>2) {
-      cout<<"end search behindSection(), position is : "<<traj.position(tmpRange)<<endl;
-    }
 
     double     lrange;
     TrkErrCode trk_rc;
@@ -396,10 +313,6 @@ namespace mu2e {
 
     }
 
-    delete [] isInside ;
-    delete [] entr ;
-    delete [] ex;
-
   }//end proce_dUre
 
 
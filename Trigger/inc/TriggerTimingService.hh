@@ -0,0 +1,130 @@
+//
+// Latency of the modules and paths of a trigger configuration.
+//
+// The wall and CPU time of every module call are appended to a ring buffer
+// owned by the calling thread, so the event loop takes no locks.  After the
+// event loop the buffers are merged: the module times are summed per event
+// and trigger path, and the mean and percentiles of the module, path and
+// event latencies are computed.  ReadTriggerInfo writes them next to the
+// trigger rates; the end of job summary also gives the throughput per core,
+// so that running a trigger menu over a file estimates the farm it needs.
+//
+// A module that runs on several paths is executed on the first path that
+// reaches it only; its time is charged to that path.  If a thread makes more
+// module calls than the buffer holds, its oldest samples are overwritten.
+//
+
+#ifndef Trigger_TriggerTimingService_hh
+#define Trigger_TriggerTimingService_hh
+
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceMacros.h"
+#include "fhiclcpp/ParameterSet.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace art {
+  class Event;
+  class ModuleContext;
+  class ModuleDescription;
+  class ScheduleContext;
+}
+
+namespace mu2e {
+
+  class TriggerTimingService {
+  public:
+
+    // Latency distribution of one module, path or of the whole event, in ms.
+    struct Summary {
+      std::string name;
+      unsigned    nEvents  = 0;
+      float       wallMean = 0, wallP50 = 0, wallP90 = 0, wallP99 = 0, wallMax = 0;
+      float       cpuMean  = 0, cpuP50  = 0, cpuP90  = 0, cpuP99  = 0, cpuMax  = 0;
+    };
+
+    TriggerTimingService(const fhicl::ParameterSet&, art::ActivityRegistry&);
+
+    TriggerTimingService(TriggerTimingService const&) = delete;
+    TriggerTimingService& operator=(TriggerTimingService const&) = delete;
+
+    // Only meaningful once the event loop is over, e.g. in endJob.
+    std::vector<Summary> moduleSummaries() const;
+    std::vector<Summary> pathSummaries()   const;
+    Summary              eventSummary()    const;
+
+    // Events per second for one core, from the mean CPU time per event,
+    // and events per second of this job, all schedules together.
+    double throughputPerCore() const;
+    double jobThroughput()     const;
+
+  private:
+
+    struct Sample {
+      uint64_t event;
+      uint16_t path;
+      uint16_t module;
+      float    wall;  // ms
+      float    cpu;   // ms
+    };
+
+    struct Start {
+      std::chrono::steady_clock::time_point wall;
+      double                                cpu;   // ms
+    };
+
+    // Filled by one thread only; read after the event loop.
+    struct ThreadBuffer {
+      explicit ThreadBuffer(size_t size) : next(0), wrapped(false) { samples.resize(size); }
+      std::vector<Sample> samples;
+      size_t              next;
+      bool                wrapped;
+      std::vector<Start>  starts;  // module calls in progress on this thread
+    };
+
+    // Call backs that will be called by art.
+    void postModuleConstruction(art::ModuleDescription const& md);
+    void postBeginJob();
+    void preProcessEvent (art::Event const&, art::ScheduleContext sc);
+    void postProcessEvent(art::Event const&, art::ScheduleContext sc);
+    void preModule (art::ModuleContext const& mc);
+    void postModule(art::ModuleContext const& mc);
+    void postEndJob();
+
+    ThreadBuffer& threadBuffer();
+    std::vector<Sample> samples() const;
+    void print(std::ostream& os) const;
+
+    int    _verbosity;
+    size_t _bufferSize;
+
+    // Set before the event loop, read only afterwards.
+    std::vector<std::string>                  _moduleNames;
+    std::unordered_map<std::string, uint16_t> _moduleIds;
+    std::vector<std::string>                  _pathNames;   // the last one collects the end path
+    std::unordered_map<std::string, uint16_t> _pathIds;
+
+    // Serial number of the event being processed by each schedule.
+    std::vector<uint64_t>  _eventOfSchedule;
+    std::atomic<uint64_t>  _nEvents;
+
+    std::mutex                                _bufferMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+
+    std::chrono::steady_clock::time_point _startTime;
+    std::chrono::steady_clock::time_point _lastEvent;
+    std::mutex                            _clockMutex;
+  };
+
+}
+
+DECLARE_ART_SERVICE(mu2e::TriggerTimingService, SHARED)
+#endif /* Trigger_TriggerTimingService_hh */
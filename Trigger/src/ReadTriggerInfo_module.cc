@@ -59,6 +59,7 @@
 //Utilities
 #include "Mu2eUtilities/inc/TriggerResultsNavigator.hh"
 #include "Mu2eUtilities/inc/HelixTool.hh"
+#include "Trigger/inc/TriggerTimingService.hh"
 
 //ROOT
 #include "TH1F.h"
@@ -223,6 +224,7 @@ namespace mu2e {
 
     void     findCorrelatedEvents (std::vector<string>& VecLabels, double &NCorrelated);
     void     evalTriggerRate      ();
+    void     fillTimingInfo       ();
 
   private:
 
@@ -242,6 +244,7 @@ namespace mu2e {
     string                    _processName;
 
     float                     _nProcess;
+    bool                      _fillTiming;
     double                    _bz0;
 
     double                    _nPOT;
@@ -286,7 +289,8 @@ namespace mu2e {
     _evtWeightTag  (pset.get<art::InputTag>("protonBunchIntensity" , "protonBunchIntensity")),
     _duty_cycle    (pset.get<float> ("dutyCycle", 1.)),
     _processName   (pset.get<string> ("processName", "globalTrigger")),
-    _nProcess      (pset.get<float> ("nEventsProcessed", 1.))
+    _nProcess      (pset.get<float> ("nEventsProcessed", 1.)),
+    _fillTiming    (pset.get<bool>  ("fillTimingInfo", false))
   {
     _trigAll.      resize(_nMaxTrig);	     
     _trigFinal.    resize(_nMaxTrig);    
@@ -705,6 +709,41 @@ namespace mu2e {
     // now evaluate the bandwidth
     // NOTE: "evalTriggerrate" re-order the vectors _trigFinal
     evalTriggerRate();
+
+    // latency of the paths and modules, from the TriggerTimingService
+    if (_fillTiming) fillTimingInfo();
+  }
+
+  //--------------------------------------------------------------------------------
+  void   ReadTriggerInfo::fillTimingInfo         (){
+    art::ServiceHandle<TriggerTimingService> timing;
+    art::ServiceHandle<art::TFileService>    tfs;
+    art::TFileDirectory trigTimingDir = tfs->mkdir("trigTiming");
+
+    auto  fill = [&trigTimingDir](const char* Name, const char* Title, std::vector<TriggerTimingService::Summary> const& Sums){
+      const char* var  [7] = {"Mean", "P50", "P90", "P99", "Max", "CpuMean", "CpuP99"};
+      const char* vtit [7] = {"mean", "median", "90%", "99%", "max", "mean CPU", "99% CPU"};
+      int         nbins    = Sums.size();
+      for (int j=0; j<7; ++j){
+	TH1F* h = trigTimingDir.make<TH1F>(Form("h%s%s", Name, var[j]), Form("%s %s latency; ; t [ms]", Title, vtit[j]), nbins, -0.5, nbins-0.5);
+	for (int i=0; i<nbins; ++i){
+	  auto const& s = Sums[i];
+	  float val[7] = {s.wallMean, s.wallP50, s.wallP90, s.wallP99, s.wallMax, s.cpuMean, s.cpuP99};
+	  h->GetXaxis()->SetBinLabel(i+1, s.name.c_str());
+	  h->SetBinContent(i+1, val[j]);
+	}
+      }
+    };
+
+    fill("Path"  , "Trigger path", timing->pathSummaries());
+    fill("Module", "Module"      , timing->moduleSummaries());
+    fill("Event" , "Event"       , std::vector<TriggerTimingService::Summary>(1, timing->eventSummary()));
+
+    TH1F* hThroughput = trigTimingDir.make<TH1F>("hThroughput", "Throughput; ; events/s", 2, -0.5, 1.5);
+    hThroughput->GetXaxis()->SetBinLabel(1, "per core");
+    hThroughput->SetBinContent(1, timing->throughputPerCore());
+    hThroughput->GetXaxis()->SetBinLabel(2, "job");
+    hThroughput->SetBinContent(2, timing->jobThroughput());
   }
   
   //--------------------------------------------------------------------------------  
@@ -0,0 +1,278 @@
+//
+// Latency of the modules and paths of a trigger configuration.
+//
+// The implementation is in the main library, so that modules, e.g.
+// ReadTriggerInfo, can link against it.
+//
+
+#include "Trigger/inc/TriggerTimingService.hh"
+
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "art/Framework/Services/System/TriggerNamesService.h"
+#include "art/Persistency/Provenance/ModuleContext.h"
+#include "art/Persistency/Provenance/ModuleDescription.h"
+#include "art/Persistency/Provenance/ScheduleContext.h"
+#include "art/Utilities/Globals.h"
+#include "cetlib_except/exception.h"
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+
+namespace mu2e {
+
+  namespace {
+
+    // The buffer of the current thread; owner guards against a buffer of
+    // an earlier instance of the service.
+    struct ThreadSlot {
+      const void* owner  = nullptr;
+      void*       buffer = nullptr;
+    };
+    thread_local ThreadSlot threadSlot;
+
+    // CPU time of the calling thread in ms.  Work that a module hands to
+    // other threads is not included.
+    double threadCPUTime() {
+      timespec ts;
+      clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+      return ts.tv_sec*1.0e3 + ts.tv_nsec*1.0e-6;
+    }
+
+    float percentile(std::vector<float> const& sorted, float q) {
+      if (sorted.empty()) return 0;
+      return sorted[static_cast<size_t>(q*(sorted.size()-1) + 0.5)];
+    }
+
+    void summarize(std::vector<float>& wall, std::vector<float>& cpu, TriggerTimingService::Summary& s) {
+      s.nEvents = wall.size();
+      if (wall.empty()) return;
+      std::sort(wall.begin(), wall.end());
+      std::sort(cpu.begin(),  cpu.end());
+      double wsum(0), csum(0);
+      for (auto w : wall) wsum += w;
+      for (auto c : cpu)  csum += c;
+      s.wallMean = wsum/wall.size();
+      s.wallP50  = percentile(wall, 0.50);
+      s.wallP90  = percentile(wall, 0.90);
+      s.wallP99  = percentile(wall, 0.99);
+      s.wallMax  = wall.back();
+      s.cpuMean  = csum/cpu.size();
+      s.cpuP50   = percentile(cpu, 0.50);
+      s.cpuP90   = percentile(cpu, 0.90);
+      s.cpuP99   = percentile(cpu, 0.99);
+      s.cpuMax   = cpu.back();
+    }
+
+  }
+
+  TriggerTimingService::TriggerTimingService(fhicl::ParameterSet const& pset,
+                                             art::ActivityRegistry& iRegistry) :
+    _verbosity (pset.get<int>   ("verbosity", 1)),
+    _bufferSize(pset.get<size_t>("samplesPerThread", 1000000)),
+    _nEvents(0)
+  {
+    if (_bufferSize == 0) {
+      throw cet::exception("CONFIG") << "TriggerTimingService: samplesPerThread must be positive\n";
+    }
+
+    iRegistry.sPostModuleConstruction.watch(this, &TriggerTimingService::postModuleConstruction);
+    iRegistry.sPostBeginJob.watch          (this, &TriggerTimingService::postBeginJob          );
+    iRegistry.sPreProcessEvent.watch       (this, &TriggerTimingService::preProcessEvent       );
+    iRegistry.sPostProcessEvent.watch      (this, &TriggerTimingService::postProcessEvent      );
+    iRegistry.sPreModule.watch             (this, &TriggerTimingService::preModule             );
+    iRegistry.sPostModule.watch            (this, &TriggerTimingService::postModule            );
+    iRegistry.sPostEndJob.watch            (this, &TriggerTimingService::postEndJob            );
+  }
+
+  void TriggerTimingService::postModuleConstruction(art::ModuleDescription const& md) {
+    if (_moduleIds.count(md.moduleLabel())) return;
+    _moduleIds[md.moduleLabel()] = _moduleNames.size();
+    _moduleNames.push_back(md.moduleLabel());
+  }
+
+  void TriggerTimingService::postBeginJob() {
+    art::ServiceHandle<art::TriggerNamesService const> tns;
+    for (auto const& name : tns->getTrigPaths()) {
+      _pathIds[name] = _pathNames.size();
+      _pathNames.push_back(name);
+    }
+    _pathNames.push_back("end_paths");
+
+    _eventOfSchedule.assign(art::Globals::instance()->nschedules(), 0);
+    _startTime = _lastEvent = std::chrono::steady_clock::now();
+  }
+
+  void TriggerTimingService::preProcessEvent(art::Event const&, art::ScheduleContext sc) {
+    _eventOfSchedule[sc.id().id()] = _nEvents++;
+  }
+
+  void TriggerTimingService::postProcessEvent(art::Event const&, art::ScheduleContext) {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(_clockMutex);
+    if (now > _lastEvent) _lastEvent = now;
+  }
+
+  TriggerTimingService::ThreadBuffer& TriggerTimingService::threadBuffer() {
+    if (threadSlot.owner != this) {
+      std::lock_guard<std::mutex> lock(_bufferMutex);
+      _buffers.emplace_back(new ThreadBuffer(_bufferSize));
+      threadSlot.owner  = this;
+      threadSlot.buffer = _buffers.back().get();
+    }
+    return *static_cast<ThreadBuffer*>(threadSlot.buffer);
+  }
+
+  void TriggerTimingService::preModule(art::ModuleContext const&) {
+    // A module waiting for its own tasks may run another module on this
+    // thread, hence a stack.
+    threadBuffer().starts.push_back(Start{std::chrono::steady_clock::now(), threadCPUTime()});
+  }
+
+  void TriggerTimingService::postModule(art::ModuleContext const& mc) {
+    double cpu  = threadCPUTime();
+    auto   wall = std::chrono::steady_clock::now();
+
+    ThreadBuffer& buf = threadBuffer();
+    if (buf.starts.empty()) return;
+    Start start = buf.starts.back();
+    buf.starts.pop_back();
+
+    auto imod = _moduleIds.find(mc.moduleLabel());
+    if (imod == _moduleIds.end()) return;
+    auto ipath = _pathIds.find(mc.pathName());
+
+    Sample& s = buf.samples[buf.next];
+    s.event  = _eventOfSchedule[mc.scheduleID().id()];
+    s.path   = ipath == _pathIds.end() ? _pathNames.size()-1 : ipath->second;
+    s.module = imod->second;
+    s.wall   = std::chrono::duration<float, std::milli>(wall - start.wall).count();
+    s.cpu    = cpu - start.cpu;
+    if (++buf.next == buf.samples.size()) {
+      buf.next    = 0;
+      buf.wrapped = true;
+    }
+  }
+
+  std::vector<TriggerTimingService::Sample> TriggerTimingService::samples() const {
+    std::vector<Sample> all;
+    for (auto const& buf : _buffers) {
+      size_t n = buf->wrapped ? buf->samples.size() : buf->next;
+      all.insert(all.end(), buf->samples.begin(), buf->samples.begin()+n);
+    }
+    return all;
+  }
+
+  std::vector<TriggerTimingService::Summary> TriggerTimingService::moduleSummaries() const {
+    std::vector<std::vector<float>> wall(_moduleNames.size()), cpu(_moduleNames.size());
+    for (auto const& s : samples()) {
+      wall[s.module].push_back(s.wall);
+      cpu [s.module].push_back(s.cpu);
+    }
+
+    std::vector<Summary> res(_moduleNames.size());
+    for (size_t i=0; i<res.size(); ++i) {
+      res[i].name = _moduleNames[i];
+      summarize(wall[i], cpu[i], res[i]);
+    }
+    return res;
+  }
+
+  std::vector<TriggerTimingService::Summary> TriggerTimingService::pathSummaries() const {
+    auto all = samples();
+    std::sort(all.begin(), all.end(), [](Sample const& a, Sample const& b) {
+        return a.path < b.path || (a.path == b.path && a.event < b.event); });
+
+    // sum the modules of each path in each event
+    std::vector<std::vector<float>> wall(_pathNames.size()), cpu(_pathNames.size());
+    for (size_t i=0; i<all.size(); ) {
+      float w(0), c(0);
+      size_t j = i;
+      for ( ; j<all.size() && all[j].path == all[i].path && all[j].event == all[i].event; ++j) {
+        w += all[j].wall;
+        c += all[j].cpu;
+      }
+      wall[all[i].path].push_back(w);
+      cpu [all[i].path].push_back(c);
+      i = j;
+    }
+
+    std::vector<Summary> res(_pathNames.size());
+    for (size_t i=0; i<res.size(); ++i) {
+      res[i].name = _pathNames[i];
+      summarize(wall[i], cpu[i], res[i]);
+    }
+    return res;
+  }
+
+  TriggerTimingService::Summary TriggerTimingService::eventSummary() const {
+    auto all = samples();
+    std::sort(all.begin(), all.end(), [](Sample const& a, Sample const& b) { return a.event < b.event; });
+
+    std::vector<float> wall, cpu;
+    for (size_t i=0; i<all.size(); ) {
+      float w(0), c(0);
+      size_t j = i;
+      for ( ; j<all.size() && all[j].event == all[i].event; ++j) {
+        w += all[j].wall;
+        c += all[j].cpu;
+      }
+      wall.push_back(w);
+      cpu.push_back(c);
+      i = j;
+    }
+
+    Summary res;
+    res.name = "event";
+    summarize(wall, cpu, res);
+    return res;
+  }
+
+  double TriggerTimingService::throughputPerCore() const {
+    Summary s = eventSummary();
+    return s.cpuMean > 0 ? 1.0e3/s.cpuMean : 0.0;
+  }
+
+  double TriggerTimingService::jobThroughput() const {
+    double dt = std::chrono::duration<double>(_lastEvent - _startTime).count();
+    return dt > 0 ? _nEvents/dt : 0.0;
+  }
+
+  void TriggerTimingService::print(std::ostream& os) const {
+    auto line = [&os](Summary const& s) {
+      os << std::setw(32) << std::left << s.name << std::right
+         << std::setw(9) << s.nEvents
+         << std::fixed << std::setprecision(3)
+         << std::setw(10) << s.wallMean << std::setw(10) << s.wallP50
+         << std::setw(10) << s.wallP90  << std::setw(10) << s.wallP99
+         << std::setw(10) << s.wallMax  << std::setw(10) << s.cpuMean
+         << std::setw(10) << s.cpuP99   << "\n";
+    };
+    auto header = [&os](const char* what) {
+      os << std::setw(32) << std::left << what << std::right
+         << std::setw(9)  << "events"
+         << std::setw(10) << "mean" << std::setw(10) << "p50"
+         << std::setw(10) << "p90"  << std::setw(10) << "p99"
+         << std::setw(10) << "max"  << std::setw(10) << "cpu mean"
+         << std::setw(10) << "cpu p99" << "\n";
+    };
+
+    os << "\nTriggerTimingService: latency in ms\n";
+    header("Path");
+    for (auto const& s : pathSummaries()) line(s);
+    header("Module");
+    for (auto const& s : moduleSummaries()) line(s);
+    line(eventSummary());
+    os << "TriggerTimingService: " << _nEvents << " events, "
+       << std::setprecision(1) << jobThroughput() << " events/s for the job, "
+       << throughputPerCore() << " events/s per core\n" << std::endl;
+    os.unsetf(std::ios::fixed);
+  }
+
+  void TriggerTimingService::postEndJob() {
+    if (_verbosity > 0) print(std::cout);
+  }
+
+}
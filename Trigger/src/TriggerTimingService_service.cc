@@ -0,0 +1,6 @@
+//
+// The implementation is in the main library, see TriggerTimingService.cc.
+//
+#include "Trigger/inc/TriggerTimingService.hh"
+
+DEFINE_ART_SERVICE(mu2e::TriggerTimingService);
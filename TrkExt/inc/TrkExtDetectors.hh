@@ -39,6 +39,10 @@ namespace mu2e {
     void initialize () ;
     bool contains (CLHEP::Hep3Vector& p) ;
     TrkExtDetectorList::Enum volumeId(CLHEP::Hep3Vector &xx) ;
+    // Path length a track starting at xx can go without changing volume:
+    // the distance to the bounding boxes of the proton absorber and the
+    // stopping target, or to the boundary of the DS.
+    double safety (const CLHEP::Hep3Vector &xx) ;
     double limit() { return _limit; }
     double mostProbableEnergyLoss (const CLHEP::Hep3Vector& p, double ds, TrkExtDetectorList::Enum volid = TrkExtDetectorList::Undefined) ;
     double meanEnergyLoss (const CLHEP::Hep3Vector& p, double ds, TrkExtDetectorList::Enum volid = TrkExtDetectorList::Undefined) ;
@@ -27,11 +27,13 @@ namespace mu2e {
 
     void initialize () ;
     bool contains (CLHEP::Hep3Vector& p) ;
+    double safety (const CLHEP::Hep3Vector& p) ;
 
   private:
     double z0, z1;
     double r0in, r0out, r1in, r1out;
     double slope_in, slope_out;
+    double rmin, rmax;   // bounding box in r
     bool valid;
     std::string name;
 
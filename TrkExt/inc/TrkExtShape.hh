@@ -23,6 +23,9 @@ namespace mu2e {
 
     virtual bool contains (CLHEP::Hep3Vector& p)  =0 ;
     virtual void initialize (void)  =0 ;
+    // Distance within which a track starting at p can not cross the boundary
+    // of the shape, from its bounding r-z box.  0 means unknown.
+    virtual double safety (const CLHEP::Hep3Vector&) { return 0; }
     CLHEP::Hep3Vector  intersection (const CLHEP::Hep3Vector & x1, const CLHEP::Hep3Vector & x2) ; 
 
   protected:
@@ -42,9 +42,10 @@ namespace mu2e {
 
     void initialize () ;
     bool contains (CLHEP::Hep3Vector& p) ;
+    double safety (const CLHEP::Hep3Vector& p) ;
 
   private:
-    std::vector<foil_data_type> foil;
+    std::vector<foil_data_type> foil;  // ordered in z
     int nfoil;
     std::string name;
     double rmax, zmin, zmax;
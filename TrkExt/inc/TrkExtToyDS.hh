@@ -29,6 +29,7 @@ namespace mu2e {
 
     void initialize () ;
     bool contains (CLHEP::Hep3Vector& p) ;
+    double safety (const CLHEP::Hep3Vector& p) ;
 
   private:
     std::string name;
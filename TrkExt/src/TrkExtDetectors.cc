@@ -8,6 +8,7 @@
 //
 
 // C++ includes.
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -48,6 +49,10 @@ namespace mu2e {
   }
 
 
+  double TrkExtDetectors::safety (const Hep3Vector & xx) {
+    return std::min(std::min(_pa.safety(xx), _st.safety(xx)), _ds.safety(xx));
+  }
+
     
   Hep3Vector  TrkExtDetectors::intersection (const Hep3Vector & x1, const Hep3Vector & x2) {
     TrkExtDetectorList::Enum f1, f2;
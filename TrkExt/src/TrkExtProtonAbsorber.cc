@@ -8,6 +8,7 @@
 //
 
 // C++ includes.
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -76,6 +77,8 @@ namespace mu2e {
     z1 -= origin.z();
     slope_out = (r1out - r0out) / (z1 - z0);
     slope_in  = (r1in - r0in) / (z1 - z0);
+    rmin = std::min(r0in, r1in);
+    rmax = std::max(r0out, r1out);
 
     cout << "TrkExtProtonAbsorber read : " << endl;
     cout << "  rOut = [" << r0out << ", " << r1out << "]" << endl;
@@ -97,6 +100,15 @@ namespace mu2e {
     return true;
   }
 
+  double TrkExtProtonAbsorber::safety (const Hep3Vector &xx) {
+    // distance to the bounding box, 0 inside
+    if (!valid) return 1e10;
+    double r = safeSqrt(xx.x() * xx.x() + xx.y() * xx.y());
+    double dz = std::max(std::max(z0 - xx.z(), xx.z() - z1), 0.);
+    double dr = std::max(std::max(rmin - r, r - rmax), 0.);
+    return safeSqrt(dz*dz + dr*dr);
+  }
+
 
 
 
@@ -8,6 +8,7 @@
 //
 
 // C++ includes.
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -56,6 +57,8 @@ namespace mu2e {
       foil.push_back(ftmp);
     }
 
+    // foils do not overlap; ordering them in z lets contains() look at one foil only
+    std::sort(foil.begin(), foil.end(), [](const foil_data_type& a, const foil_data_type& b) { return a.z0 < b.z0; });
     nfoil = foil.size();
 
     rmax = -999;
@@ -76,10 +79,20 @@ namespace mu2e {
     double r = safeSqrt(xx.x() * xx.x() + xx.y() * xx.y());
     double z = xx.z();
     if (z<zmin || z>zmax || r>rmax) return false;
-    for (int i = 0 ; i <nfoil ; ++i) {
-      if (foil[i].z0 < z && z <foil[i].z1 && r <foil[i].rout) return true;
-    }
-    return false;
+    // the last foil starting before z
+    auto it = std::lower_bound(foil.begin(), foil.end(), z, [](const foil_data_type& f, double zz) { return f.z0 < zz; });
+    if (it == foil.begin()) return false;
+    --it;
+    return z < it->z1 && r < it->rout;
+  }
+
+  double TrkExtStoppingTarget::safety (const Hep3Vector &xx) {
+    // distance to the bounding box, 0 inside
+    if (nfoil<=0) return 1e10;
+    double r = safeSqrt(xx.x() * xx.x() + xx.y() * xx.y());
+    double dz = std::max(std::max(zmin - xx.z(), xx.z() - zmax), 0.);
+    double dr = std::max(r - rmax, 0.);
+    return safeSqrt(dz*dz + dr*dr);
   }
 
 
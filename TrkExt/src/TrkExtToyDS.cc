@@ -8,6 +8,7 @@
 //
 
 // C++ includes.
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -66,6 +67,12 @@ namespace mu2e {
     return true;
   }
 
+  double TrkExtToyDS::safety (const Hep3Vector &xx) {
+    // distance to the boundary from inside, 0 outside
+    double r = safeSqrt(xx.x() * xx.x() + xx.y() * xx.y());
+    return std::max(std::min(std::min(rin - r, xx.z() - zmin), zmax - xx.z()), 0.);
+  }
+
 
 
 
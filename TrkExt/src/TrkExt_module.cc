@@ -14,6 +14,8 @@
 //
 
 // C++ includes.
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -114,6 +116,9 @@ namespace mu2e {
     int _maxNBack;
     double _extrapolationStep; //in mm
     double _recordingStep;
+    bool _adaptiveStep;
+    double _maxExtrapolationStep; //in mm
+    double _rkTolerance; //in mm
     bool _mcFlag;
     bool _useVirtualDetector;
     int _bFieldGradientMode;
@@ -149,6 +154,7 @@ namespace mu2e {
     Hep3Vector _mu2eOriginInWorld;
 
     BFieldManager const * _bfMgr;
+    BFCacheManager _bfCache;  // own map lookup cache, follows the track
     TrkExtDetectors _mydet;
     TrkExtInstanceName _trkPatRecInstanceName;
 
@@ -165,10 +171,11 @@ namespace mu2e {
     bool readVD (const art::Event& event, TrkHitVector const& hits) ;
     int doExtrapolation (Hep3Vector x, Hep3Vector p, double t, HepMatrix cov, bool direction, TrkExtInstanceNameEntry & instance) ;
 
-    HepVector _runge_kutta_newpar_5th (HepVector r0, double ds, bool mode, int charge) ;
+    HepVector _runge_kutta_newpar_5th (HepVector r0, double ds, Hep3Vector B0, int charge, HepVector & err) ;
     HepVector _runge_kutta_newpar_f (HepVector r, Hep3Vector B, int charge) ;
 
     TrkExtTrajPoint calculateNextPosition(TrkExtTrajPoint r00, double ds, double mass2, int charge);
+    TrkExtTrajPoint calculateNextPositionAdaptive(TrkExtTrajPoint r00, double ds, double safety, double mass2, int charge, double & nextStep);
 
     Hep3Vector getBField (Hep3Vector& x) ; // in Detector coordinate
     Hep3Vector getBField (const Hep3Vector& x) ; // in Detector coordinate
@@ -198,6 +205,9 @@ namespace mu2e {
     _maxNBack(pset.get<int>("maxNBack", 5000)),
     _extrapolationStep(pset.get<double>("extrapolationStep", 5.0)),    // in mm
     _recordingStep(pset.get<double>("recordingStep", 10.0)),    // in mm
+    _adaptiveStep(pset.get<bool>("adaptiveStep", true)),
+    _maxExtrapolationStep(pset.get<double>("maxExtrapolationStep", 10.0)),    // in mm
+    _rkTolerance(pset.get<double>("rkTolerance", 0.001)),    // in mm
     _mcFlag(pset.get<bool>("mcFlag", false)),
     _useVirtualDetector(pset.get<bool>("useVirtualDetector", false)),
     _bFieldGradientMode(pset.get<int>("bFieldGradientMode", 1)),
@@ -269,6 +279,11 @@ namespace mu2e {
     if (_extrapolationStep == 0) _extrapolationStep = 5.;
     else if (_extrapolationStep <0) _extrapolationStep = fabs(_extrapolationStep);
     if (_recordingStep <0) _recordingStep = 0.0;
+    if (_maxExtrapolationStep < fabs(_extrapolationStep)) _maxExtrapolationStep = fabs(_extrapolationStep);
+    if (_rkTolerance <= 0) {
+      throw cet::exception("CONFIGURATION")
+        << "TrkExt error : rkTolerance must be positive, got " << _rkTolerance << endl;
+    }
     if (!_mcFlag) {
       if (_useVirtualDetector) {
         if (_verbosity>=0) cout << "TrkExt: VirtualDetector turned off for data" << endl;
@@ -284,6 +299,7 @@ namespace mu2e {
 
     if (_verbosity>=1) cout << "TrkExt: extrapolationStep = " << _extrapolationStep << endl;
     if (_verbosity>=1) cout << "TrkExt: recordingStep = " << _recordingStep << endl;
+    if (_verbosity>=1 && _adaptiveStep) cout << "TrkExt: adaptive step up to " << _maxExtrapolationStep << " mm, rkTolerance = " << _rkTolerance << endl;
 
     // histograms
 
@@ -366,6 +382,7 @@ namespace mu2e {
   void TrkExt::beginSubRun(art::SubRun & lblock ) {
     if (_verbosity>=2) cout << "TrkExt: From beginSubRun. " << endl;
     _bfMgr = GeomHandle<BFieldManager>().get();
+    _bfCache = _bfMgr->cacheManager();
     _mydet.initialize();
   }
 
@@ -486,19 +503,13 @@ namespace mu2e {
 ////////// BField functions ///////////
 
   Hep3Vector TrkExt::getBField (Hep3Vector& x) {
-    // x in Detector coordinate
-    //mu2e::GeomHandle<BFieldManager> bfMgr;
-    Hep3Vector b = _bfMgr->getBField(x + _origin);
-    if (b.mag() >10) {
-      Hep3Vector xx = x+_origin;
-      if (_verbosity>=0) cout << "TrkExt: Crazy bfield : (" << b.x() << ", " << b.y() << ", " << b.z() << ") at (" << xx.x() << ", " << xx.y() << ", " << xx.z() << ")" << endl;
-    }
-    return b;
+    return getBField(static_cast<const Hep3Vector&>(x));
   }
   
   Hep3Vector TrkExt::getBField (const Hep3Vector& x) { 
+    // x in Detector coordinate
     Hep3Vector xx = x + _origin;
-    Hep3Vector b = _bfMgr->getBField(xx);
+    Hep3Vector b = _bfMgr->getBField(xx, _bfCache);
     if (b.mag() >10) {
       if (_verbosity>=0) cout << "TrkExt: Crazy bfield : (" << b.x() << ", " << b.y() << ", " << b.z() << ") at (" << xx.x() << ", " << xx.y() << ", " << xx.z() << ")" << endl;
     }
@@ -799,6 +810,7 @@ namespace mu2e {
     double extrapolationStep = stepSign * fabs(_extrapolationStep);
 
     double ds = extrapolationStep;
+    double nextStep = fabs(extrapolationStep);  // proposed by the adaptive step control
 
     double s = 0;
     double dds = 0;
@@ -820,11 +832,22 @@ namespace mu2e {
     int nsteps;
     for (nsteps = 0 ; ; ++nsteps) {
 
-      // initial step size
-      ds = extrapolationStep;
+      if (_adaptiveStep) {
+        // long steps only where no volume boundary is within reach; near and
+        // inside the proton absorber and the stopping target the steps are
+        // not longer than extrapolationStep, as for the fixed step
+        double safety = _mydet.safety(r0.position());
+        double maxStep = std::min(std::max(safety, fabs(extrapolationStep)), _maxExtrapolationStep);
+        r1 = calculateNextPositionAdaptive(r0, stepSign*std::min(nextStep, maxStep), safety, mass2, charge, nextStep);
+        ds = r1.flightLength() - r0.flightLength();
+      }
+      else {
+        // initial step size
+        ds = extrapolationStep;
 
-      // Estimate next position
-      r1 = calculateNextPosition(r0, ds, mass2, charge); 
+        // Estimate next position
+        r1 = calculateNextPosition(r0, ds, mass2, charge); 
+      }
 
       // check the volume info
       if (r1.volumeId() != TrkExtDetectorList::Undefined) {
@@ -1129,9 +1152,52 @@ namespace mu2e {
     return TrkExtTrajPoint(r00.trajPointId()+1, re, volid, r00.flightLength()+ds, r00.flightTime()+ft);
   }
 
+  // Cash-Karp step with error control.  The step ds is shrunk until the
+  // error estimate is below rkTolerance, but not below extrapolationStep;
+  // nextStep is the step size proposed for the next point.  If the step is
+  // shorter than safety, the volume can not have changed and is not tested.
+  TrkExtTrajPoint TrkExt::calculateNextPositionAdaptive (TrkExtTrajPoint r00, double ds, double safety, double mass2, int charge, double & nextStep) {
+    HepVector r0(6), re(6), err(6);
+    r0 = r00.vector();
+    Hep3Vector B0 = getBField(r0);   // shared by the retries
+    double p = r00.momentum().mag();
+    double minStep = fabs(_extrapolationStep);
+
+    for (;;) {
+      re = _runge_kutta_newpar_5th(r0, ds, B0, charge, err);
+      // position error and direction error times the step, in mm
+      double dx = sqrt(err[0]*err[0] + err[1]*err[1] + err[2]*err[2]);
+      double dp = sqrt(err[3]*err[3] + err[4]*err[4] + err[5]*err[5]) / p * fabs(ds);
+      double e = std::max(dx, dp) / _rkTolerance;
+      if (e <= 1.) {
+        nextStep = std::max(fabs(ds) * (e > 1.e-4 ? std::min(0.9*pow(e, -0.2), 5.) : 5.), minStep);
+        break;
+      }
+      if (fabs(ds) <= minStep) {
+        nextStep = minStep;
+        break;
+      }
+      ds *= std::max(0.9*pow(e, -0.25), 0.1);
+      if (fabs(ds) < minStep) ds = copysign(minStep, ds);
+    }
+
+    int volid = r00.volumeId();
+    if (fabs(ds) >= safety) {
+      Hep3Vector x(re[0], re[1], re[2]);
+      volid = _mydet.volumeId(x);
+    }
+
+    double v = p/safeSqrt(p*p+mass2)*VELOCITY_OF_LIGHT; 
+    double ft = ds / v * 1.e6; 
+
+    return TrkExtTrajPoint(r00.trajPointId()+1, re, volid, r00.flightLength()+ds, r00.flightTime()+ft);
+  }
+
 
 
-  HepVector TrkExt::_runge_kutta_newpar_5th (HepVector r0, double ds, bool mode, int charge) {
+  // Cash-Karp Runge-Kutta: the 5th order result, and in err its difference
+  // to the embedded 4th order one.  B0 is the field at r0.
+  HepVector TrkExt::_runge_kutta_newpar_5th (HepVector r0, double ds, Hep3Vector B0, int charge, HepVector & err) {
 
 //    static double a2 = 0.2;
 //    static double a3 = 0.3;
@@ -1166,18 +1232,15 @@ namespace mu2e {
     static double c5s = 277./14336.;
     static double c6s = 0.25;
 
-    HepVector k1 = ds*_runge_kutta_newpar_f(r0, getBField(r0), charge); HepVector r1 = r0 + b21*k1;
+    HepVector k1 = ds*_runge_kutta_newpar_f(r0, B0, charge);            HepVector r1 = r0 + b21*k1;
     HepVector k2 = ds*_runge_kutta_newpar_f(r1, getBField(r1), charge); HepVector r2 = r0 + b31*k1 + b32*k2;
     HepVector k3 = ds*_runge_kutta_newpar_f(r2, getBField(r2), charge); HepVector r3 = r0 + b41*k1 + b42*k2 + b43*k3;
     HepVector k4 = ds*_runge_kutta_newpar_f(r3, getBField(r3), charge); HepVector r4 = r0 + b51*k1 + b52*k2 + b53*k3 + b54*k4;
     HepVector k5 = ds*_runge_kutta_newpar_f(r4, getBField(r4), charge); HepVector r5 = r0 + b61*k1 + b62*k2 + b63*k3 + b64*k4 + b65*k5;
     HepVector k6 = ds*_runge_kutta_newpar_f(r5, getBField(r5), charge); 
 
-    if (mode) {
-      return r0 + c1*k1 + c2*k2 + c3*k3 + c4*k4 + c5*k5 + c6*k6;
-    }else {
-      return r0 + c1s*k1 + c2s*k2 + c3s*k3 + c4s*k4 + c5s*k5 + c6s*k6;
-    }
+    err = (c1-c1s)*k1 + (c2-c2s)*k2 + (c3-c3s)*k3 + (c4-c4s)*k4 + (c5-c5s)*k5 + (c6-c6s)*k6;
+    return r0 + c1*k1 + c2*k2 + c3*k3 + c4*k4 + c5*k5 + c6*k6;
   }
 
 
@@ -0,0 +1,44 @@
+#ifndef TrkHitReco_CaloTimeROI_hh
+#define TrkHitReco_CaloTimeROI_hh
+//
+// Time regions of interest around calorimeter clusters, used to restrict the
+// tracker hit reconstruction of the calorimeter-seeded triggers.  The cluster
+// times are sorted once per event; a time is inside a region if it is within
+// dt of any cluster time, which is a binary search.
+//
+#include "RecoDataProducts/inc/CaloClusterCollection.hh"
+#include <algorithm>
+#include <vector>
+
+namespace mu2e {
+
+  namespace TrkHitReco {
+
+    class CaloTimeROI {
+      public:
+	explicit CaloTimeROI(float dt=100.0) : _dt(dt) {}
+
+	void fill(CaloClusterCollection const& clusters) {
+	  _times.clear();
+	  _times.reserve(clusters.size());
+	  for(auto const& cluster : clusters) _times.push_back(cluster.time());
+	  std::sort(_times.begin(),_times.end());
+	}
+
+	// true if |time - cluster time| < dt for some cluster
+	bool contains(float time) const {
+	  auto it = std::upper_bound(_times.begin(),_times.end(),time-_dt);
+	  return it != _times.end() && *it < time+_dt;
+	}
+
+	bool empty() const { return _times.empty(); }
+	float dt() const { return _dt; }
+
+      private:
+	float _dt;
+	std::vector<float> _times;
+    };
+
+  }
+}
+#endif
@@ -19,7 +19,9 @@
 
 #include "TrkReco/inc/TLTClusterer.hh"
 #include "TrkReco/inc/TNTClusterer.hh"
+#include "TrkReco/inc/TNTGridClusterer.hh"
 #include "Mu2eUtilities/inc/MVATools.hh"
+#include "TrkHitReco/inc/CaloTimeROI.hh"
 
 #include "CLHEP/Units/PhysicalConstants.h"
 #include "TMath.h"
@@ -59,7 +61,7 @@ namespace mu2e
   class FlagBkgHits : public art::EDProducer
   {
   public:
-    enum clusterer { TwoLevelThreshold=1, TwoNiveauThreshold=2};
+    enum clusterer { TwoLevelThreshold=1, TwoNiveauThreshold=2, TwoNiveauGrid=3};
     explicit FlagBkgHits(fhicl::ParameterSet const&);
     void beginJob() override;
     void produce(art::Event& event) override;
@@ -83,6 +85,9 @@ namespace mu2e
     bool         _useMVA;
     float        _bkgMVAcut;
     MVATools     _bkgMVA;
+    bool         _usecc;      // only cluster hits inside the calorimeter cluster time windows
+    art::InputTag _ccTag;
+    TrkHitReco::CaloTimeROI _caloROI;
 
 
     void classifyClusters(BkgClusterCollection& clusters,BkgQualCollection& cquals) const;
@@ -109,10 +114,14 @@ namespace mu2e
     _stereo(pset.get<std::vector<std::string> >("StereoSelection",std::vector<std::string>{"Stereo","PanelCombo"})),
     _useMVA(pset.get<bool>(                     "UseBkgMVA",true)),
     _bkgMVAcut(pset.get<float>(                 "BkgMVACut",0.5)),
-    _bkgMVA(pset.get<fhicl::ParameterSet>(      "BkgMVA", {}))
+    _bkgMVA(pset.get<fhicl::ParameterSet>(      "BkgMVA", {})),
+    _usecc(pset.get<bool>(                      "UseCalorimeter",false)),
+    _ccTag(pset.get<art::InputTag>(             "caloClusterModuleLabel","CaloClusterFast")),
+    _caloROI(pset.get<float>(                   "clusterDt",100))
   {
     // Must call consumesMany because fillStrawHitIndices calls getManyByType.
     consumesMany<ComboHitCollection>();
+    if (_usecc) consumes<CaloClusterCollection>(_ccTag);
 
     if (_flagch) produces<StrawHitFlagCollection>("ComboHits");
     if (_flagsh) produces<StrawHitFlagCollection>("StrawHits");
@@ -132,6 +141,9 @@ namespace mu2e
       case TwoNiveauThreshold:
         _clusterer = new TNTClusterer(pset.get<fhicl::ParameterSet>("TNTClusterer", {}));
         break;
+      case TwoNiveauGrid:
+        _clusterer = new TNTGridClusterer(pset.get<fhicl::ParameterSet>("TNTGridClusterer", {}));
+        break;
       default:
         throw cet::exception("RECO")<< "Unknown clusterer" << ctype << std::endl;
       }
@@ -164,8 +176,26 @@ namespace mu2e
     if (_savebkg) bkgqcol.reserve(bkgccol.size());
     StrawHitFlagCollection chfcol(nch);
 
-    // find clusters
-    _clusterer->findClusters(bkgccol,*_chcol);
+    // find clusters.  With the calorimeter ROI only the hits inside the cluster time
+    // windows are clustered; the hit references are then mapped back to the input
+    if (_usecc) {
+      _caloROI.fill(*event.getValidHandle<CaloClusterCollection>(_ccTag));
+      ComboHitCollection roicol;
+      std::vector<uint16_t> roiindex;
+      roicol.reserve(nch);
+      roiindex.reserve(nch);
+      for (uint16_t ich=0;ich < nch; ++ich){
+        if (_caloROI.contains((*_chcol)[ich].time())){
+          roicol.push_back((*_chcol)[ich]);
+          roiindex.push_back(ich);
+        }
+      }
+      _clusterer->findClusters(bkgccol,roicol);
+      for (auto& cluster : bkgccol)
+        for (auto& chit : cluster._hits) chit._index = roiindex[chit._index];
+    } else {
+      _clusterer->findClusters(bkgccol,*_chcol);
+    }
 
     // evaluate results and put in the data products
     for (auto& cluster : bkgccol) {
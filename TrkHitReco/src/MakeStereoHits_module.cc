@@ -25,6 +25,7 @@
 #include "RecoDataProducts/inc/ComboHit.hh"
 #include "RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Mu2eUtilities/inc/MVATools.hh"
+#include "TrkHitReco/inc/CaloTimeROI.hh"
 // boost
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
@@ -35,7 +36,9 @@
 using namespace boost::accumulators;
 
 #include <iostream>
+#include <algorithm>
 #include <float.h>
+#include "tbb/task_group.h"
 using namespace std;
 
 namespace {
@@ -50,6 +53,18 @@ namespace {
     float& _rho;  
     float& _ndof; 
   };
+
+  // hits of one panel sorted in time, stored as parallel arrays so that the time window is found
+  // with a binary search and the pairing preselection runs over contiguous memory
+  struct PanelHits
+  {
+    void clear() { _index.clear(); _time.clear(); _px.clear(); _py.clear(); _wx.clear(); _wy.clear(); _wz.clear(); }
+
+    std::vector<uint16_t> _index;
+    std::vector<float>    _time;
+    std::vector<float>    _px, _py;
+    std::vector<float>    _wx, _wy, _wz;
+  };
 }
 
 namespace mu2e {
@@ -82,14 +97,25 @@ namespace mu2e {
       bool           _doMVA;      // do MVA eval or simply use chi2 cut
       unsigned      _maxfsep;	  // max face separation
       bool	    _testflag; // test the flag or not
+      bool          _sortedPairing; // use the time-sorted panel arrays to pair hits
+      bool          _parallelStations; // pair the stations concurrently (sorted pairing only)
+      bool          _usecc;      // only pair hits inside the calorimeter cluster time windows
+      art::InputTag _ccTag;
+      TrkHitReco::CaloTimeROI _caloROI;
+      std::vector<uint8_t> _inroi; // per input hit
       StrawIdMask _smask; // define matches inside a station
 
       MVATools _mvatool;
       StereoMVA _vmva; 
 
       std::array<std::vector<StrawId>,StrawId::_nupanels > _panelOverlap;   // which panels overlap each other
+      std::array<PanelHits,StrawId::_nupanels > _panelHits; // time-sorted hits per panel
       void genMap();    
-      void finalize(ComboHit& combohit);
+      void finalize(ComboHit& combohit) const;
+      bool addPair(ComboHit& combohit, ComboHit const& ch1, ComboHit const& ch2, uint16_t jhit) const;
+      void fillPanelHits(std::array<std::vector<uint16_t>,StrawId::_nupanels> const& phits);
+      void pairStation(std::vector<uint16_t> const& shits, std::vector<uint8_t>& used,
+	  std::vector<ComboHit>& combos, std::vector<uint8_t>& primary) const;
   };
 
   MakeStereoHits::MakeStereoHits(fhicl::ParameterSet const& pset) :
@@ -109,6 +135,11 @@ namespace mu2e {
     _doMVA(pset.get<bool>(  "doMVA",false)),
     _maxfsep(pset.get<unsigned>("MaxFaceSeparation",3)), // max separation between faces in a station
     _testflag(pset.get<bool>("TestFlag")),
+    _sortedPairing(pset.get<bool>("SortedPairing",false)),
+    _parallelStations(pset.get<bool>("ParallelStations",false)),
+    _usecc(pset.get<bool>("UseCalorimeter",false)),
+    _ccTag(pset.get<art::InputTag>("caloClusterModuleLabel","CaloClusterFast")),
+    _caloROI(pset.get<float>("clusterDt",100)),
     _mvatool(pset.get<fhicl::ParameterSet>("MVATool",fhicl::ParameterSet()))
     {
       float minR = pset.get<float>("minimumRadius",395); // mm
@@ -119,6 +150,7 @@ namespace mu2e {
       std::vector<StrawIdMask::field> fields;
       fields.push_back(StrawIdMask::station);
       _smask = StrawIdMask(fields);
+      if(_usecc) consumes<CaloClusterCollection>(_ccTag);
       produces<ComboHitCollection>();
     }
 
@@ -152,8 +184,16 @@ namespace mu2e {
     size_t nch = _chcol->size();
     if(_debug > 1)cout << "MakeStereoHits found " << nch << " Input hits" << endl;
     std::vector<bool> used(nch,false);
+    // hits outside the calorimeter time windows are copied without pairing
+    _inroi.assign(nch,1);
+    if(_usecc){
+      _caloROI.fill(*event.getValidHandle<CaloClusterCollection>(_ccTag));
+      for(uint16_t ihit=0;ihit<nch;++ihit)
+	_inroi[ihit] = _caloROI.contains((*_chcol)[ihit].time());
+    }
     for(uint16_t ihit=0;ihit<nch;++ihit){
       ComboHit const& ch = (*_chcol)[ihit];
+      if(!_inroi[ihit])continue;
       // select hits based on flag
       if( (!_testflag) ||( ch.flag().hasAllProperties(_shsel) && (!ch.flag().hasAnyProperty(_shmask))) ){
 	phits[ch.strawId().uniquePanel()].push_back(ihit);
@@ -166,6 +206,29 @@ namespace mu2e {
 	}
       }
     }
+    if(_sortedPairing){
+      // stereo pairs never cross a station, so the stations can be paired independently.
+      // The output keeps the order of the standard pairing: one combo hit per unused hit, in index order
+      fillPanelHits(phits);
+      std::array<std::vector<uint16_t>,StrawId::_nstations> shits;
+      for(uint16_t ihit=0;ihit<nch;++ihit)
+	shits[(*_chcol)[ihit].strawId().station()].push_back(ihit);
+      std::vector<ComboHit> combos(nch);
+      std::vector<uint8_t> sused(nch,0), primary(nch,0);
+      if(_parallelStations){
+	tbb::task_group tg;
+	for(size_t ist=0;ist<StrawId::_nstations;++ist)
+	  tg.run([this,&shits,&sused,&combos,&primary,ist]{ pairStation(shits[ist],sused,combos,primary); });
+	tg.wait();
+      } else {
+	for(size_t ist=0;ist<StrawId::_nstations;++ist)
+	  pairStation(shits[ist],sused,combos,primary);
+      }
+      for(size_t ihit=0;ihit<nch;++ihit)
+	if(primary[ihit]) chcol->push_back(std::move(combos[ihit]));
+      event.put(std::move(chcol));
+      return;
+    }
     //  Loop over all hits.  Every one must appear somewhere in the output 
     for (size_t ihit=0;ihit<nch;++ihit) {
       if(used[ihit])continue;
@@ -177,6 +240,11 @@ namespace mu2e {
       // zero values that accumulate in pairs
       combohit._qual = 0.0;
       combohit._pos = XYZVec(0.0,0.0,0.0);
+      if(!_inroi[ihit]){
+	finalize(combohit);
+	chcol->push_back(std::move(combohit));
+	continue;
+      }
       // loop over the panels which overlap this hit's panel
       for (auto sid : _panelOverlap[ch1.strawId().uniquePanel()]) {
       // loop over hits in the overlapping panel
@@ -197,36 +265,7 @@ namespace mu2e {
 	      // negative crosings are in opposite quadrants and longitudinal separation isn't too big
 	      if(_debug > 3) cout << " ddot = " << ddot << " dperp = " << dperp;
 	      if (ddot > _minDdot && dperp < _maxDPerp ) {
-		// solve for the POCA.
-		TwoLinePCA_XYZ pca(ch1.pos(),ch1.wdir(),ch2.pos(),ch2.wdir());
-		if(pca.closeToParallel()){  
-		  cet::exception("RECO")<<"mu2e::StereoHit: parallel wires" << std::endl;
-		}
-		// check the points are inside the tracker active volume; these are all the same as the
-		float rho2 = pca.point1().Perp2();
-		if(_debug > 3) cout << " rho2 = " << rho2;
-		if(rho2 < _maxR2 && rho2 > _minR2 ){
-		  // compute chisquared; include error for particle angle
-		  // should be a cumulative linear regression FIXME!
-		  float terr = _tfac*fabs(ch1.pos().z()-ch2.pos().z());
-		  float terr2 = terr*terr;
-		  float dw1 = pca.s1();
-		  float dw2 = pca.s2();
-		  float chisq = dw1*dw1/(ch1.wireErr2()+terr2) + dw2*dw2/(ch2.wireErr2()+terr2);
-		  if(_debug > 3) cout << " chisq = " << chisq;
-		  if (chisq < _maxChisq){
-		    if(_debug > 3) cout << " added ";
-		    // if we get to here, try to add the hit
-		    // accumulate the chisquared
-		    if(combohit.addIndex(jhit)) {
-		      // average z 
-		      combohit._qual += chisq;
-		      combohit._pos += XYZVec(pca.point1().x(),pca.point1().y(),0.5*(pca.point1().z()+pca.point2().z()));	    
-		    } else
-		      std::cout << "MakeStereoHits can't add hit" << std::endl;
-		    used[jhit] = true;
-		  }	
-		}
+		if(addPair(combohit,ch1,ch2,jhit)) used[jhit] = true;
 	      }
 	    }
 	  }
@@ -239,7 +278,123 @@ namespace mu2e {
     event.put(std::move(chcol));
   } 
 
-  void MakeStereoHits::finalize(ComboHit& combohit) {
+  // test the wire crossing of 2 hits which pass the time and direction preselection, and add the 2nd hit if it matches
+  bool MakeStereoHits::addPair(ComboHit& combohit, ComboHit const& ch1, ComboHit const& ch2, uint16_t jhit) const {
+    // solve for the POCA.
+    TwoLinePCA_XYZ pca(ch1.pos(),ch1.wdir(),ch2.pos(),ch2.wdir());
+    if(pca.closeToParallel()){  
+      cet::exception("RECO")<<"mu2e::StereoHit: parallel wires" << std::endl;
+    }
+    // check the points are inside the tracker active volume; these are all the same as the
+    float rho2 = pca.point1().Perp2();
+    if(_debug > 3) cout << " rho2 = " << rho2;
+    if(rho2 < _maxR2 && rho2 > _minR2 ){
+      // compute chisquared; include error for particle angle
+      // should be a cumulative linear regression FIXME!
+      float terr = _tfac*fabs(ch1.pos().z()-ch2.pos().z());
+      float terr2 = terr*terr;
+      float dw1 = pca.s1();
+      float dw2 = pca.s2();
+      float chisq = dw1*dw1/(ch1.wireErr2()+terr2) + dw2*dw2/(ch2.wireErr2()+terr2);
+      if(_debug > 3) cout << " chisq = " << chisq;
+      if (chisq < _maxChisq){
+	if(_debug > 3) cout << " added ";
+	// if we get to here, try to add the hit
+	// accumulate the chisquared
+	if(combohit.addIndex(jhit)) {
+	  // average z 
+	  combohit._qual += chisq;
+	  combohit._pos += XYZVec(pca.point1().x(),pca.point1().y(),0.5*(pca.point1().z()+pca.point2().z()));	    
+	} else
+	  std::cout << "MakeStereoHits can't add hit" << std::endl;
+	return true;
+      }	
+    }
+    return false;
+  }
+
+  void MakeStereoHits::fillPanelHits(std::array<std::vector<uint16_t>,StrawId::_nupanels> const& phits) {
+    std::vector<std::pair<float,uint16_t> > tsort;
+    for(size_t ipan=0;ipan < StrawId::_nupanels; ++ipan){
+      PanelHits& ph = _panelHits[ipan];
+      ph.clear();
+      if(phits[ipan].empty())continue;
+      tsort.clear();
+      for(auto ihit : phits[ipan]){
+	ComboHit const& ch = (*_chcol)[ihit];
+	tsort.emplace_back(_useTOT ? ch.correctedTime() : ch.time(),ihit);
+      }
+      std::stable_sort(tsort.begin(),tsort.end(),[](auto const& a, auto const& b){return a.first < b.first;});
+      for(auto const& th : tsort){
+	ComboHit const& ch = (*_chcol)[th.second];
+	ph._index.push_back(th.second);
+	ph._time.push_back(th.first);
+	ph._px.push_back(ch.pos().x());
+	ph._py.push_back(ch.pos().y());
+	ph._wx.push_back(ch.wdir().x());
+	ph._wy.push_back(ch.wdir().y());
+	ph._wz.push_back(ch.wdir().z());
+      }
+    }
+  }
+
+  // same greedy pairing as the standard loop, restricted to the hits of 1 station.  Only the
+  // hits inside the time window of each overlapping panel are tested, the cheap cuts are
+  // evaluated for the whole window at once, and the survivors are added in hit index order
+  void MakeStereoHits::pairStation(std::vector<uint16_t> const& shits, std::vector<uint8_t>& used,
+      std::vector<ComboHit>& combos, std::vector<uint8_t>& primary) const {
+    std::vector<uint8_t> pass;
+    std::vector<uint16_t> cand;
+    for(auto ihit : shits){
+      if(used[ihit])continue;
+      used[ihit] = 1;
+      primary[ihit] = 1;
+      ComboHit const& ch1 = (*_chcol)[ihit];
+      ComboHit& combohit = combos[ihit];
+      combohit.init(ch1,ihit);
+      // zero values that accumulate in pairs
+      combohit._qual = 0.0;
+      combohit._pos = XYZVec(0.0,0.0,0.0);
+      float t1 = _useTOT ? ch1.correctedTime() : ch1.time();
+      float p1x = ch1.pos().x(), p1y = ch1.pos().y();
+      float w1x = ch1.wdir().x(), w1y = ch1.wdir().y(), w1z = ch1.wdir().z();
+      if(!_inroi[ihit]){
+	finalize(combohit);
+	continue;
+      }
+      for (auto sid : _panelOverlap[ch1.strawId().uniquePanel()]) {
+	PanelHits const& ph = _panelHits[sid.uniquePanel()];
+	size_t jbeg = std::lower_bound(ph._time.begin(),ph._time.end(),t1-_maxDt) - ph._time.begin();
+	size_t jend = std::upper_bound(ph._time.begin()+jbeg,ph._time.end(),t1+_maxDt) - ph._time.begin();
+	if(jbeg >= jend)continue;
+	size_t nj = jend-jbeg;
+	pass.resize(nj);
+	const float* tj  = ph._time.data()+jbeg;
+	const float* pxj = ph._px.data()+jbeg;
+	const float* pyj = ph._py.data()+jbeg;
+	const float* wxj = ph._wx.data()+jbeg;
+	const float* wyj = ph._wy.data()+jbeg;
+	const float* wzj = ph._wz.data()+jbeg;
+	for(size_t k=0;k<nj;++k){
+	  float dt = fabs(t1-tj[k]);
+	  float ddot = w1x*wxj[k] + w1y*wyj[k] + w1z*wzj[k];
+	  float dx = p1x-pxj[k];
+	  float dy = p1y-pyj[k];
+	  float dperp = sqrt(dx*dx+dy*dy);
+	  pass[k] = (dt < _maxDt) & (ddot > _minDdot) & (dperp < _maxDPerp);
+	}
+	cand.clear();
+	for(size_t k=0;k<nj;++k)
+	  if(pass[k] && !used[ph._index[jbeg+k]]) cand.push_back(ph._index[jbeg+k]);
+	std::sort(cand.begin(),cand.end());
+	for(auto jhit : cand)
+	  if(addPair(combohit,ch1,(*_chcol)[jhit],jhit)) used[jhit] = 1;
+      }
+      finalize(combohit);
+    }
+  }
+
+  void MakeStereoHits::finalize(ComboHit& combohit) const {
     combohit._mask = _smask;
     if(combohit.nCombo() > 1){
       combohit._flag.merge(StrawHitFlag::stereo);
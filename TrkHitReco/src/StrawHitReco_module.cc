@@ -29,6 +29,7 @@
 #include "TrkHitReco/inc/PeakFitRoot.hh"
 #include "TrkHitReco/inc/PeakFitFunction.hh"
 #include "TrkHitReco/inc/ComboPeakFitRoot.hh"
+#include "TrkHitReco/inc/CaloTimeROI.hh"
 
 #include "DataProducts/inc/EventWindowMarker.hh"
 #include "DataProducts/inc/StrawEnd.hh"
@@ -59,6 +60,7 @@ namespace mu2e {
        TrkHitReco::FitType _fittype; // peak Fitter
        bool   _usecc;                   // use calorimeter cluster filtering
        float _clusterDt;               // maximum hit-calo lcuster time difference
+       TrkHitReco::CaloTimeROI _caloROI; // time-sorted calo clusters
        float _minE;             // energy range (MeV)
        float _maxE;             // energy range (MeV)
        float _ctE;                     // minimum charge to flag neighbors as cross talk
@@ -99,6 +101,7 @@ namespace mu2e {
       _fittype((TrkHitReco::FitType) pset.get<unsigned>("FitType",TrkHitReco::FitType::peakminuspedavg)),
       _usecc(pset.get<bool>(         "UseCalorimeter",false)),
       _clusterDt(pset.get<float>(   "clusterDt",100)),
+      _caloROI(_clusterDt),
       _minE(pset.get<float>(        "minimumEnergy",0.0)), // MeV
       _maxE(pset.get<float>(        "maximumEnergy",0.0035)), // MeV
       _ctE(pset.get<float>(         "crossTalkEnergy",0.007)), // MeV
@@ -169,10 +172,9 @@ namespace mu2e {
       auto sdH = event.getValidHandle(_sdtoken);
       const StrawDigiCollection& sdcol(*sdH);
 
-      const CaloClusterCollection* caloClusters(0);
       if(_usecc){
         auto ccH = event.getValidHandle(_cctoken);
-        caloClusters = ccH.product();
+        _caloROI.fill(*ccH);
       }
 
       double ewmOffset = 0;
@@ -219,12 +221,10 @@ namespace mu2e {
 	} else
 	  flag.merge(StrawHitFlag::timesel);
 
-	//calorimeter filtering
-	if (_usecc && caloClusters) {
-	  bool outsideCaloTime(true);
-	  for (const auto& cluster : *caloClusters)
-	    if (std::abs(time-cluster.time())<_clusterDt) {outsideCaloTime=false; break;}
-	  if (outsideCaloTime){
+	//calorimeter filtering; this preceeds the energy and position reconstruction so that
+	// filtered digis outside the calorimeter time windows cost only the time calibration
+	if (_usecc) {
+	  if (!_caloROI.contains(time)){
 	    if(_filter)continue;
 	  } else
 	    flag.merge(StrawHitFlag::calosel);
@@ -95,7 +95,10 @@ namespace mu2e {
       float             _maxdPhi;
       float             _tmin, _tmax, _tbin;
       float		_pitch; // average helix pitch (= dz/dflight, =sin(lambda))
-      TH1F              _timespec;
+      // time spectrum: bin 0 is the underflow and bin _nbins+1 the overflow, as for TH1
+      unsigned          _nbins;
+      float             _binwidth;
+      std::vector<float> _timespec;
       float             _ymin;
       bool              _refine;
       bool              _preFilter;
@@ -120,6 +123,8 @@ namespace mu2e {
       void clusterMean(TimeCluster& tc);
       void refineCluster(TimeCluster& tc);
       void findPeaks(TimeClusterCollection& seeds);
+      int  timeBin(float time) const;
+      float binCenter(int ibin) const { return _tmin + (ibin-0.5)*_binwidth; }
       void assignHits(TimeClusterCollection& tccol );
       bool goodHit(const StrawHitFlag& flag) const;
   };
@@ -156,8 +161,9 @@ namespace mu2e {
     _ttcalc            (pset.get<fhicl::ParameterSet>("T0Calculator",fhicl::ParameterSet())),
     _npeak             (pset.get<int>("PeakWidth",1)) // # of bins
     {
-      unsigned nbins = (unsigned)rint((_tmax-_tmin)/_tbin);
-      _timespec = TH1F("timespec","time spectrum",nbins,_tmin,_tmax);
+      _nbins = (unsigned)rint((_tmax-_tmin)/_tbin);
+      _binwidth = (_tmax-_tmin)/_nbins;
+      _timespec.resize(_nbins+2);
       produces<TimeClusterCollection>();
     }
 
@@ -246,12 +252,13 @@ namespace mu2e {
     // debug test of histogram
     if (_debug > 2) {
       art::ServiceHandle<art::TFileService> tfs;
-      TH1F* tspec = tfs->make<TH1F>(_timespec);
       char name[40];
       char title[100];
       snprintf(name,40,"tspec_%i",_iev);
       snprintf(title,100,"time spectrum event %i;nsec",_iev);
-      tspec->SetNameTitle(name,title);
+      TH1F* tspec = tfs->make<TH1F>(name,title,_nbins,_tmin,_tmax);
+      for (unsigned ibin=0; ibin < _timespec.size(); ++ibin)
+	tspec->SetBinContent(ibin,_timespec[ibin]);
     }
   }
 
@@ -268,13 +275,19 @@ namespace mu2e {
   }
 
   //--------------------------------------------------------------------------------------------------------------
+  int TimeClusterFinder::timeBin(float time) const {
+    if (time < _tmin) return 0;
+    if (time >= _tmax) return _nbins+1;
+    return std::min(_nbins,1+unsigned((time-_tmin)/_binwidth));
+  }
+
   void TimeClusterFinder::fillTimeSpectrum() {
-    _timespec.Reset();
+    std::fill(_timespec.begin(),_timespec.end(),0.0);
     for (unsigned istr=0; istr<_chcol->size();++istr) {
       if (_testflag && !goodHit((*_shfcol)[istr])) continue;
       ComboHit const& ch = (*_chcol)[istr];
       float time = _ttcalc.comboHitTime((*_chcol)[istr],_pitch);
-      _timespec.Fill(time,ch.nStrawHits());
+      _timespec[timeBin(time)] += ch.nStrawHits();
     }
   }
 
@@ -303,18 +316,18 @@ namespace mu2e {
 
   //--------------------------------------------------------------------------------------------------------------
   void TimeClusterFinder::findPeaks(TimeClusterCollection& tccol) {
-    int nbins = _timespec.GetNbinsX()+1;
+    int nbins = _nbins+1;
     std::vector<bool> alreadyUsed(nbins,false);
     // blank out bins around input times (from calo clusters)
     for(auto const& tc : tccol ){ 
-      int ibin = _timespec.FindBin(tc._t0._t0);
+      int ibin = timeBin(tc._t0._t0);
       for(int jbin = std::max(1,ibin-_npeak);jbin < std::min(nbins,ibin+_npeak+1); ++jbin)
 	alreadyUsed[jbin] = true;
     }
     // loop over spectrum to find peaks 
     std::vector<BinContent> bcv;
     for (int ibin=1;ibin < nbins; ++ibin)
-      if (_timespec.GetBinContent(ibin) >= _ymin) bcv.push_back(make_pair(_timespec.GetBinContent(ibin),ibin));
+      if (_timespec[ibin] >= _ymin) bcv.push_back(make_pair(_timespec[ibin],ibin));
     std::sort(bcv.begin(),bcv.end(),[](const BinContent& x, const BinContent& y){return x.first > y.first;});
 
     for (const auto& bc : bcv) {
@@ -322,8 +335,8 @@ namespace mu2e {
       float nsh(0.0);
       float t0(0.0);
       for (int ibin = std::max(1,bc.second-_npeak);ibin < std::min(nbins,bc.second+_npeak+1); ++ibin) {
-	nsh += _timespec.GetBinContent(ibin);
-	t0 += _timespec.GetBinCenter(ibin)*_timespec.GetBinContent(ibin);
+	nsh += _timespec[ibin];
+	t0 += binCenter(ibin)*_timespec[ibin];
 	alreadyUsed[ibin] = true;
       }
       t0 /= nsh;
@@ -0,0 +1,66 @@
+//
+// Intersection of a track with the calorimeter disks.
+//
+// The crossings of a helix with the disk envelopes (a z slab times an
+// annulus) are solved analytically: the squared radius along a helix is
+// r^2 = A - B cos(u), u linear in the flight length, so the entry and exit
+// points are the roots of cos(u) = c inside the flight range of the slab.
+// All the disks are done in one pass and the crossings are returned ordered
+// by flight length; a helix with negligible curvature over the slab is
+// treated as a straight line.
+//
+// trajCrossings maps the helix crossings onto the full trajectory and
+// refines them against the crystal map with a few steps and a bisection,
+// so the trajectory is only evaluated near the disk boundaries.
+//
+#ifndef TrkReco_CaloDiskIntersection_HH
+#define TrkReco_CaloDiskIntersection_HH
+
+#include <vector>
+
+class HelixTraj;
+class TrkDifTraj;
+
+namespace mu2e {
+
+  class Calorimeter;
+
+  class CaloDiskIntersection {
+  public:
+
+    // Disk envelope in the tracker frame.
+    struct Disk {
+      double zmin, zmax;
+      double rmin, rmax;
+    };
+
+    // fltIn < fltOut, whatever the direction of the track.
+    struct Crossing {
+      int    disk;
+      double fltIn;
+      double fltOut;
+    };
+
+    CaloDiskIntersection() {}
+    explicit CaloDiskIntersection(Calorimeter const& cal);
+    explicit CaloDiskIntersection(std::vector<Disk> const& disks) : _disks(disks) {}
+
+    std::vector<Disk> const& disks() const { return _disks; }
+
+    // Crossings of the helix with the disk envelopes.
+    void helixCrossings(HelixTraj const& helix, std::vector<Crossing>& crossings) const;
+
+    // Crossings of the trajectory with the crystals of the disks, seeded by
+    // the helix crossings.  step is the coarse search step, tolerance the
+    // precision of the bisection.  Envelope crossings that miss all the
+    // crystals are dropped.
+    void trajCrossings(Calorimeter const& cal, TrkDifTraj const& traj, HelixTraj const& helix,
+                       double step, double tolerance, std::vector<Crossing>& crossings) const;
+
+  private:
+
+    std::vector<Disk> _disks;
+  };
+
+}
+#endif
@@ -35,6 +35,7 @@
 #include "TrackerConditions/inc/StrawResponse.hh"
 #include "TrackerConditions/inc/Mu2eDetector.hh"
 #include "TrkReco/inc/TrkPrintUtils.hh"
+#include "TrkReco/inc/CaloDiskIntersection.hh"
 
 //CLHEP
 #include "CLHEP/Units/PhysicalConstants.h"
@@ -103,7 +104,6 @@ namespace mu2e
     unsigned _maxweedtch;
     bool _initt0;	    // initialize t0?
     bool _useTrkCaloHit;    //use the TrkCaloHit 
-    float  _nCaloExtrapolSteps;
     double _caloHitErr; // spatial error to use for TrkCaloHit
     std::vector<bool> _updatet0; // update t0 ieach iteration?
     std::vector<double> _t0tol;  // convergence tolerance for t0
@@ -136,7 +136,8 @@ namespace mu2e
  
 // parameters needed for evaluating the expected track impact point in the calorimeter
     unsigned _nCaloDisks;
-    std::array<float,2> _zmaxcalo, _zmincalo, _rmaxcalo, _rmincalo;
+    std::array<float,2> _zmincalo;
+    CaloDiskIntersection _caloInter;
 
     TrkPrintUtils*  _printUtils;
 
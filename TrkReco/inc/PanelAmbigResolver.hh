@@ -45,6 +45,13 @@ namespace mu2e {
 	bool fillPanelInfo(TrkStrawHitVector const& phits, const KalRep* krep, PanelInfo& pinfo) const;
 	// compute the panel result for a given ambiguity/activity state and the ionput t0
 	void fillResult(PanelInfo const& pinfo,TrkT0 const& t0, PanelResult& result) const;
+	// find the results for all states within _minsep of the best, pruning partial states
+	// whose chisquared already exceeds that
+	void searchStates(PanelInfo const& pinfo,TrkT0 const& t0, PRV& results) const;
+	// chisquared sums for a single hit in a given state
+	PanelSums hitSums(TSHUInfo const& tshui, HitState const& tshs) const;
+	// chisquared sums for the t0 and track constraints
+	PanelSums constraintSums(PanelInfo const& pinfo,TrkT0 const& t0) const;
 	// parameters
 	double _minsep; // minimum chisquared separation between best solution and the rest to consider a panel resolved
 	double _inactivepenalty; // chisquared penalty for an inactive hit
@@ -57,6 +64,7 @@ namespace mu2e {
 	double _maxhitu; // maximum u value allowed for a hit
 	bool _fixunallowed; // fix the state of any hit whose initial state isn't allowed
 	unsigned _maxnpanel; // max # of hits to consider for a panel
+	bool _prune; // use branch-and-bound search over panel states instead of exhaustive iteration
 	int _diag; // diagnostic level`
 	// TTree variables, mutable so they don't change const
 	mutable TTree *_padiag, *_pudiag; // diagnostic TTree
@@ -108,6 +108,20 @@ namespace mu2e {
 
     typedef std::vector<PanelResult> PRV;
 
+    // sums used in the 2nd-order chisquared expansion of a panel.  These are additive over
+    // hits, so partial panel states can be accumulated incrementally
+    struct PanelSums {
+      PanelSums() : _wsum(0.0), _uwsum(0.0), _vwsum(0.0), _uuwsum(0.0), _vvwsum(0.0), _uvwsum(0.0), _penalty(0.0) {}
+      void add(PanelSums const& other);
+      // optimize u and t0 given these sums and fill the result
+      void solve(PanelResult& result) const;
+      // minimum chisquared of these sums.  As every hit adds a positive-definite term, this is
+      // a lower bound on the chisquared of any state which extends the current one
+      double minChisq() const;
+      double _wsum, _uwsum, _vwsum, _uuwsum, _vvwsum, _uvwsum;
+      double _penalty; // chisquared penalty
+    };
+
     // utility function for combinatorics
     unsigned ipow(unsigned base, unsigned exp);
     bool setHitStates(PanelState const& pstate, TrkStrawHitVector& hits);
@@ -0,0 +1,83 @@
+//
+// Two Niveau algorithm with a spatial index: clusters live in a contiguous pool and are binned
+// in (x,y) cells of size MaxDistance and time slices of width MaxTimeDifference, so a hit only
+// tests the clusters in the neighboring cells. The cluster centroid is the weighted mean of its
+// hits, kept as running sums that are updated when a hit is added or removed.
+//
+#ifndef TNTGridClusterer_HH
+#define TNTGridClusterer_HH
+
+#include "TrkReco/inc/BkgClusterer.hh"
+#include "DataProducts/inc/XYZVec.hh"
+#include "fhiclcpp/ParameterSet.h"
+
+#include <vector>
+
+namespace mu2e {
+
+
+  class TNTGridClusterer : public BkgClusterer
+  {
+
+     public:
+
+         explicit TNTGridClusterer(fhicl::ParameterSet const&);
+         virtual ~TNTGridClusterer() {};
+
+         void init() {};
+         virtual void findClusters(BkgClusterCollection& clusters, ComboHitCollection const& chcol);
+
+     private:
+
+         struct GridCluster
+         {
+            XYZVec  _pos;
+            float   _time;
+            float   _phi0;      // reference phi for the phi sum, avoids the wrap around
+            double  _sw, _srho, _sdphi, _st;
+            int     _nhits;
+            int     _cell;
+            bool    _hasChanged;
+         };
+
+         void     initClu(const ComboHitCollection& chcol, std::vector<BkgClusterHit>& chits);
+         unsigned formClusters(const ComboHitCollection& chcol, std::vector<BkgClusterHit>& chits);
+         int      newCluster(const ComboHit& hit);
+         void     addHit(GridCluster& cluster, const ComboHit& hit);
+         void     removeHit(GridCluster& cluster, const ComboHit& hit);
+         void     updateCache(GridCluster& cluster);
+         float    distance(const GridCluster& cluster, const ComboHit& hit) const;
+
+         int      cellIndex(const XYZVec& pos, float time) const;
+         void     addToCell(int icell, int iclu);
+         void     removeFromCell(int icell, int iclu);
+         int      findClosest(const ComboHit& hit, float& mindist) const;
+
+         int          _diag;
+	 bool	      _testflag;    // test background flag
+         StrawHitFlag _bkgmask;     // mask for background hits
+         StrawHitFlag _sigmask;     // mask for selecting signals
+         bool         _comboInit;   // Start with stereo hits
+         float        _dseed;       // Minimum separation to seed a new cluster
+         float        _dhit;        // Maximum separation to include a hit in a cluster
+         float        _dd;          // cluster diameter
+         float        _dt;          // natural time spread
+         float        _maxdt;       // maximum time difference, also the time slice width
+         float        _maxdist;     // maximum distance, also the cell size
+         float        _gridHalfSize;// half size of the (x,y) grid, hits outside are put in the edge cells
+         int          _ntslices;    // number of time slices, time is folded modulo ntslices
+         unsigned     _maxNiter;
+         unsigned     _maxNchanged;
+
+         std::vector<GridCluster>      _clusters;  // contiguous cluster pool
+         std::vector<int>              _cidx;      // cluster index for each combo hit, -1 if none
+         std::vector<std::vector<int>> _cells;     // cluster indices in each (x,y,t) cell
+         std::vector<int>              _usedCells; // non-empty cells, to reset the grid quickly
+         int        _ncell;
+         float      _trms2inv;
+         float      _dd2;
+         float      _maxwt;
+         float      _md2;
+  };
+}
+#endif
@@ -0,0 +1,190 @@
+//
+// Intersection of a track with the calorimeter disks, see the header.
+//
+// Mu2e
+#include "TrkReco/inc/CaloDiskIntersection.hh"
+#include "CalorimeterGeom/inc/Calorimeter.hh"
+// BTrk
+#include "BTrk/BbrGeom/HepPoint.h"
+#include "BTrk/TrkBase/HelixTraj.hh"
+#include "BTrk/TrkBase/TrkDifTraj.hh"
+// CLHEP
+#include "CLHEP/Vector/ThreeVector.h"
+//C++
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace mu2e {
+
+  namespace {
+
+    // helices that turn more than this in the slab of a disk, i.e. that
+    // are almost parallel to it, are not extrapolated
+    const double maxTurns = 50.0;
+
+    // below this turning angle over the slab the helix is a straight line
+    const double minTurnAngle = 1e-6;
+
+    // steps beyond the envelope crossing allowed to the trajectory
+    const int maxSteps = 10;
+
+    // roots of cos(u) = c with u in [ulo,uhi]
+    void cosRoots(double c, double ulo, double uhi, std::vector<double>& roots) {
+      if (std::fabs(c) > 1.0) return;
+      const double twoPi = 2.0*M_PI;
+      double a = std::acos(c);
+      for (double r : {a,-a}) {
+	for (double k = std::ceil((ulo-r)/twoPi); r+k*twoPi <= uhi; k += 1.0)
+	  roots.push_back(r+k*twoPi);
+      }
+    }
+  }
+
+  CaloDiskIntersection::CaloDiskIntersection(Calorimeter const& cal) {
+    for (unsigned i=0; i<cal.nDisk(); ++i) {
+      double zfront = cal.geomUtil().mu2eToTracker(cal.disk(i).geomInfo().frontFaceCenter()).z();
+      double zback  = cal.geomUtil().mu2eToTracker(cal.disk(i).geomInfo().backFaceCenter()).z();
+      _disks.push_back(Disk{std::min(zfront,zback), std::max(zfront,zback),
+	    cal.disk(i).geomInfo().innerEnvelopeR(), cal.disk(i).geomInfo().outerEnvelopeR()});
+    }
+  }
+
+  void CaloDiskIntersection::helixCrossings(HelixTraj const& helix, std::vector<Crossing>& crossings) const {
+    crossings.clear();
+
+    double cosDip = helix.cosDip();
+    double sinDip = helix.tanDip()*cosDip;
+    if (std::fabs(sinDip) < 1e-6) return;
+
+    HepPoint const& ref = helix.referencePoint();
+    double phi0  = helix.phi0();
+    double omega = helix.omega();
+    double d0    = helix.d0();
+    // turning rate per unit flight length
+    double k     = omega*cosDip;
+
+    std::vector<double> flts;
+    for (unsigned idisk=0; idisk<_disks.size(); ++idisk) {
+      Disk const& disk = _disks[idisk];
+      double s1 = helix.zFlight(disk.zmin);
+      double s2 = helix.zFlight(disk.zmax);
+      if (s1 > s2) std::swap(s1,s2);
+      if (std::fabs(k*(s2-s1)) > maxTurns*2.0*M_PI) continue;
+
+      double rmin2 = disk.rmin*disk.rmin;
+      double rmax2 = disk.rmax*disk.rmax;
+      flts.clear();
+      flts.push_back(s1);
+
+      // squared radius as a function of the flight length
+      std::function<double(double)> radius2;
+
+      if (std::fabs(k*(s2-s1)) < minTurnAngle) {
+	// straight line p + s*t; |p + s*t|^2 = rho^2 is a quadratic in s
+	double px = ref.x() - d0*std::sin(phi0), py = ref.y() + d0*std::cos(phi0);
+	double tx = cosDip*std::cos(phi0),       ty = cosDip*std::sin(phi0);
+	double a  = tx*tx + ty*ty, b = px*tx + py*ty, c0 = px*px + py*py;
+	radius2 = [=](double s){ return c0 + 2.0*b*s + a*s*s; };
+	for (double rho2 : {rmin2,rmax2}) {
+	  double disc = b*b - a*(c0-rho2);
+	  if (disc < 0) continue;
+	  flts.push_back((-b - std::sqrt(disc))/a);
+	  flts.push_back((-b + std::sqrt(disc))/a);
+	}
+      } else {
+	// circle of radius R around (cx,cy): r^2 = R^2 + rc^2 - 2 R rc cos(u),
+	// u = phi0 + k s - psi
+	double R   = 1.0/omega;
+	double D   = d0 + R;
+	double cx  = ref.x() - D*std::sin(phi0);
+	double cy  = ref.y() + D*std::cos(phi0);
+	double rc  = std::sqrt(cx*cx + cy*cy);
+	double A   = R*R + rc*rc;
+	double B   = 2.0*R*rc;
+	double u0  = phi0 - std::atan2(-cx,cy);
+	radius2 = [=](double s){ return A - B*std::cos(u0 + k*s); };
+	if (std::fabs(B) > 0) {
+	  double u1 = u0 + k*s1, u2 = u0 + k*s2;
+	  std::vector<double> roots;
+	  for (double rho2 : {rmin2,rmax2}) cosRoots((A-rho2)/B, std::min(u1,u2), std::max(u1,u2), roots);
+	  for (double u : roots) flts.push_back((u-u0)/k);
+	}
+      }
+
+      flts.push_back(s2);
+      std::sort(flts.begin(),flts.end());
+
+      // keep the intervals whose middle is inside the annulus, merging neighbours
+      bool open(false);
+      for (size_t i=1; i<flts.size(); ++i) {
+	double lo = std::max(flts[i-1],s1), hi = std::min(flts[i],s2);
+	if (hi <= lo) continue;
+	double r2 = radius2(0.5*(lo+hi));
+	bool inside = r2 >= rmin2 && r2 <= rmax2;
+	if (inside && open) crossings.back().fltOut = hi;
+	else if (inside)    crossings.push_back(Crossing{int(idisk),lo,hi});
+	open = inside;
+      }
+    }
+
+    std::sort(crossings.begin(),crossings.end(),[](Crossing const& a, Crossing const& b){ return a.fltIn < b.fltIn; });
+  }
+
+  void CaloDiskIntersection::trajCrossings(Calorimeter const& cal, TrkDifTraj const& traj, HelixTraj const& helix,
+					   double step, double tolerance, std::vector<Crossing>& crossings) const {
+    std::vector<Crossing> hcross;
+    helixCrossings(helix,hcross);
+    crossings.clear();
+    if (hcross.empty()) return;
+
+    double sinDip = helix.tanDip()*helix.cosDip();
+
+    for (auto const& hc : hcross) {
+      auto inside = [&](double flt) {
+	HepPoint pos = traj.position(flt);
+	return cal.geomUtil().isInsideSection(hc.disk, cal.geomUtil().trackerToMu2e(CLHEP::Hep3Vector(pos.x(),pos.y(),pos.z())));
+      };
+      // first order correction of the helix flight to match the trajectory
+      auto onTraj = [&](double flt) {
+	return flt + (helix.position(flt).z() - traj.position(flt).z())/sinDip;
+      };
+      // boundary between a point inside and a point outside
+      auto bisect = [&](double fin, double fout) {
+	while (std::fabs(fin-fout) > tolerance) {
+	  double mid = 0.5*(fin+fout);
+	  if (inside(mid)) fin = mid;
+	  else             fout = mid;
+	}
+	return 0.5*(fin+fout);
+      };
+
+      double fltIn  = onTraj(hc.fltIn)  - step;
+      double fltOut = onTraj(hc.fltOut) + step;
+
+      // entry: step forward from just before the envelope to the first crystal
+      double fin(fltIn), fout(fltIn);
+      while (fin <= fltOut && !inside(fin)) { fout = fin; fin += step; }
+      if (fin > fltOut) continue;
+      if (fin == fltIn) {
+	// the correction was not enough, step back to get outside
+	fout = fin - step;
+	for (int i=0; i<maxSteps && inside(fout); ++i) { fin = fout; fout -= step; }
+      }
+      double entry = bisect(fin,fout);
+
+      // exit: step back from just after the envelope to the last crystal
+      fin = fout = fltOut;
+      while (fin > entry && !inside(fin)) { fout = fin; fin -= step; }
+      if (fin <= entry) fin = entry;
+      if (fin == fltOut) {
+	fout = fin + step;
+	for (int i=0; i<maxSteps && inside(fout); ++i) { fin = fout; fout += step; }
+      }
+      double exit = bisect(fin,fout);
+
+      crossings.push_back(Crossing{hc.disk,entry,exit});
+    }
+  }
+
+}
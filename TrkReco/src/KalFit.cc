@@ -99,7 +99,6 @@ namespace mu2e
     _maxweedtch(pset.get<unsigned>("maxweedtch",1)),
     // t0 parameters
     _useTrkCaloHit(pset.get<bool>("useTrkCaloHit")),
-    _nCaloExtrapolSteps(pset.get<float>("nCaloExtrapolSteps", 100)),
     _caloHitErr(pset.get<double>("caloHitError")),
     _updatet0(pset.get<vector<bool>>("updateT0")),
     _t0tol(pset.get< vector<double> >("t0Tolerance")),
@@ -215,15 +214,16 @@ namespace mu2e
     
     _nCaloDisks = ch->nDisk();
     double      crystalLength = ch->caloInfo().getDouble("crystalZLength");
+    std::vector<CaloDiskIntersection::Disk> disks;
     for (unsigned i=0; i<_nCaloDisks; ++i){
       CLHEP::Hep3Vector pos(ch->disk(i).geomInfo().frontFaceCenter());
       pos = ch->geomUtil().mu2eToTracker(pos);
       
       _zmincalo[i] = (pos.z());
-      _zmaxcalo[i] = (pos.z()+crystalLength);
-      _rmincalo[i] = (ch->disk(i).geomInfo().innerEnvelopeR());
-      _rmaxcalo[i] = (ch->disk(i).geomInfo().outerEnvelopeR());
+      disks.push_back(CaloDiskIntersection::Disk{pos.z(), pos.z()+crystalLength,
+	    ch->disk(i).geomInfo().innerEnvelopeR(), ch->disk(i).geomInfo().outerEnvelopeR()});
     }
+    _caloInter = CaloDiskIntersection(disks);
   }
 
 
@@ -834,32 +834,26 @@ namespace mu2e
   KalFit::findCaloDiskFromTrack(KalFitData& kalData, int& trkToCaloDiskId, double& caloFlt){
     KalRep*krep = kalData.krep;
     const TrkDifPieceTraj* reftraj = krep->referenceTraj();
-    float  zExtrapolStep  = (_zmaxcalo[0] - _zmincalo[0])/(float)_nCaloExtrapolSteps;
 
     //initialize the output values
     trkToCaloDiskId = -1;
     caloFlt         = 0;
 
-    float  fltIn(0), fltOut(0);
-    for (unsigned i=0; i<_nCaloDisks; ++i){
-      for (unsigned j=0; j<_nCaloExtrapolSteps; ++j){
-	double flt(0);
-	double zCaloExtrap = _zmincalo[i] + j*zExtrapolStep;
-	TrkHelixUtils::findZFltlen(*reftraj, zCaloExtrap, flt);
-	HepPoint pos    = krep->referenceTraj()->position(flt);
-	float    radius = sqrt(pos.x()*pos.x() + pos.y()*pos.y());
-	if ( (radius >= _rmincalo[i]) && (radius <= _rmaxcalo[i])){
-	  if (trkToCaloDiskId<0) {
-	    trkToCaloDiskId = i;
-	    fltIn  = flt;
-	  }else {
-	    fltOut = flt;
-	  }
-	} 
-      }//end loop over the z-steps
-      if (trkToCaloDiskId>=0) break;
-    }//end loop over tghe disks   
-    if (trkToCaloDiskId >= 0)  caloFlt = fltOut - fltIn;
+    //intersect the local helix at the calorimeter front face with the disks
+    double flt(0);
+    TrkHelixUtils::findZFltlen(*reftraj, _zmincalo[0], flt);
+    HelixTraj trkHel(krep->helix(flt).params(), krep->helix(flt).covariance());
+    std::vector<CaloDiskIntersection::Crossing> crossings;
+    _caloInter.helixCrossings(trkHel, crossings);
+    if (crossings.empty()) return;
+
+    //the first disk reached; the path spans all its crossings
+    trkToCaloDiskId = crossings.front().disk;
+    double fltIn(crossings.front().fltIn), fltOut(fltIn);
+    for (auto const& cross : crossings){
+      if (cross.disk == trkToCaloDiskId) fltOut = cross.fltOut;
+    }
+    caloFlt = fltOut - fltIn;
   }
 
 
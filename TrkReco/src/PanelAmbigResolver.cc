@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <functional>
 #include <iostream>
+#include <limits>
 // art
 #include "art_root_io/TFileService.h"
 #include "art/Framework/Services/Registry/ServiceHandle.h"
@@ -53,6 +54,7 @@ namespace mu2e {
       _maxhitu(pset.get<double>("MaximumHitU",8.0)),
       _fixunallowed(pset.get<bool>("FixUnallowedHitStates",true)),
       _maxnpanel(pset.get<unsigned>("MaxHitsPerPanel",8)),
+      _prune(pset.get<bool>("PruneStates",false)),
       _diag(pset.get<int>("DiagLevel",0))
     {
       double nullerr = pset.get<double>("ExtraNullAmbigError",0.0);
@@ -118,15 +120,19 @@ namespace mu2e {
       // fill panel information
       PanelInfo pinfo;
       if(fillPanelInfo(phits,krep,pinfo)){
-	// loop over all ambiguity/activity states for this panel
-	PanelStateIterator psi(pinfo._uinfo,_allowed);
 	PRV results;
-	do {
-	  // for each state, fill the result of the 1-dimensional optimization
-	  PanelResult result(psi.current());
-	  fillResult(pinfo,krep->t0(),result);
-	  if(result._status == 0)results.push_back(result);
-	} while(psi.increment());
+	if(_prune){
+	  searchStates(pinfo,krep->t0(),results);
+	} else {
+	  // loop over all ambiguity/activity states for this panel
+	  PanelStateIterator psi(pinfo._uinfo,_allowed);
+	  do {
+	    // for each state, fill the result of the 1-dimensional optimization
+	    PanelResult result(psi.current());
+	    fillResult(pinfo,krep->t0(),result);
+	    if(result._status == 0)results.push_back(result);
+	  } while(psi.increment());
+	}
 	if(results.size() > 0){
 	  // sort the results to have lowest chisquard first
 	  std::sort(results.begin(),results.end(),resultcomp());
@@ -234,99 +240,150 @@ namespace mu2e {
       return retval;
     }
 
+    PanelSums PanelAmbigResolver::hitSums(TSHUInfo const& tshui, HitState const& tshs) const {
+      PanelSums sums;
+      // compute chisquared for selected hits
+      if(tshui._use == TSHUInfo::free || tshui._use == TSHUInfo::fixed){
+	// compute u 
+	if(tshs._state != HitState::inactive){
+	  double w = tshui._uwt;
+	  double r = tshui._dr;
+	  double v = tshui._dv;
+	  // sign for ambiguity
+	  if(tshs._state == HitState::negambig){
+	    r *= -1;
+	    v *= -1;
+	  } else if(tshs._state == HitState::noambig){
+	    r = 0.; // inactive hits don't depend on time
+	    v = 0.;
+	    w = 1.0/(1.0/w + _nullerr2); // increase the error on 0 ambiguity hits
+	    sums._penalty += _nullpenalty;
+	  }
+	  double u = tshui._upos + r;
+	  sums._wsum += w;
+	  sums._uwsum += u*w;
+	  sums._vwsum += v*w;
+	  sums._uuwsum += u*u*w;
+	  sums._vvwsum += v*v*w;
+	  sums._uvwsum += u*v*w;
+	} else // penalize inactive hits
+	  sums._penalty += _inactivepenalty;
+      }
+      return sums;
+    }
+
+    PanelSums PanelAmbigResolver::constraintSums(PanelInfo const& pinfo,TrkT0 const& t0) const {
+      PanelSums sums;
+      // propogate t0 uncertainty.  This is a constraint centered at the
+      // current value of t0, unit derivative
+      double t0wt = 1.0/(t0._t0err*t0._t0err);
+      sums._vvwsum += t0wt; // t0 has unit derrivative
+      // optionally add track position constraint if there are multiple hits.  It is like a hit, but with r=v=0
+      // NB, since the track position is defined to be 0, it adds only to the weight
+      if(_addtrkpos || pinfo._nused == 1)sums._wsum += pinfo._tuwt;
+      return sums;
+    }
+
+    // record which hits change state WRT their initial state
+    static void fillStateChange(PanelInfo const& pinfo, PanelResult& result) {
+      for(size_t itsh=0;itsh<pinfo._uinfo.size();++itsh){
+	TSHUInfo const& tshui = pinfo._uinfo[itsh];
+	if((tshui._use == TSHUInfo::free || tshui._use == TSHUInfo::fixed) &&
+	    result._state[itsh] != tshui._hstate)
+	  result._statechange |= (itsh << 1);
+      }
+    }
+
     void PanelAmbigResolver::fillResult(PanelInfo const& pinfo,TrkT0 const& t0, PanelResult& result) const {
-      // initialize the sums
-      double wsum(0.0);
-      double uwsum(0.0);
-      double vwsum(0.0);
-      double uuwsum(0.0);
-      double vvwsum(0.0);
-      double uvwsum(0.0);
-      double chi2penalty(0.0);
-      // loop over the straw hit info and accumulate the sums used to compute chisquared
-      size_t ntsh = pinfo._uinfo.size();
       // consistency check
-      if(ntsh != result._state.size()) 
+      if(pinfo._uinfo.size() != result._state.size()) 
 	throw cet::exception("RECO")<<"mu2e::PanelAmbigResolver: inconsistent hits" << std::endl;
-      for(size_t itsh=0;itsh<ntsh;++itsh){
-	HitState const& tshs = result._state[itsh];
-	TSHUInfo const& tshui = pinfo._uinfo[itsh];
-	// compute chisquared for selected hits
-	if(tshui._use == TSHUInfo::free || tshui._use == TSHUInfo::fixed){
-	  // compare this state to the original, record any differences
-	  if(tshs != tshui._hstate)
-	    result._statechange |= (itsh << 1);
-	  // compute u 
-	  if(tshs._state != HitState::inactive){
-	    double w = tshui._uwt;
-	    double r = tshui._dr;
-	    double v = tshui._dv;
-	    // sign for ambiguity
-	    if(tshs._state == HitState::negambig){
-	      r *= -1;
-	      v *= -1;
-	    } else if(tshs._state == HitState::noambig){
-	      r = 0.; // inactive hits don't depend on time
-	      v = 0.;
-	      w = 1.0/(1.0/w + _nullerr2); // increase the error on 0 ambiguity hits
-	      chi2penalty += _nullpenalty;
-	    }
-	    double u = tshui._upos + r;
-	    wsum += w;
-	    uwsum += u*w;
-	    vwsum += v*w;
-	    uuwsum += u*u*w;
-	    vvwsum += v*v*w;
-	    uvwsum += u*v*w;
-	  } else // penalize inactive hits
-	    chi2penalty += _inactivepenalty;
-	}
-      }
       if(pinfo._nused > 0){
-	// propogate t0 uncertainty.  This is a constraint centered at the
-	// current value of t0, unit derivative
-	double t0wt = 1.0/(t0._t0err*t0._t0err);
-	vvwsum += t0wt; // t0 has unit derrivative
-	// optionally add track position constraint if there are multiple hits.  It is like a hit, but with r=v=0
-	// NB, since the track position is defined to be 0, it adds only to the weight
-	if(_addtrkpos || pinfo._nused == 1)wsum += pinfo._tuwt;
-	// now compute the scalar, vector, and tensor terms for the 2nd-order chisquared expansion
-	double alpha = uuwsum;
-	HepVector beta(2);
-	beta(1) = uwsum;
-	beta(2) = uvwsum;
-	HepSymMatrix gamma(2);
-	gamma.fast(1,1) = wsum;
-	gamma.fast(2,2) = vvwsum;
-	gamma.fast(1,2) = vwsum;
-	// invert and solve
-	gamma.invert(result._status);
-	if(result._status == 0){
-	  result._dcov = gamma;
-	  result._delta = gamma * beta;
-	  result._chisq = alpha - gamma.similarity(beta) + chi2penalty;
-	  // debug printout
-#ifdef DEBUG
-	  double g11 = gamma.fast(1,1);
-	  double g22 = gamma.fast(2,2);
-	  double g12 = gamma.fast(1,2);
-	  double g21 = gamma.fast(2,1);
-	  double b1 = beta(1);
-	  double b2 = beta(2);
-	  double d1 = result._delta(1);
-	  double d2 = result._delta(2);
-	  double sim = gamma.similarity(beta);
-	  double test = alpha - sim;
-	  double test2 = alpha -2*dot(beta,result._delta) + gamma.similarity(result._delta);
-#endif
-	  // add a penalty term (if any) for this particular pattern.  Still to be written, FIXME!!!
-	  //  addPatternPenalty();
-	}
+	fillStateChange(pinfo,result);
+	// loop over the straw hit info and accumulate the sums used to compute chisquared
+	PanelSums sums = constraintSums(pinfo,t0);
+	for(size_t itsh=0;itsh<pinfo._uinfo.size();++itsh)
+	  sums.add(hitSums(pinfo._uinfo[itsh],result._state[itsh]));
+	sums.solve(result);
+	// add a penalty term (if any) for this particular pattern.  Still to be written, FIXME!!!
+	//  addPatternPenalty();
       } else {
       // if there are no active hits, flag the status
 	result._status = -100;
       }
     }
 
+    void PanelAmbigResolver::searchStates(PanelInfo const& pinfo,TrkT0 const& t0, PRV& results) const {
+      if(pinfo._nused == 0)return;
+      size_t nhits = pinfo._uinfo.size();
+      size_t nallowed = _allowed.size();
+      // non-free hits are common to all states: accumulate them once
+      PanelState pstate(nhits);
+      PanelSums fixedsums = constraintSums(pinfo,t0);
+      std::vector<size_t> ifree;
+      for(size_t ihit=0;ihit<nhits;++ihit){
+	TSHUInfo const& tshui = pinfo._uinfo[ihit];
+	if(tshui._use == TSHUInfo::free)
+	  ifree.push_back(ihit);
+	else {
+	  pstate[ihit] = tshui._hstate;
+	  fixedsums.add(hitSums(tshui,tshui._hstate));
+	}
+      }
+      // branch over the free hits in u order, so that neighboring hits constrain each other early
+      std::sort(ifree.begin(),ifree.end(),[&pinfo](size_t a, size_t b) {
+	  return pinfo._uinfo[a]._upos < pinfo._uinfo[b]._upos; });
+      size_t nfree = ifree.size();
+      // precompute the terms of each free hit in each allowed state
+      std::vector<PanelSums> terms(nfree*nallowed);
+      for(size_t ifr=0;ifr<nfree;++ifr)
+	for(size_t ias=0;ias<nallowed;++ias)
+	  terms[ifr*nallowed+ias] = hitSums(pinfo._uinfo[ifree[ifr]],_allowed[ias]);
+      if(nfree == 0){
+	PanelResult result(pstate);
+	fillStateChange(pinfo,result);
+	fixedsums.solve(result);
+	if(result._status == 0)results.push_back(result);
+	return;
+      }
+      // depth-first search.  Partial states whose chisquared is already beyond _minsep from the
+      // best complete state can't contribute to the resolution, so those branches are dropped
+      double best(std::numeric_limits<double>::max());
+      std::vector<PanelSums> partial(nfree+1);
+      std::vector<size_t> istate(nfree,0);
+      partial[0] = fixedsums;
+      size_t depth(0);
+      while(true){
+	if(istate[depth] == nallowed){
+	  // this level is exhausted; backtrack
+	  if(depth == 0)break;
+	  --depth;
+	  ++istate[depth];
+	  continue;
+	}
+	PanelSums psums = partial[depth];
+	psums.add(terms[depth*nallowed+istate[depth]]);
+	if(psums.minChisq() - best >= _minsep){
+	  ++istate[depth];
+	  continue;
+	}
+	pstate[ifree[depth]] = _allowed[istate[depth]];
+	if(depth+1 == nfree){
+	  PanelResult result(pstate);
+	  fillStateChange(pinfo,result);
+	  psums.solve(result);
+	  if(result._status == 0){
+	    results.push_back(result);
+	    best = std::min(best,(double)result._chisq);
+	  }
+	  ++istate[depth];
+	} else {
+	  ++depth;
+	  partial[depth] = psums;
+	  istate[depth] = 0;
+	}
+      }
+    }
+
   } // PanelAmbig namespace
 } // mu2e namespace
@@ -105,6 +105,43 @@ namespace mu2e
       _index = tsh->index();
     }
 
+    void PanelSums::add(PanelSums const& other) {
+      _wsum += other._wsum;
+      _uwsum += other._uwsum;
+      _vwsum += other._vwsum;
+      _uuwsum += other._uuwsum;
+      _vvwsum += other._vvwsum;
+      _uvwsum += other._uvwsum;
+      _penalty += other._penalty;
+    }
+
+    void PanelSums::solve(PanelResult& result) const {
+      // compute the scalar, vector, and tensor terms for the 2nd-order chisquared expansion
+      double alpha = _uuwsum;
+      CLHEP::HepVector beta(2);
+      beta(1) = _uwsum;
+      beta(2) = _uvwsum;
+      CLHEP::HepSymMatrix gamma(2);
+      gamma.fast(1,1) = _wsum;
+      gamma.fast(2,2) = _vvwsum;
+      gamma.fast(1,2) = _vwsum;
+      // invert and solve
+      gamma.invert(result._status);
+      if(result._status == 0){
+	result._dcov = gamma;
+	result._delta = gamma * beta;
+	result._chisq = alpha - gamma.similarity(beta) + _penalty;
+      }
+    }
+
+    double PanelSums::minChisq() const {
+      // same as solve, but using the explicit 2x2 inverse
+      double det = _wsum*_vvwsum - _vwsum*_vwsum;
+      if(det <= 0.0) return _penalty;
+      double sim = (_vvwsum*_uwsum*_uwsum - 2.0*_vwsum*_uwsum*_uvwsum + _wsum*_uvwsum*_uvwsum)/det;
+      return _uuwsum - sim + _penalty;
+    }
+
     unsigned ipow(unsigned base, unsigned exp) {
       unsigned result = 1;
       while (exp)
@@ -0,0 +1,321 @@
+//
+// Two Niveau algorithm with a (x,y,t) grid index and a contiguous cluster pool
+//
+#include "TrkReco/inc/TNTGridClusterer.hh"
+#include "GeneralUtilities/inc/Angles.hh"
+#include "cetlib_except/exception.h"
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <float.h>
+
+#include "Math/VectorUtil.h"
+
+using namespace ROOT::Math::VectorUtil;
+
+
+namespace mu2e
+{
+
+   //---------------------------------------------------------------------------------------
+   TNTGridClusterer::TNTGridClusterer(const fhicl::ParameterSet& pset) :
+     _diag(pset.get<int>(                         "diagLevel",0)),
+     _testflag(pset.get<bool>(                    "TestFlag")),
+     _bkgmask(pset.get<std::vector<std::string> >("BackgroundMask",std::vector<std::string>())),
+     _sigmask(pset.get<std::vector<std::string> >("SignalMask",std::vector<std::string>())),
+     _comboInit(pset.get<bool>(                   "ComboInit",true)),
+     _dseed(pset.get<float>(                      "SeedDistance")),
+     _dhit(pset.get<float>(                       "HitDistance")),
+     _dd(pset.get<float>(                         "ClusterDiameter",10.0)),
+     _dt(pset.get<float>(                         "TimeDifference",30.0)),
+     _maxdt(pset.get<float>(                      "MaxTimeDifference")),
+     _maxdist(pset.get<float>(                    "MaxDistance",50.0)),
+     _gridHalfSize(pset.get<float>(               "GridHalfSize",800.0)),
+     _ntslices(pset.get<int>(                     "NTimeSlices",16)),
+     _maxNiter(pset.get<unsigned>(                "MaxNIterations")),
+     _maxNchanged(pset.get<unsigned>(             "MaxNChanged",2)),
+     _clusters(),
+     _cidx(),
+     _cells(),
+     _usedCells()
+   {
+       if (_maxdist <= 0 || _maxdt <= 0 || _ntslices < 1)
+         throw cet::exception("RECO")<<"TNTGridClusterer: MaxDistance, MaxTimeDifference and NTimeSlices must be positive" << std::endl;
+
+       // cache some values
+       float minerr(pset.get<float>( "MinHitError",5.0));
+       float trms(pset.get<float>(   "TimeRMS",2.0));
+
+       _trms2inv = 1.0/trms/trms;
+       _dd2      = _dd*_dd;
+       _maxwt    = 1.0/minerr;
+       _md2      = _maxdist*_maxdist;
+
+       // a hit further than MaxDistance or MaxTimeDifference from a cluster is never associated
+       // to it, so the cell sizes guarantee that only the neighboring cells need to be searched
+       _ncell = std::max(1,int(std::ceil(2.0*_gridHalfSize/_maxdist)));
+       _cells = std::vector<std::vector<int>>(_ncell*_ncell*_ntslices,std::vector<int>());
+   }
+
+
+
+   //-------------------------------------------------------------------------------------------------------------------
+   void TNTGridClusterer::findClusters(BkgClusterCollection& clusterColl, const ComboHitCollection& chcol)
+   {
+      //reset stuff
+      _clusters.clear();
+      _clusters.reserve(chcol.size());
+      _cidx.assign(chcol.size(),-1);
+      for (int icell : _usedCells) _cells[icell].clear();
+      _usedCells.clear();
+
+      std::vector<BkgClusterHit> chits;
+      chits.reserve(chcol.size());
+      initClu(chcol,chits);
+
+      unsigned niter(0),nChanged(chits.size());
+      while (nChanged > _maxNchanged && niter < _maxNiter)
+      {
+          nChanged = formClusters(chcol,chits);
+          if (_diag > 1) std::cout<<"TNTGridClusterer iteration "<<niter<<" changed "<<nChanged<<std::endl;
+          ++niter;
+      }
+
+      //form and insert final BkgClusters here, the hits are moved in cluster order
+      std::vector<int> outIdx(_clusters.size(),-1);
+      for (size_t ic=0; ic<_clusters.size(); ++ic)
+      {
+         const GridCluster& cluster = _clusters[ic];
+         if (cluster._nhits==0) continue;
+         outIdx[ic] = clusterColl.size();
+         clusterColl.emplace_back(BkgCluster(cluster._pos, cluster._time));
+         clusterColl.back()._hits.reserve(cluster._nhits);
+      }
+      for (auto& chit : chits)
+      {
+         int ic = _cidx[chit.index()];
+         if (ic >= 0) clusterColl[outIdx[ic]]._hits.emplace_back(std::move(chit));
+      }
+
+      if (_diag > 0) std::cout<<"TNTGridClusterer: "<<chits.size()<<" hits, "<<_clusters.size()<<" clusters in pool, "
+                              <<niter<<" iterations"<<std::endl;
+   }
+
+
+
+   //-------------------------------------------------------------------------------------------------------------------
+   void TNTGridClusterer::initClu(const ComboHitCollection& chcol, std::vector<BkgClusterHit>& chits)
+   {
+     for (size_t ish=0; ish<chcol.size(); ++ish){
+       if (_testflag && (!chcol[ish].flag().hasAllProperties(_sigmask) || chcol[ish].flag().hasAnyProperty(_bkgmask))) continue;
+       chits.emplace_back(BkgClusterHit(ish,chcol[ish].flag()));
+     }
+     if (_comboInit)
+       std::sort(chits.begin(),chits.end(),[&chcol](const BkgClusterHit& x, const BkgClusterHit& y)
+                                           {return chcol[x.index()].wireRes() < chcol[y.index()].wireRes();});
+   }
+
+
+
+   //-------------------------------------------------------------------------------------------------------------------
+   // loop over hits, keep them in their cluster if they are still within the radius, otherwise look at the clusters
+   // in the neighboring cells to check if they could be added. If not, make a new cluster. Moving a hit updates the
+   // cluster sums right away, the centroids and the grid are refreshed at the end of the pass
+   unsigned TNTGridClusterer::formClusters(const ComboHitCollection& chcol, std::vector<BkgClusterHit>& chits)
+   {
+       unsigned nchanged(0);
+       for (auto& chit : chits)
+       {
+          int hitIdx = chit.index();
+          int iold   = _cidx[hitIdx];
+          if (iold >= 0 && chit.distance() < _dhit) continue;
+
+          const ComboHit& hit = chcol[hitIdx];
+          float mindist(FLT_MAX);
+          int inew = findClosest(hit,mindist);
+
+          if      (mindist < _dhit)  {}
+          else if (mindist > _dseed) inew = newCluster(hit);
+          else                       inew = -1;
+
+          if (inew == iold) continue;
+
+          ++nchanged;
+          if (iold >= 0) removeHit(_clusters[iold],hit);
+          if (inew >= 0) addHit(_clusters[inew],hit);
+          _cidx[hitIdx] = inew;
+       }
+
+       for (size_t ic=0; ic<_clusters.size(); ++ic)
+       {
+          GridCluster& cluster = _clusters[ic];
+          if (!cluster._hasChanged) continue;
+
+          updateCache(cluster);
+          int icell = cluster._nhits > 0 ? cellIndex(cluster._pos,cluster._time) : -1;
+          if (icell != cluster._cell)
+          {
+             if (cluster._cell >= 0) removeFromCell(cluster._cell,ic);
+             if (icell >= 0)         addToCell(icell,ic);
+             cluster._cell = icell;
+          }
+       }
+
+       for (auto& chit : chits)
+       {
+          int ic = _cidx[chit.index()];
+          if (ic >= 0 && _clusters[ic]._hasChanged) chit.distance(distance(_clusters[ic],chcol[chit.index()]));
+       }
+       for (auto& cluster : _clusters) cluster._hasChanged = false;
+
+       return nchanged;
+   }
+
+
+
+   //-------------------------------------------------------------------------------------------------------------------
+   int TNTGridClusterer::findClosest(const ComboHit& hit, float& mindist) const
+   {
+       int icell = cellIndex(hit.pos(),hit.time());
+       int ix    = icell % _ncell;
+       int iy    = (icell / _ncell) % _ncell;
+       int it    = icell / (_ncell*_ncell);
+
+       int minc(-1);
+       int nts = std::min(3,_ntslices);
+       for (int k=0; k<nts; ++k)
+       {
+          int jt = (it-1+k+_ntslices) % _ntslices;
+          for (int jx=std::max(0,ix-1); jx<=std::min(_ncell-1,ix+1); ++jx)
+          {
+             for (int jy=std::max(0,iy-1); jy<=std::min(_ncell-1,iy+1); ++jy)
+             {
+                for (int ic : _cells[jx + _ncell*(jy + _ncell*jt)])
+                {
+                   if (_clusters[ic]._nhits==0) continue;
+                   float dist = distance(_clusters[ic],hit);
+                   if (dist < mindist) {mindist = dist; minc = ic;}
+                   if (mindist < _dhit) return minc;
+                }
+             }
+          }
+       }
+       return minc;
+   }
+
+
+
+   //-------------------------------------------------------------------------------------------------------------------
+   int TNTGridClusterer::newCluster(const ComboHit& hit)
+   {
+       GridCluster cluster;
+       cluster._pos        = XYZVec(hit.pos().x(),hit.pos().y(),0.0);
+       cluster._time       = hit.time();
+       cluster._phi0       = hit.phi();
+       cluster._sw         = cluster._srho = cluster._sdphi = cluster._st = 0.0;
+       cluster._nhits      = 0;
+       cluster._cell       = cellIndex(cluster._pos,cluster._time);
+       cluster._hasChanged = true;
+
+       int iclu = _clusters.size();
+       _clusters.push_back(cluster);
+       addToCell(cluster._cell,iclu);
+       return iclu;
+   }
+
+   //-------------------------------------------------------------------------------------------------------------------
+   // weight according to the # of hits, phi is accumulated relative to the first hit of the cluster
+   void TNTGridClusterer::addHit(GridCluster& cluster, const ComboHit& hit)
+   {
+       if (cluster._nhits==0)
+       {
+          cluster._phi0 = hit.phi();
+          cluster._sw   = cluster._srho = cluster._sdphi = cluster._st = 0.0;
+       }
+       float  hphi = hit.phi();
+       double w    = hit.nStrawHits();
+       cluster._sw    += w;
+       cluster._srho  += w*sqrt(hit.pos().perp2());
+       cluster._sdphi += w*Angles::deltaPhi(hphi,cluster._phi0);
+       cluster._st    += w*hit.time();
+       ++cluster._nhits;
+       cluster._hasChanged = true;
+   }
+
+   void TNTGridClusterer::removeHit(GridCluster& cluster, const ComboHit& hit)
+   {
+       float  hphi = hit.phi();
+       double w    = hit.nStrawHits();
+       cluster._sw    -= w;
+       cluster._srho  -= w*sqrt(hit.pos().perp2());
+       cluster._sdphi -= w*Angles::deltaPhi(hphi,cluster._phi0);
+       cluster._st    -= w*hit.time();
+       --cluster._nhits;
+       cluster._hasChanged = true;
+   }
+
+   void TNTGridClusterer::updateCache(GridCluster& cluster)
+   {
+       if (cluster._nhits==0 || cluster._sw <= 0) return;
+       float crho    = cluster._srho/cluster._sw;
+       float cphi    = cluster._phi0 + cluster._sdphi/cluster._sw;
+       cluster._pos  = XYZVec(crho*cos(cphi),crho*sin(cphi),0.0);
+       cluster._time = cluster._st/cluster._sw;
+   }
+
+
+
+   //-------------------------------------------------------------------------------------------------------------------
+   // the (x,y) cells are clamped to the grid edges, time is folded into the slices
+   int TNTGridClusterer::cellIndex(const XYZVec& pos, float time) const
+   {
+       int ix = std::min(_ncell-1,std::max(0,int(std::floor((pos.x()+_gridHalfSize)/_maxdist))));
+       int iy = std::min(_ncell-1,std::max(0,int(std::floor((pos.y()+_gridHalfSize)/_maxdist))));
+       int it = int(std::floor(time/_maxdt)) % _ntslices;
+       if (it < 0) it += _ntslices;
+       return ix + _ncell*(iy + _ncell*it);
+   }
+
+   void TNTGridClusterer::addToCell(int icell, int iclu)
+   {
+       if (_cells[icell].empty()) _usedCells.push_back(icell);
+       _cells[icell].push_back(iclu);
+   }
+
+   void TNTGridClusterer::removeFromCell(int icell, int iclu)
+   {
+       auto& cell = _cells[icell];
+       auto it = std::find(cell.begin(),cell.end(),iclu);
+       if (it == cell.end()) return;
+       *it = cell.back();
+       cell.pop_back();
+   }
+
+
+
+   //---------------------------------------------------------------------------------------
+   // only count differences if they are above the natural hit size (drift time, straw size)
+   float TNTGridClusterer::distance(const GridCluster& cluster, const ComboHit& hit) const
+   {
+       float dt = std::abs(hit.time()-cluster._time);
+       if (dt > _maxdt) return _dseed+1.0;
+
+       XYZVec psep = PerpVector(hit.pos()-cluster._pos,Geom::ZDir());
+       float d2 = psep.mag2();
+       if (d2 > _md2) return _dseed+1.0;
+
+       float retval(0.0);
+       if (dt > _dt) {float tdist = dt -_dt;  retval = tdist*tdist*_trms2inv;}
+       if (d2 > _dd2)
+       {
+	   XYZVec that(-hit.wdir().y(),hit.wdir().x(),0.0);
+           float dw = std::max(0.0f,hit.wdir().Dot(psep)-_dd)/hit.posRes(ComboHit::wire);
+	   float dp = std::max(0.0f,that.Dot(psep)-_dd)*_maxwt;  //maxwt = 1/minerr
+	   retval += dw*dw + dp*dp;
+       }
+       return retval;
+   }
+
+}